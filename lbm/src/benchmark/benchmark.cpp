@@ -0,0 +1,111 @@
+#include"benchmark.h"
+
+#include<fstream>
+#include<sstream>
+#include<iomanip>
+#include<map>
+
+
+BenchmarkRunner::BenchmarkRunner(int const warmup_number, int const samples_number, double const min_sample_time) :
+	warmup_number_(warmup_number), samples_number_((samples_number > 0) ? samples_number : 1), min_sample_time_(min_sample_time)
+{
+
+}
+
+void BenchmarkRunner::Print(std::ostream & os) const
+{
+	os << std::left << std::setw(36) << "case" << std::setw(14) << "size" << std::right << std::setw(8) << "threads"
+		<< std::setw(14) << "time[us]" << std::setw(14) << "Melem/s" << "\n";
+
+	for (auto const & result : results_)
+	{
+		os << std::left << std::setw(36) << result.name_ << std::setw(14) << result.size_ << std::right << std::setw(8) << result.threads_
+			<< std::setw(14) << std::fixed << std::setprecision(2) << result.time_ * 1e6
+			<< std::setw(14) << result.Throughput() << "\n";
+	}
+
+	os.unsetf(std::ios::fixed);
+	os << std::setprecision(6);
+}
+
+bool BenchmarkRunner::SaveBaseline(std::string const & file_name) const
+{
+	std::ofstream file(file_name);
+
+	if (!file.is_open())
+	{
+		std::cout << "Error! Could not open file " << file_name << " to write benchmark baseline.\n";
+		return false;
+	}
+
+	file << "# key time[s]\n";
+	file << std::setprecision(9);
+	for (auto const & result : results_)
+		file << result.Key() << ' ' << result.time_ << '\n';
+
+	return file.good();
+}
+
+int BenchmarkRunner::CompareWithBaseline(std::string const & file_name, double const tolerance, std::ostream & os) const
+{
+	std::ifstream file(file_name);
+
+	if (!file.is_open())
+	{
+		std::cout << "Error! Could not open benchmark baseline " << file_name << ".\n";
+		return -1;
+	}
+
+	// Baseline time of each key
+	std::map<std::string, double> baseline;
+	std::string line;
+
+	while (std::getline(file, line))
+	{
+		if (line.empty() || line[0] == '#')
+			continue;
+
+		std::istringstream stream(line);
+		std::string key;
+		double time;
+
+		if (stream >> key >> time)
+			baseline[key] = time;
+	}
+
+	int regressions_number = 0;
+
+	os << std::left << std::setw(56) << "key" << std::right << std::setw(14) << "base[us]" << std::setw(14) << "time[us]"
+		<< std::setw(10) << "change" << "\n";
+
+	for (auto const & result : results_)
+	{
+		auto base = baseline.find(result.Key());
+
+		if (base == baseline.end() || base->second <= 0.0)
+		{
+			os << std::left << std::setw(56) << result.Key() << "  not in baseline\n";
+			continue;
+		}
+
+		// Positive change means slowdown
+		const double change = result.time_ / base->second - 1.0;
+		const bool is_regression = change > tolerance;
+
+		if (is_regression)
+			++regressions_number;
+
+		os << std::left << std::setw(56) << result.Key() << std::right << std::fixed << std::setprecision(2)
+			<< std::setw(14) << base->second * 1e6 << std::setw(14) << result.time_ * 1e6
+			<< std::setw(9) << std::showpos << change * 100.0 << std::noshowpos << "%"
+			<< (is_regression ? "  SLOWER" : "") << "\n";
+	}
+
+	os.unsetf(std::ios::fixed);
+	os << std::setprecision(6);
+
+	os << regressions_number << " of " << results_.size() << " results are slower than baseline by more than "
+		<< tolerance * 100.0 << "%\n";
+
+	return regressions_number;
+}
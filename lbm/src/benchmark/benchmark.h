@@ -0,0 +1,76 @@
+#pragma once
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include<string>
+#include<vector>
+#include<chrono>
+#include<iostream>
+
+// Microbenchmarks of matrices, distribution functions and solver kernels.
+//
+// Each case is performed several times after warm-up, the minimum time of one call is taken as result (it is the least
+// disturbed by other processes). Fast cases are repeated in a loop, until one sample lasts at least 'min_sample_time',
+// so the clock resolution does not affect results. Results are identified by key "name/size/tN" (N is number of threads),
+// they could be saved as baseline file and compared with baseline of the previous build to catch slowdowns.
+
+//! Result of one benchmark case
+struct BenchmarkResult
+{
+	//! Name of case, for example "matrix2d.get_sum"
+	std::string name_;
+	//! Size of problem, for example "512x512"
+	std::string size_;
+	//! Number of threads
+	int threads_;
+	//! Number of elements (or nodes), processed by one call
+	long long elements_;
+	//! Minimum time of one call (in seconds)
+	double time_;
+
+	//! Returns key of result in baseline file
+	std::string Key() const { return name_ + "/" + size_ + "/t" + std::to_string(threads_); }
+	//! Returns throughput in millions of elements per second
+	double Throughput() const { return (time_ > 0.0) ? elements_ / time_ * 1e-6 : 0.0; }
+};
+
+
+//! Performs benchmark cases and compares results with baseline
+class BenchmarkRunner
+{
+	typedef std::chrono::steady_clock Clock;
+
+public:
+	BenchmarkRunner(int const warmup_number = 2, int const samples_number = 5, double const min_sample_time = 1e-3);
+	~BenchmarkRunner() {}
+
+	//! Performs 'function', which processes 'elements' elements, with current number of threads and stores its result
+	template<typename Function>
+	BenchmarkResult const & Run(std::string const & name, std::string const & size, long long const elements, Function && function);
+
+	//! Returns all stored results
+	std::vector<BenchmarkResult> const & GetResults() const { return results_; }
+
+	//! Prints table of all results
+	void Print(std::ostream & os = std::cout) const;
+	//! Writes time of all results to baseline file 'file_name'. Returns false if file could not be written
+	bool SaveBaseline(std::string const & file_name) const;
+	//! Compares results with baseline file 'file_name' and prints relative change of time for each result.
+	//! Returns number of results, which are slower than baseline by more than 'tolerance' (0.1 is 10%), or -1 if file could not be read
+	int CompareWithBaseline(std::string const & file_name, double const tolerance, std::ostream & os = std::cout) const;
+
+private:
+	//! Number of calls before measurements
+	int warmup_number_;
+	//! Number of measured samples, the minimum one is taken
+	int samples_number_;
+	//! Minimum duration of one sample (in seconds)
+	double min_sample_time_;
+
+	std::vector<BenchmarkResult> results_;
+};
+
+#include"benchmark_impl.h"
+
+#endif // !BENCHMARK_H
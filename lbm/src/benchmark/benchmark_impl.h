@@ -0,0 +1,42 @@
+#pragma once
+
+#include"benchmark.h"
+#include"..\solver\parallel.h"
+
+#include<algorithm>
+
+template<typename Function>
+inline BenchmarkResult const & BenchmarkRunner::Run(std::string const & name, std::string const & size, long long const elements, Function && function)
+{
+	for (int i = 0; i < warmup_number_; ++i)
+		function();
+
+	// Number of calls in one sample is doubled until sample is long enough
+	int calls_number = 1;
+	double sample_time = 0.0;
+
+	while (true)
+	{
+		const Clock::time_point start = Clock::now();
+		for (int i = 0; i < calls_number; ++i)
+			function();
+		sample_time = std::chrono::duration<double>(Clock::now() - start).count();
+
+		if (sample_time >= min_sample_time_)
+			break;
+		calls_number *= 2;
+	}
+
+	double min_time = sample_time / calls_number;
+
+	for (int sample = 1; sample < samples_number_; ++sample)
+	{
+		const Clock::time_point start = Clock::now();
+		for (int i = 0; i < calls_number; ++i)
+			function();
+		min_time = std::min(min_time, std::chrono::duration<double>(Clock::now() - start).count() / calls_number);
+	}
+
+	results_.push_back(BenchmarkResult{ name, size, GetThreadsNumber(), elements, min_time });
+	return results_.back();
+}
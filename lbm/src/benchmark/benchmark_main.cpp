@@ -0,0 +1,284 @@
+#include<iostream>
+#include<string>
+#include<vector>
+#include<sstream>
+#include<algorithm>
+#include<cstdlib>
+
+#include"benchmark.h"
+
+#include"..\math\2d\my_matrix_2d.h"
+#include"..\math\3d\my_matrix_3d.h"
+#include"..\phys_values\2d\distribution_func_2d.h"
+#include"..\phys_values\2d\aligned_distribution_func_2d.h"
+#include"..\modeling_area\medium.h"
+#include"..\modeling_area\fluid.h"
+#include"..\solver\srt.h"
+#include"..\solver\mrt.h"
+#include"..\solver\ib_srt.h"
+#include"..\solver\parallel.h"
+
+
+//! Results of benchmarked functions are accumulated here, so compiler could not remove their calls
+volatile double benchmark_sink = 0.0;
+
+//! Returns size of 2D problem as "YxX"
+std::string SizeName(int const rows, int const colls)
+{
+	return std::to_string(rows) + "x" + std::to_string(colls);
+}
+
+//! Returns size of 3D problem as "ZxYxX"
+std::string SizeName(int const depth, int const rows, int const colls)
+{
+	return std::to_string(depth) + "x" + SizeName(rows, colls);
+}
+
+//! Parses comma separated list of positive integers "1,2,4"
+std::vector<int> ParseList(std::string const & list)
+{
+	std::vector<int> values;
+	std::istringstream stream(list);
+	std::string value;
+
+	while (std::getline(stream, value, ','))
+		if (std::atoi(value.c_str()) > 0)
+			values.push_back(std::atoi(value.c_str()));
+
+	return values;
+}
+
+
+//! Element-wise operations, sum and row/column extraction of 2D matrices
+void MatrixBenchmarks2D(BenchmarkRunner & runner, std::vector<int> const & threads, int const size)
+{
+	const std::string size_name = SizeName(size, size);
+	const long long elements = static_cast<long long>(size) * size;
+
+	Matrix2D<double> a(size, size), b(size, size), c(size, size);
+	a.FillWith(1.0);
+	b.FillWith(2.0);
+	c.FillWith(0.0);
+
+	for (int t : threads)
+	{
+		SetThreadsNumber(t);
+
+		runner.Run("matrix2d.assign_expr", size_name, elements, [&]() { c = a + b * 0.5; });
+		runner.Run("matrix2d.add_assign", size_name, elements, [&]() { c += a; });
+		runner.Run("matrix2d.scale", size_name, elements, [&]() { c *= 0.5; });
+		runner.Run("matrix2d.get_sum", size_name, elements, [&]() { benchmark_sink = benchmark_sink + static_cast<double>(a.GetSum()); });
+		runner.Run("matrix2d.get_row", size_name, size, [&]() { benchmark_sink = benchmark_sink + a.GetRow(size / 2).back(); });
+		runner.Run("matrix2d.get_column", size_name, size, [&]() { benchmark_sink = benchmark_sink + a.GetColumn(size / 2).back(); });
+	}
+}
+
+//! Element-wise operations, sum and layers extraction of 3D matrices
+void MatrixBenchmarks3D(BenchmarkRunner & runner, std::vector<int> const & threads, int const size)
+{
+	const std::string size_name = SizeName(size, size, size);
+	const long long elements = static_cast<long long>(size) * size * size;
+
+	Matrix3D<double> a(size, size, size), c(size, size, size);
+	a.FillWith(1.0);
+	c.FillWith(0.0);
+
+	for (int t : threads)
+	{
+		SetThreadsNumber(t);
+
+		runner.Run("matrix3d.add_assign", size_name, elements, [&]() { c += a; });
+		runner.Run("matrix3d.scale", size_name, elements, [&]() { c *= 0.5; });
+		runner.Run("matrix3d.get_sum", size_name, elements, [&]() { benchmark_sink = benchmark_sink + static_cast<double>(a.GetSum()); });
+		runner.Run("matrix3d.get_tb_layer", size_name, static_cast<long long>(size) * size,
+			[&]() { benchmark_sink = benchmark_sink + a.GetTBLayer(size - 2).back(); });
+		runner.Run("matrix3d.get_lr_layer", size_name, static_cast<long long>(size - 2) * size,
+			[&]() { benchmark_sink = benchmark_sink + a.GetLRLayer(size - 2).back(); });
+		runner.Run("matrix3d.get_nf_layer", size_name, static_cast<long long>(size - 2) * (size - 2),
+			[&]() { benchmark_sink = benchmark_sink + a.GetNFLayer(size - 2).back(); });
+	}
+}
+
+//! Macroscopic values calculation of distribution function and kernels of 2D solvers
+void SolverBenchmarks2D(BenchmarkRunner & runner, std::vector<int> const & threads, int const size, int const steps)
+{
+	const std::string size_name = SizeName(size, size);
+	const long long nodes = static_cast<long long>(size) * size;
+
+	Fluid fluid(size, size);
+	Medium medium(size, size);
+
+	// Distribution function is filled with equilibrium values, so all calculated values are finite
+	SRTsolver srt(1.0, medium, fluid);
+	srt.feqCalculate();
+	for (int q = 0; q < kQ; ++q)
+		fluid.f_[q] = fluid.feq_[q];
+
+	MRTSolver mrt(1.0, medium, fluid);
+	IBSolver ib(1.0, fluid, medium, std::vector<ImmersedBody*>());
+
+	// The same populations in single aligned block with padded rows, streaming is compared with SRTsolver::Streaming()
+	AlignedDistributionFunction<double> aligned_f(size, size), aligned_f_stream(size, size);
+	aligned_f.CopyFrom(fluid.f_);
+
+	for (int t : threads)
+	{
+		SetThreadsNumber(t);
+
+		runner.Run("dist_func.calculate_density", size_name, nodes, [&]() { fluid.rho_ = fluid.f_.calculateDensity(); });
+		runner.Run("dist_func.calculate_velocity", size_name, nodes, [&]() { fluid.vx_ = fluid.f_.calculateVelocity(kEx, fluid.rho_); });
+
+		runner.Run("srt.feq", size_name, nodes, [&]() { srt.feqCalculate(); });
+		runner.Run("srt.collision", size_name, nodes, [&]() { srt.Collision(); });
+		runner.Run("srt.streaming", size_name, nodes, [&]() { srt.Streaming(); });
+		runner.Run("aligned_dist_func.streaming", size_name, nodes, [&]()
+		{
+			aligned_f.StreamTo(aligned_f_stream, medium, kEx, kEy);
+			aligned_f.Swap(aligned_f_stream);
+		});
+		runner.Run("srt.recalculate", size_name, nodes, [&]() { srt.Recalculate(); });
+
+		runner.Run("mrt.collision", size_name, nodes, [&]() { mrt.Collision(); });
+
+		runner.Run("ib.collision", size_name, nodes, [&]() { ib.Collision(); });
+		runner.Run("ib.streaming", size_name, nodes, [&]() { ib.Streaming(); });
+	}
+
+	// Whole time steps of each kernel mode of SRT solver (with boundary conditions, without output)
+	const std::pair<KernelMode, std::string> modes[]{
+		{ KernelMode::SEPARATE_SWEEPS, "separate_sweeps" },
+		{ KernelMode::FUSED, "fused" },
+		{ KernelMode::IN_PLACE, "in_place" },
+		{ KernelMode::SPARSE, "sparse" } };
+
+	for (auto const & mode : modes)
+	{
+		Fluid mode_fluid(size, size);
+		SRTsolver solver(1.0, medium, mode_fluid);
+		solver.SetKernelMode(mode.first);
+		solver.SetOutput(false);
+
+		for (int t : threads)
+		{
+			SetThreadsNumber(t);
+
+			// Result is time of 'steps' time steps
+			runner.Run("srt.steps" + std::to_string(steps) + "." + mode.second, size_name, nodes * steps, [&]() { solver.Solve(steps); });
+		}
+	}
+}
+
+//! Kernels of 3D solver
+void SolverBenchmarks3D(BenchmarkRunner & runner, std::vector<int> const & threads, int const size)
+{
+	const std::string size_name = SizeName(size, size, size);
+	const long long nodes = static_cast<long long>(size) * size * size;
+	// Fused kernel updates only fluid nodes (outer layer is boundary)
+	const long long fluid_nodes = static_cast<long long>(size - 2) * (size - 2) * (size - 2);
+
+	Fluid3D fluid(size, size, size);
+	Medium3D medium(size, size, size);
+
+	// Distribution function is filled with equilibrium values, so all calculated values are finite
+	SRT3DSolver srt(1.0, medium, fluid);
+	srt.feqCalculate();
+	for (int q = 0; q < SRT3DSolver::Lattice::kQ; ++q)
+		(*fluid.f_)[q] = (*fluid.feq_)[q];
+
+	for (int t : threads)
+	{
+		SetThreadsNumber(t);
+
+		runner.Run("srt3d.feq", size_name, nodes, [&]() { srt.feqCalculate(); });
+		runner.Run("srt3d.collide_and_stream", size_name, fluid_nodes, [&]() { srt.CollideAndStream(0.01); });
+		runner.Run("srt3d.recalculate", size_name, nodes, [&]() { srt.Recalculate(); });
+	}
+}
+
+
+//! Command line: lbm_benchmark.exe [-threads 1,2,4] [-sizes 128,512] [-sizes3d 32,64] [-quick] [-baseline file] [-save file] [-tolerance 0.1]
+//!  -threads	list of numbers of threads (1 and all available processors by default)
+//!  -sizes		list of sizes of square 2D domains
+//!  -sizes3d	list of sizes of cubic 3D domains (not less than 20)
+//!  -quick		small sizes and less samples, to check that nothing is broken
+//!  -baseline	compare results with baseline file, exit code is number of slower results
+//!  -save		write results to baseline file
+//!  -tolerance	allowed relative slowdown in comparison with baseline (0.1 by default)
+int main(int argc, char * argv[])
+{
+	using std::cout;
+	using std::endl;
+
+	std::vector<int> threads{ 1, omp_get_num_procs() };
+	std::vector<int> sizes{ 128, 512, 1024 };
+	std::vector<int> sizes_3d{ 32, 64 };
+	std::string baseline_file;
+	std::string save_file;
+	double tolerance{ 0.1 };
+	int samples_number{ 5 };
+	int steps{ 10 };
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg(argv[i]);
+
+		if (arg == "-threads" && i + 1 < argc)
+			threads = ParseList(argv[++i]);
+		else if (arg == "-sizes" && i + 1 < argc)
+			sizes = ParseList(argv[++i]);
+		else if (arg == "-sizes3d" && i + 1 < argc)
+			sizes_3d = ParseList(argv[++i]);
+		else if (arg == "-quick")
+		{
+			sizes = { 64, 256 };
+			sizes_3d = { 24 };
+			samples_number = 2;
+			steps = 2;
+		}
+		else if (arg == "-baseline" && i + 1 < argc)
+			baseline_file = argv[++i];
+		else if (arg == "-save" && i + 1 < argc)
+			save_file = argv[++i];
+		else if (arg == "-tolerance" && i + 1 < argc)
+			tolerance = atof(argv[++i]);
+		else
+			cout << "Unknown command line argument: " << arg << endl;
+	}
+
+	// The same number of threads is not measured twice on single processor machine
+	std::sort(threads.begin(), threads.end());
+	threads.erase(std::unique(threads.begin(), threads.end()), threads.end());
+
+	BenchmarkRunner runner(2, samples_number);
+
+	for (int size : sizes)
+	{
+		MatrixBenchmarks2D(runner, threads, size);
+		SolverBenchmarks2D(runner, threads, size, steps);
+
+		// Cached blocks of this size are not reused by cases of other sizes
+		MemoryPool::Instance().Release();
+	}
+
+	for (int size : sizes_3d)
+	{
+		MatrixBenchmarks3D(runner, threads, size);
+		SolverBenchmarks3D(runner, threads, size);
+
+		MemoryPool::Instance().Release();
+	}
+
+	cout << "\n";
+	runner.Print();
+
+	if (!save_file.empty())
+		runner.SaveBaseline(save_file);
+
+	if (!baseline_file.empty())
+	{
+		cout << "\n";
+		return runner.CompareWithBaseline(baseline_file, tolerance);
+	}
+
+	return 0;
+}
@@ -13,6 +13,7 @@
 #include"solver\srt.h"
 #include"solver\mrt.h"
 #include"solver\bc\bc.h"
+#include"solver\parallel.h"
 
 
 #include"math\3d\my_matrix_3d.h"
@@ -67,12 +68,111 @@ void MatrixTest()
 
 }
 
-int main()
+//! Measures SRT solution time on the same domain with 1, 2, 4 ... 'max_threads' threads (strong scaling)
+//! and writes time, speedup and parallel efficiency to console and scaling_report.txt file
+void StrongScalingReport(int const max_threads, KernelMode const mode)
+{
+	const int X{ 1000 };
+	const int Y{ 500 };
+	const int iter_numb{ 100 };
+
+	std::vector<int> threads;
+	for (int t = 1; t < max_threads; t *= 2)
+		threads.push_back(t);
+	threads.push_back(max_threads);
+
+	std::ofstream report("scaling_report.txt");
+	std::ostringstream table;
+	table << "# Strong scaling: SRT " << Y << "x" << X << ", " << iter_numb << " iterations\n";
+	table << "threads\ttime[s]\tspeedup\tefficiency\tMLUPS\n";
+
+	double serial_time{ 0.0 };
+
+	for (int t : threads)
+	{
+		SetThreadsNumber(t);
+
+		Fluid f(Y, X);
+		Medium m(Y, X);
+		SRTsolver solver(1.0, m, f);
+		solver.SetKernelMode(mode);
+		solver.SetOutput(false);
+
+		double start = omp_get_wtime();
+		solver.Solve(iter_numb);
+		double time = omp_get_wtime() - start;
+
+		if (t == 1)
+			serial_time = time;
+
+		double speedup = serial_time / time;
+		table << t << "\t" << time << "\t" << speedup << "\t" << speedup / t << "\t"
+			<< static_cast<double>(X) * Y * iter_numb / time / 1.0e6 << "\n";
+	}
+
+	// Runs reuse blocks of each other, they are returned to the system only when all of them are finished
+	MemoryPool::Instance().Release();
+
+	std::cout << table.str();
+	report << table.str();
+}
+
+//! Command line: lbm.exe [-threads N] [-schedule static|dynamic] [-chunk N] [-simd scalar|avx2|avx512] [-scaling]
+//!  -threads	number of threads for node loops (all available processors by default)
+//!  -schedule	distribution of node loop iterations between threads
+//!  -chunk		chunk size for schedule
+//!  -simd		instruction set for collision kernels (the best supported one by default)
+//!  -scaling	perform strong scaling report from 1 to N threads instead of solution
+int main(int argc, char * argv[])
 {
 
 	using std::cout;
 	using std::endl;
-	omp_set_num_threads(1);
+
+	int threads_numb{ 0 };
+	int chunk_size{ 0 };
+	ScheduleType schedule{ ScheduleType::STATIC };
+	bool is_schedule_set{ false };
+	bool is_scaling{ false };
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg(argv[i]);
+
+		if (arg == "-threads" && i + 1 < argc)
+			threads_numb = atoi(argv[++i]);
+		else if (arg == "-schedule" && i + 1 < argc)
+		{
+			schedule = (std::string(argv[++i]) == "dynamic") ? ScheduleType::DYNAMIC : ScheduleType::STATIC;
+			is_schedule_set = true;
+		}
+		else if (arg == "-chunk" && i + 1 < argc)
+		{
+			chunk_size = atoi(argv[++i]);
+			is_schedule_set = true;
+		}
+		else if (arg == "-simd" && i + 1 < argc)
+		{
+			std::string simd(argv[++i]);
+			SetSimdLevel((simd == "avx512") ? SimdLevel::AVX512 : (simd == "avx2") ? SimdLevel::AVX2 : SimdLevel::SCALAR);
+		}
+		else if (arg == "-scaling")
+			is_scaling = true;
+		else
+			cout << "Unknown command line argument: " << arg << endl;
+	}
+
+	SetThreadsNumber(threads_numb);
+	if (is_schedule_set)
+		SetSchedule(schedule, chunk_size);
+
+	cout << "Threads: " << GetThreadsNumber() << ", collision kernels: " << ToString(GetSimdLevel()) << endl;
+
+	if (is_scaling)
+	{
+		StrongScalingReport(GetThreadsNumber(), KernelMode::FUSED);
+		return 0;
+	}
 
 #pragma region 2D
 
@@ -140,6 +240,9 @@ int main()
 	IBSolver s(1.0, f, m, bodies); //std::move(body));
 	s.Solve(3001);
 
+	// Blocks of matrices, cached during solution, are returned to the system
+	MemoryPool::Instance().Release();
+
 #pragma endregion
 
 #pragma endregion
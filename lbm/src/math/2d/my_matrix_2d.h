@@ -1,6 +1,10 @@
 #pragma once
 
 #include"../my_matrix_interface.h"
+#include"../memory_pool.h"
+#include"../reduction.h"
+#include"../strided_view.h"
+#include"my_matrix_2d_expr.h"
 
 #include<iostream>
 #include<ostream>
@@ -30,7 +34,7 @@
 /// Overloading implemetation only for operations witch we need in LBM implementation.
 /// </remarks>
 template<typename T>
-class Matrix2D : public iMatrix<T>
+class Matrix2D : public iMatrix<T>, public MatrixExpr2D<Matrix2D<T>>
 {
 public:
 
@@ -64,6 +68,13 @@ public:
 
 #pragma endregion
 
+	/// <summary>
+	/// Allocates an matrix with size of the "expr" expression and fills it with the expression values (in a single loop).
+	/// </summary>
+	/// <param name="expr"> Lazy element-wise expression over matrices. </param>
+	template<typename E>
+	Matrix2D(MatrixExpr2D<E> const & expr);
+
 	/// <summary>
 	/// The assignment operator.
 	/// </summary>
@@ -74,103 +85,76 @@ public:
 		// Check that rows or colls number of right and left matrix are equal
 		assert(rows_ == other.rows_ && colls_ == other.colls_);
 
+		// std::vector reuses already allocated memory, so no reallocation for equal sizes
 		if (this != & other) 
 		{
-			Matrix2D<T> temp(other);
-			temp.Swap(*this);
+			rows_ = other.rows_;
+			colls_ = other.colls_;
+			body_ = other.body_;
 		}
 
 		return *this;
 	}
 
-#pragma region Operator +, += and its overloading
-
 	/// <summary>
-	/// A computed assignment operator. Adds the matrix "other" expression to the matrix.
+	/// The assignment operator. Evaluates the whole "expr" expression directly into the matrix body.
 	/// </summary>
-	/// <param name="other"> Matrix that we add to the current matrix. </param>
-	/// <returns>  The result of adding two matrices. </returns>
-	Matrix2D<T> & operator+=(Matrix2D<T> const & other) 
+	/// <param name="expr"> Expression from the rigth side of the assigment operator. </param>
+	/// <returns> New assigment matrix. </returns>
+	template<typename E>
+	Matrix2D<T> & operator=(MatrixExpr2D<E> const & expr)
 	{
-		assert(rows_ == other.rows_ && colls_ == other.colls_);
-	
-		#pragma omp parallel for
-			for (int i = 0; i < body_.size(); ++i)
-				body_.at(i) += other.body_.at(i);
-
-		return *this;
+		return Assign(expr.Self(), [](T & value, T const other) { value = other; });
 	}
 
+	// Type of matrix elements, used by expressions
+	typedef T value_type;
+
 	/// <summary>
-	/// A computed assignment operator. Adds the to each matrix element "other" value.
+	/// Returns value of "i"-th element of the matrix (elements are stored row by row). Used by lazy expressions.
 	/// </summary>
-	/// <param name="other"> Value, we add to the each element of the current matrix. </param>
-	/// <returns>  The result of adding the matrix and the value.  </returns>
-	Matrix2D<T> & operator+=(T const other) 
+	T Eval(int i) const
 	{
-		std::for_each(body_.begin(), body_.end(), [&](T & value) {value += other; });
-		return *this;
+		return body_[i];
 	}
 
+#pragma region Operator +, += and its overloading
+
 	/// <summary>
-	/// A computed assignment operator. Adds the current matrix with the "other" matrix.
+	/// A computed assignment operator. Adds the "expr" expression (matrix or lazy expression) to the matrix.
 	/// </summary>
-	/// <param name="other"> Matrix that we add to the current matrix. </param>
+	/// <param name="expr"> Expression that we add to the current matrix. </param>
 	/// <returns>  The result of adding two matrices. </returns>
-	Matrix2D<T> operator+(Matrix2D<T> const & other) const 
+	template<typename E>
+	Matrix2D<T> & operator+=(MatrixExpr2D<E> const & expr) 
 	{
-		// Check that rows or columns number of right and left matrix are equal
-		assert(rows_ == other.rows_ && colls_ == other.colls_);
-
-		Matrix2D<T> result(*this);
-	#pragma omp parallel for
-		for (int i = 0; i < result.body_.size(); ++i)
-			result.body_.at(i) += other.body_.at(i);
-
-		return result;
+		return Assign(expr.Self(), [](T & value, T const other) { value += other; });
 	}
 
 	/// <summary>
-	/// A computed assignment operator. Adds the to each element of the current matrix element "other" value.
+	/// A computed assignment operator. Adds the to each matrix element "other" value.
 	/// </summary>
 	/// <param name="other"> Value, we add to the each element of the current matrix. </param>
-	/// <returns> The result of adding the matrix and the value. </returns>
-	Matrix2D<T> operator+(T const other) const 
+	/// <returns>  The result of adding the matrix and the value.  </returns>
+	Matrix2D<T> & operator+=(T const other) 
 	{
-		Matrix2D<T> result(*this);
-
-		std::for_each(result.body_.begin(), result.body_.end(), [&](T & value) {value += other; });
-
-		return result;
+		std::for_each(body_.begin(), body_.end(), [&](T & value) {value += other; });
+		return *this;
 	}
 
-	
-	template<typename T1>
-	/// <summary>
-	/// A computed assignment operator. Adds the to each element of the current matrix element "other" value.
-	/// </summary>
-	/// <param name="left"> Value, we add to the each element of the current matrix. </param>
-	/// <param name="right"> the current matrix.</param>
-	/// <returns> The result of adding the value and the matrix. </returns>
-	friend Matrix2D<T1> operator+(T1 const left, Matrix2D<T1> const & right);
-
 #pragma endregion
 
 #pragma region Operator -, -= and its overloading
 
 	/// <summary>
-	/// A computed assignment operator. Substract the matrix "other" expression to the matrix.
+	/// A computed assignment operator. Substract the "expr" expression (matrix or lazy expression) from the matrix.
 	/// </summary>
-	/// <param name="other"> Matrix that we substract from the current matrix. </param>
+	/// <param name="expr"> Expression that we substract from the current matrix. </param>
 	/// <returns>  The result of subctract two matrices. </returns>
-	Matrix2D<T> & operator-=(Matrix2D<T> const & other) {
-		// Check that rows or columns number of right and left matrix are equal
-		assert(rows_ == other.rows_ && colls_ == other.colls_);
-	#pragma omp parallel for
-			for (int i = 0; i < body_.size(); ++i)
-				body_.at(i) -= other.body_.at(i);
-
-		return *this;
+	template<typename E>
+	Matrix2D<T> & operator-=(MatrixExpr2D<E> const & expr) 
+	{
+		return Assign(expr.Self(), [](T & value, T const other) { value -= other; });
 	}
 
 	/// <summary>
@@ -185,37 +169,6 @@ public:
 		return *this;
 	}
 
-	/// <summary>
-	/// A computed assignment operator. Substract the "other" matrix from the current matrix.
-	/// </summary>
-	/// <param name="other"> Matrix that we substract from the current matrix. </param>
-	/// <returns>  The result of substracting two matrices. </returns>
-	Matrix2D<T> operator-(Matrix2D<T> const & other) const {
-		// Check that rows or colls number of right and left matrix are equal
-		assert(rows_ == other.rows_ && colls_ == other.colls_);
-
-		Matrix2D<T> result(*this);
-	#pragma omp parallel for
-		for (int i = 0; i < result.body_.size(); ++i)
-			result.body_.at(i) -= other.body_.at(i);
-
-		return result;
-	}
-
-	/// <summary>
-	/// A computed assignment operator. Substract from the each element of the current matrix element "other" value.
-	/// </summary>
-	/// <param name="other"> Value, we substract from the each element of the current matrix. </param>
-	/// <returns> The result of adding the matrix and the value. </returns>
-	Matrix2D<T> operator-(T const other) const {
-		Matrix2D<T> result(*this);
-
-		std::for_each(result.body_.begin(), result.body_.end(),
-			[&](T & value) {value -= other; });
-
-		return result;
-	}
-
 #pragma endregion
 
 #pragma region Operator *, *= and its overloading
@@ -226,43 +179,13 @@ public:
 	/// <param name="other"> Value that we multiply on the current matrix. </param>
 	/// <returns>  The result of multiplying matrix with value. </returns>
 	Matrix2D<T> & operator*=(T other) {
-	#pragma omp parallel for
+	#pragma omp parallel for schedule(runtime)
 		for (int i = 0; i < body_.size(); ++i)
 			body_.at(i) *= other;
 
 		return *this;
 	}
 
-	/// <summary>
-	///  A computed assignment operator. Multiplies each element of the matrix with "other" value.
-	/// </summary>
-	/// <param name="other"> Value that we multiply to the current matrix. </param>
-	/// <returns>  The result of multiplying the matrix with value. </returns>
-	Matrix2D<T> operator*(T other) const {
-		Matrix2D<T> result(*this);
-
-		std::for_each(result.body_.begin(), result.body_.end(),
-			[&](T & value) {value *= other; });
-
-		return result;
-	}
-
-	template<typename T1>
-	/// <summary>
-	/// A computed assignment operator. Multiplies each element of the matrix "other" expression with "other" value.
-	/// </summary>
-	/// <param name="left"> Value that we multiply to the current matrix. </param>
-	/// <param name="right"> The current matrix. </param>
-	/// <returns> The result of multiplying the matrix with value. </returns>
-	friend Matrix2D<T1> operator*(T1 const left, Matrix2D<T1> const & right);
-
-	/// <summary>
-	/// The scalar product of current matrix and "other" matrix.
-	/// </summary>
-	/// <param name="other"> Right part of scalar product matrix. </param>
-	/// <returns> The scalar product of two matrix. </returns>
-	Matrix2D<T> ScalarMultiplication(Matrix2D<T> const & other);
-
 #pragma endregion
 
 #pragma region Operator /, /= and its overloading
@@ -276,37 +199,13 @@ public:
 		// Check that other value is not equal by zero
 		assert(other != 0);
 
-	#pragma omp parallel for
+	#pragma omp parallel for schedule(runtime)
 		for (int i = 0; i < body_.size(); ++i)
 			body_.at(i) /= other;
 
 		return *this;
 	}
 
-	/// <summary>
-	/// A computed assignment operator. Divide each element of the matrix on "other" value.
-	/// </summary>
-	/// <param name="other"> Value by which we divide each element of the matrix. </param>
-	/// <returns>  The result of divideing two matrices. </returns>
-	Matrix2D<T> operator/(T other) const {
-		// Check that other value is not equal by zero
-		assert(other != 0);
-
-		Matrix2D<T> result(*this);
-
-		std::for_each(result.body_.begin(), result.body_.end(),
-			[&](T & value) {value /= other; });
-
-		return result;
-	}
-
-	/// <summary>
-	/// Termwise division of the matrix on "other" argument.
-	/// </summary>
-	/// <param name="other"> Matrix by which we divide aproppriate element of the current matrix. </param>
-	/// <returns> Termwise division of the two matrix. </returns>
-	Matrix2D<T> TimesDivide(Matrix2D<T> const & other);
-
 #pragma endregion
 
 #pragma region Properties (Get/Set methods)
@@ -333,6 +232,24 @@ public:
 		return body_.at(y * colls_ + x);
 	}
 
+	/// <summary>
+	/// Get pointer to the first element of the matrix body. Elements are stored row by row: [y][x] is at y * colls + x.
+	/// </summary>
+	/// <returns> Pointer to the matrix body. </returns>
+	T * Data()
+	{
+		return body_.data();
+	}
+
+	/// <summary>
+	/// Get pointer to the first element of the matrix body as a constant.
+	/// </summary>
+	/// <returns> Constant pointer to the matrix body. </returns>
+	T const * Data() const
+	{
+		return body_.data();
+	}
+
 	
 
 	/// <summary>
@@ -342,7 +259,7 @@ public:
 	std::pair<unsigned int, unsigned int> Size() const;
 
 	/// <summary>
-	/// Returns the sum of all elements of the matrix
+	/// Returns the sum of all elements of the matrix, result does not depend on number of threads (see ParallelSum())
 	/// </summary>
 	/// <returns></returns>
 	long double GetSum() const;
@@ -375,6 +292,22 @@ public:
 	/// <param name="coll">  Vector for for insertion operation. </param>
 	void SetColumn(unsigned const x, std::vector<T> const & coll);
 
+	/// <summary>
+	/// Returns view of "y" row in place (the same elements as GetRow(), without copy).
+	/// </summary>
+	/// <param name="y"> Index of row </param>
+	/// <returns> View of row elements. </returns>
+	StridedView<T> GetRowView(unsigned const y) { return StridedView<T>(Data() + y * colls_, colls_, 1); }
+	StridedView<T const> GetRowView(unsigned const y) const { return StridedView<T const>(Data() + y * colls_, colls_, 1); }
+
+	/// <summary>
+	/// Returns view of elements in range [1 : rows_ - 2] of "x" column in place (the same elements as GetColumn(), without copy).
+	/// </summary>
+	/// <param name="x"> Index of column </param>
+	/// <returns> View of column elements. </returns>
+	StridedView<T> GetColumnView(unsigned const x) { return StridedView<T>(Data() + colls_ + x, rows_ - 2, colls_); }
+	StridedView<T const> GetColumnView(unsigned const x) const { return StridedView<T const>(Data() + colls_ + x, rows_ - 2, colls_); }
+
 #pragma endregion
 
 #pragma region Methods
@@ -438,8 +371,9 @@ public:
 					if (x != colls_ - 1)
 						output_file << ' ';
 				}
+				// '\n' instead of std::endl: stream is not flushed after each row
 				if (y != rows_ - 1)
-					output_file << std::endl;
+					output_file << '\n';
 
 			}
 		}
@@ -482,8 +416,30 @@ protected:
 	int rows_;
 	// Number of columns in matrix
 	int colls_;
-	// Main body of matrix, wich contain all matrix elements
-	std::vector<T> body_;
+	// Main body of matrix, wich contain all matrix elements (memory is taken from MemoryPool)
+	MatrixBody<T> body_;
+
+private:
+
+	/// <summary>
+	/// Evaluates "expr" expression element by element and combines it with the matrix body using "op" operation.
+	/// </summary>
+	/// <param name="expr"> Expression with the same size as the matrix. </param>
+	/// <param name="op"> Operation applied as op(body[i], expr[i]). </param>
+	/// <returns> The current matrix. </returns>
+	template<typename E, typename Op>
+	Matrix2D<T> & Assign(E const & expr, Op op)
+	{
+		// Check that rows or columns number of expression and matrix are equal
+		assert(Size() == expr.Size());
+
+		T * body = body_.data();
+	#pragma omp parallel for schedule(runtime)
+		for (int i = 0; i < static_cast<int>(body_.size()); ++i)
+			op(body[i], expr.Eval(i));
+
+		return *this;
+	}
 
 };
 
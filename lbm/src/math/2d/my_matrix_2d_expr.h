@@ -0,0 +1,229 @@
+#pragma once
+
+#ifndef MY_MATRIX_2D_EXPR_H
+#define MY_MATRIX_2D_EXPR_H
+
+#include<cassert>
+#include<utility>
+
+template<typename T>
+class Matrix2D;
+
+/// <summary>
+/// Base class of all lazy element-wise expressions over Matrix2D.
+/// </summary>
+/// <remarks>
+/// Arithmetic operators do not allocate result matrix. They return light-weight expression object,
+/// which stores operands and computes the value of element only when it is requested.
+/// The whole expression is evaluated in a single loop when it is assigned to (or used to construct) Matrix2D.
+///
+/// Each derived expression "E" must provide:
+///  - value_type - type of elements
+///  - value_type Eval(int i) const - value of i-th element (elements are stored row by row)
+///  - std::pair<unsigned int, unsigned int> Size() const - rows and columns number
+/// </remarks>
+template<typename E>
+class MatrixExpr2D
+{
+public:
+
+	E const & Self() const
+	{
+		return static_cast<E const &>(*this);
+	}
+
+	/// <summary>
+	/// The scalar product of current expression and "other" expression.
+	/// </summary>
+	/// <param name="other"> Right part of scalar product. </param>
+	/// <returns> Lazy element-wise product of two expressions. </returns>
+	template<typename R>
+	auto ScalarMultiplication(MatrixExpr2D<R> const & other) const;
+
+	/// <summary>
+	/// Termwise division of the current expression on "other" argument. If both elements are equal to zero result is zero.
+	/// </summary>
+	/// <param name="other"> Expression by which we divide aproppriate element of the current expression. </param>
+	/// <returns> Lazy termwise division of the two expressions. </returns>
+	template<typename R>
+	auto TimesDivide(MatrixExpr2D<R> const & other) const;
+};
+
+/// <summary>
+/// Defines how an operand is stored inside expression: matrices by reference, nested expressions by value.
+/// </summary>
+template<typename E>
+struct MatrixExprOperand2D
+{
+	typedef E const type;
+};
+
+template<typename T>
+struct MatrixExprOperand2D<Matrix2D<T>>
+{
+	typedef Matrix2D<T> const & type;
+};
+
+#pragma region Element-wise operations
+
+struct MatrixAddOp
+{
+	template<typename T>
+	static T Apply(T const left, T const right) { return left + right; }
+};
+
+struct MatrixSubOp
+{
+	template<typename T>
+	static T Apply(T const left, T const right) { return left - right; }
+};
+
+struct MatrixMulOp
+{
+	template<typename T>
+	static T Apply(T const left, T const right) { return left * right; }
+};
+
+struct MatrixDivOp
+{
+	template<typename T>
+	static T Apply(T const left, T const right) { return left / right; }
+};
+
+struct MatrixTimesDivideOp
+{
+	// Boundaries consist from 0, so 0 / 0 is equal to 0
+	template<typename T>
+	static T Apply(T const left, T const right) { return (right == T() && left == T()) ? T() : left / right; }
+};
+
+#pragma endregion
+
+#pragma region Expression nodes
+
+/// <summary>
+/// Element-wise operation "Op" between two expressions: result[i] = Op(left[i], right[i]).
+/// </summary>
+template<typename L, typename R, typename Op>
+class MatrixBinaryExpr2D : public MatrixExpr2D<MatrixBinaryExpr2D<L, R, Op>>
+{
+public:
+	typedef typename L::value_type value_type;
+
+	MatrixBinaryExpr2D(L const & left, R const & right) : left_(left), right_(right)
+	{
+		assert(left_.Size() == right_.Size());
+	}
+
+	value_type Eval(int i) const
+	{
+		return Op::Apply(left_.Eval(i), right_.Eval(i));
+	}
+
+	std::pair<unsigned int, unsigned int> Size() const
+	{
+		return left_.Size();
+	}
+
+private:
+	typename MatrixExprOperand2D<L>::type left_;
+	typename MatrixExprOperand2D<R>::type right_;
+};
+
+/// <summary>
+/// Element-wise operation "Op" between expression and value: result[i] = Op(left[i], right).
+/// </summary>
+template<typename L, typename Op>
+class MatrixScalarExpr2D : public MatrixExpr2D<MatrixScalarExpr2D<L, Op>>
+{
+public:
+	typedef typename L::value_type value_type;
+
+	MatrixScalarExpr2D(L const & left, value_type const right) : left_(left), right_(right) {}
+
+	value_type Eval(int i) const
+	{
+		return Op::Apply(left_.Eval(i), right_);
+	}
+
+	std::pair<unsigned int, unsigned int> Size() const
+	{
+		return left_.Size();
+	}
+
+private:
+	typename MatrixExprOperand2D<L>::type left_;
+	value_type const right_;
+};
+
+#pragma endregion
+
+template<typename E>
+template<typename R>
+inline auto MatrixExpr2D<E>::ScalarMultiplication(MatrixExpr2D<R> const & other) const
+{
+	return MatrixBinaryExpr2D<E, R, MatrixMulOp>(Self(), other.Self());
+}
+
+template<typename E>
+template<typename R>
+inline auto MatrixExpr2D<E>::TimesDivide(MatrixExpr2D<R> const & other) const
+{
+	return MatrixBinaryExpr2D<E, R, MatrixTimesDivideOp>(Self(), other.Self());
+}
+
+#pragma region Operators
+
+template<typename L, typename R>
+inline MatrixBinaryExpr2D<L, R, MatrixAddOp> operator+(MatrixExpr2D<L> const & left, MatrixExpr2D<R> const & right)
+{
+	return MatrixBinaryExpr2D<L, R, MatrixAddOp>(left.Self(), right.Self());
+}
+
+template<typename L, typename R>
+inline MatrixBinaryExpr2D<L, R, MatrixSubOp> operator-(MatrixExpr2D<L> const & left, MatrixExpr2D<R> const & right)
+{
+	return MatrixBinaryExpr2D<L, R, MatrixSubOp>(left.Self(), right.Self());
+}
+
+template<typename L>
+inline MatrixScalarExpr2D<L, MatrixAddOp> operator+(MatrixExpr2D<L> const & left, typename L::value_type const right)
+{
+	return MatrixScalarExpr2D<L, MatrixAddOp>(left.Self(), right);
+}
+
+template<typename R>
+inline MatrixScalarExpr2D<R, MatrixAddOp> operator+(typename R::value_type const left, MatrixExpr2D<R> const & right)
+{
+	return MatrixScalarExpr2D<R, MatrixAddOp>(right.Self(), left);
+}
+
+template<typename L>
+inline MatrixScalarExpr2D<L, MatrixSubOp> operator-(MatrixExpr2D<L> const & left, typename L::value_type const right)
+{
+	return MatrixScalarExpr2D<L, MatrixSubOp>(left.Self(), right);
+}
+
+template<typename L>
+inline MatrixScalarExpr2D<L, MatrixMulOp> operator*(MatrixExpr2D<L> const & left, typename L::value_type const right)
+{
+	return MatrixScalarExpr2D<L, MatrixMulOp>(left.Self(), right);
+}
+
+template<typename R>
+inline MatrixScalarExpr2D<R, MatrixMulOp> operator*(typename R::value_type const left, MatrixExpr2D<R> const & right)
+{
+	return MatrixScalarExpr2D<R, MatrixMulOp>(right.Self(), left);
+}
+
+template<typename L>
+inline MatrixScalarExpr2D<L, MatrixDivOp> operator/(MatrixExpr2D<L> const & left, typename L::value_type const right)
+{
+	// Check that other value is not equal by zero
+	assert(right != 0);
+	return MatrixScalarExpr2D<L, MatrixDivOp>(left.Self(), right);
+}
+
+#pragma endregion
+
+#endif // !MY_MATRIX_2D_EXPR_H
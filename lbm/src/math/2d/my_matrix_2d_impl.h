@@ -10,7 +10,7 @@
 template<typename T>
 inline Matrix2D<T>::Matrix2D(): rows_(0), colls_(0) 
 {
-	std::vector<T>().swap(body_);
+	MatrixBody<T>().swap(body_);
 }
 
 template<class T>
@@ -47,45 +47,12 @@ inline void Matrix2D<T>::Swap(Matrix2D<T> & other)
 }
 
 
-template<typename T1>
-inline Matrix2D<T1> operator+(T1 const left, Matrix2D<T1> const & right)
-{
-	return Matrix2D<T1>(right + left);
-}
-
-template<typename T1>
-inline Matrix2D<T1> operator*(T1 const left, Matrix2D<T1> const & right)
-{
-	return Matrix2D<T1>(right * left);
-}
-
 template<typename T>
-inline Matrix2D<T> Matrix2D<T>::ScalarMultiplication(Matrix2D<T> const & other)
+template<typename E>
+inline Matrix2D<T>::Matrix2D(MatrixExpr2D<E> const & expr) : rows_(expr.Self().Size().first), colls_(expr.Self().Size().second)
 {
-	Matrix2D<T> result(*this);
-#pragma omp parallel for
-	for (int i = 0; i < rows_ * colls_; ++i)
-		result.body_.at(i) *= other.body_.at(i);
-
-	return result;
-}
-
-template<typename T>
-inline Matrix2D<T> Matrix2D<T>::TimesDivide(Matrix2D<T> const & other)
-{
-	// Check that rows or columns number of right and left matrix are equal
-	assert(rows_ == other.rows_, colls_ == other.colls_);
-	Matrix2D<T> result(*this);
-
-#pragma omp parallel for
-	for (int i = 0; i < result.body_.size(); ++i)
-	{
-		// Boundaries consistd form 0 !!!
-		result.body_.at(i) = (other.body_.at(i) == T() && result.body_.at(i) == T()) ? T() : result.body_.at(i) / other.body_.at(i);
-	}
-		
-
-	return result;
+	body_.resize(rows_ * colls_);
+	Assign(expr.Self(), [](T & value, T const other) { value = other; });
 }
 
 template<typename T>
@@ -97,16 +64,7 @@ inline std::pair<unsigned int, unsigned int> Matrix2D<T>::Size() const
 template<typename T>
 inline long double Matrix2D<T>::GetSum() const
 {
-	long double sum{ 0.0 };
-
-#pragma omp parallel for
-	for (int i = 0; i < body_.size(); ++i)
-	{
-		#pragma omp atomic
-		sum += static_cast<long double>(body_.at(i));
-	}
-
-	return sum;
+	return ParallelSum(body_.data(), static_cast<int>(body_.size()));
 }
 
 template<typename T>
@@ -114,12 +72,8 @@ inline std::vector<T> Matrix2D<T>::GetRow(unsigned const y) const
 {
 	// Check that row ID less than number of rows
 	assert(y < rows_);
-	std::vector<T> result(colls_, T());
 
-#pragma omp parallel for
-	for (int x = 0; x < colls_; ++x)
-		result.at(x) = body_.at(colls_ * y + x);
-	return result;
+	return GetRowView(y).ToVector();
 }
 
 template<typename T>
@@ -128,9 +82,7 @@ inline void Matrix2D<T>::SetRow(unsigned const y, std::vector<T> const & row)
 	// Check that std::vector<T> row size is equal to columns number of matrix
 	assert(colls_ == row.size());
 
-#pragma omp parallel
-	for (int x = 0; x < colls_; ++x)
-		body_.at(colls_ * y + x) = row.at(x);
+	GetRowView(y).Assign(row);
 }
 
 template<typename T>
@@ -138,13 +90,8 @@ inline std::vector<T> Matrix2D<T>::GetColumn(unsigned const x) const
 {
 	// Check that coll ID less than number of column
 	assert(x < colls_);
-	std::vector<T> result(rows_ - 2, T());
-	
-#pragma omp parallel for
-	for (int y = 1; y < rows_ - 1; ++y)
-		result.at(y - 1) = body_.at(x + y * colls_);
 
-	return result;
+	return GetColumnView(x).ToVector();
 }
 
 template<typename T>
@@ -153,9 +100,7 @@ inline void Matrix2D<T>::SetColumn(unsigned const x, std::vector<T> const & coll
 	// Check that std::vector<T> coll size is equal to rows number of matrix, bsides 2 (left and right boundary index)
 	assert(rows_ == coll.size() + 2);
 
-#pragma omp parallel for
-	for (int y = 1; y < rows_ - 1; ++y)
-		body_.at(x + y * colls_) = coll.at(y - 1);
+	GetColumnView(x).Assign(coll);
 }
 
 template<typename T>
@@ -206,7 +151,7 @@ inline void Matrix2D<T>::Resize(int new_rows_numb, int new_colls_numb, int new_d
 	colls_ = new_colls_numb;
 
 	//       | body_.clear()   -   body.capasity()
-	std::vector<T>().swap(body_);
+	MatrixBody<T>().swap(body_);
 
 	// If we swap on matrix size (y,0) or (0, x) we need onlly to allocate memory
 	if(rows_ != 0 && colls_ != 0)
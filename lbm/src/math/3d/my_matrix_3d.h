@@ -4,6 +4,9 @@
 #define MY_MATRIX_3D_H
 
 #include"../my_matrix_interface.h"
+#include"../memory_pool.h"
+#include"../reduction.h"
+#include"../strided_view.h"
 #include"../2d/my_matrix_2d.h"
 
 template<typename T>
@@ -87,6 +90,11 @@ public:
 		return body_.at(z * rows_ * colls_ + y * colls_ + x);
 	}
 
+	// Returns pointer to the matrix body (element (z, y, x) is placed at z * rows * colls + y * colls + x)
+	T * Data() { return body_.data(); }
+	// Returns constant pointer to the matrix body
+	T const * Data() const { return body_.data(); }
+
 	// Returns Z-dimension size of the current 3d-matrix
 	int const GetDepthNumber() const { return depth_; }
 	// Returns Y-dimension size of the current 3d-matrix
@@ -109,6 +117,16 @@ public:
 	// Set Left or Right layer for 'y' is equal to 0 or rows-1 to 'layer' (without upper and down elements)
 	void SetNFLayer(unsigned const y, std::vector<T> const & layer);
 
+	//! Returns view of 'z' layer in place (the same elements as GetTBLayer(), element (y, x))
+	SliceView<T> GetTBLayerView(int const z) { return SliceView<T>(Data() + z * rows_ * colls_, rows_, colls_, colls_, 1); }
+	SliceView<T const> GetTBLayerView(int const z) const { return SliceView<T const>(Data() + z * rows_ * colls_, rows_, colls_, colls_, 1); }
+	//! Returns view of 'x' layer in place (the same elements as GetLRLayer(), element (z - 1, y))
+	SliceView<T> GetLRLayerView(int const x) { return SliceView<T>(Data() + rows_ * colls_ + x, depth_ - 2, rows_, rows_ * colls_, colls_); }
+	SliceView<T const> GetLRLayerView(int const x) const { return SliceView<T const>(Data() + rows_ * colls_ + x, depth_ - 2, rows_, rows_ * colls_, colls_); }
+	//! Returns view of 'y' layer in place (the same elements as GetNFLayer(), element (z - 1, x - 1))
+	SliceView<T> GetNFLayerView(int const y) { return SliceView<T>(Data() + rows_ * colls_ + y * colls_ + 1, depth_ - 2, colls_ - 2, rows_ * colls_, 1); }
+	SliceView<T const> GetNFLayerView(int const y) const { return SliceView<T const>(Data() + rows_ * colls_ + y * colls_ + 1, depth_ - 2, colls_ - 2, rows_ * colls_, 1); }
+
 	// Override of iMatrix method
 	long double GetSum() const override;
 
@@ -153,8 +171,8 @@ private:
 	//! Number of matrix columns (X-axis size  value)
 	int colls_;
 
-	//! Body of matrix, stores all matrix elements
-	std::vector<T> body_;
+	//! Body of matrix, stores all matrix elements (memory is taken from MemoryPool)
+	MatrixBody<T> body_;
 
 };
 
@@ -69,7 +69,7 @@ inline void Matrix3D<T>::Resize(int new_rows_numb, int new_colls_numb, int new_d
 	depth_ = new_depth_numb;
 
 	//       | body_.clear()   -   body.capasity()
-	std::vector<T>().swap(body_);
+	MatrixBody<T>().swap(body_);
 
 	// If we swap on matrix size (y,0) or (0, x) we need onlly to allocate memory
 	if (depth_ != 0 && rows_ != 0 && colls_ != 0)
@@ -133,16 +133,7 @@ inline void Matrix3D<T>::FillWith(const T value)
 template<typename T>
 inline long double Matrix3D<T>::GetSum() const
 {
-	long double sum{ 0.0 };
-
-#pragma omp parallel for
-	for (int i = 0; i < GetTotalSize(); ++i)
-	{
-		#pragma omp atomic
-		sum += static_cast<long double>(body_.at(i));
-	}
-
-	return sum;
+	return ParallelSum(body_.data(), GetTotalSize());
 }
 
 template<typename T>
@@ -152,15 +143,7 @@ inline std::vector<T> Matrix3D<T>::GetTBLayer(const int z) const
 	assert(z > 0 && z < depth_ - 1);
 	// This layer is FULL : 
 	// all Oxy plane including all elements
-	std::vector<T> res(rows_ * colls_, T());
-
-	for (int y = 0; y < rows_; ++y)
-	{
-		for (int x = 0; x < colls_; ++x)
-			res.at(y * colls_ + x) = this->operator()(z, y, x);
-	}
-
-	return res;
+	return GetTBLayerView(z).ToVector();
 }
 
 template<typename T>
@@ -170,15 +153,7 @@ inline std::vector<T> Matrix3D<T>::GetLRLayer(const int x) const
 	assert(x > 0 && x < colls_ - 1);
 	// This layer is NOT FULL : upper and bottom elements is belongs to TOP and BOTTOM BS respectively
 	// all elements of Oyz expect upper and lower elements
-	std::vector<T> res(rows_ * (depth_ - 2), T());
-
-	for (int z = 1; z < depth_ - 1; ++z)
-	{
-		for(int y = 0; y < rows_; ++y)
-			res.at((z - 1) * (rows_) + y) = this->operator()(z, y, x); // (z-1) to fit in vector range
-	}
-
-	return res;
+	return GetLRLayerView(x).ToVector();
 }
 
 template<typename T>
@@ -188,15 +163,7 @@ inline std::vector<T> Matrix3D<T>::GetNFLayer(const int y) const
 	assert(y > 0 && y < rows_ - 1);
 	// This layer is NOT FULL : upper, bottom, left and right elements is belongs to T B R L boundaries respectively
 	// all elements of Ozx expect upper, lower, left and right elements
-	std::vector<T> res((colls_ - 2) * (depth_ - 2), T());
-
-	for (int z = 1; z < depth_ - 1; ++z)
-	{
-		for (int x = 1; x < colls_ - 1; ++x)
-			res.at((z - 1) * (colls_ - 2) + (x - 1)) = this->operator()(z, y, x); // (z-1),(x-1),(colls-2) to fit in vector range
-	}
-
-	return res;
+	return GetNFLayerView(y).ToVector();
 }
 
 template<typename T>
@@ -204,24 +171,15 @@ inline void Matrix3D<T>::SetTBLayer(unsigned const z, std::vector<T> const & lay
 {
 	assert(layer.size() == rows_ * colls_);
 
-	for (int y = 0; y < rows_; ++y)
-	{
-		for (int x = 0; x < colls_; ++x)
-			this->operator()(z, y, x) = layer.at(y * colls_ + x);
-	}
-	
+	GetTBLayerView(z).Assign(layer);
 }
 
 template<typename T>
 inline void Matrix3D<T>::SetLRLayer(unsigned const x, std::vector<T> const & layer)
 {
 	assert(layer.size() == rows_ * (depth_ - 2));
-	
-	for (int z = 1; z < depth_ - 1; ++z)
-	{
-		for (int y = 0; y < rows_; ++y)
-			this->operator()(z, y, x) = layer.at((z - 1) * (rows_) + y);
-	}
+
+	GetLRLayerView(x).Assign(layer);
 }
 
 template<typename T>
@@ -229,11 +187,7 @@ inline void Matrix3D<T>::SetNFLayer(unsigned const y, std::vector<T> const & lay
 {
 	assert(layer.size() == (colls_ - 2) * (depth_ - 2));
 
-	for (int z = 1; z < depth_ - 1; ++z)
-	{
-		for (int x = 1; x < colls_ - 1; ++x)
-			this->operator()(z, y, x) = layer.at((z - 1) * (colls_ - 2) + (x - 1));
-	}
+	GetNFLayerView(y).Assign(layer);
 }
 
 
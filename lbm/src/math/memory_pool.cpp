@@ -0,0 +1,105 @@
+#include"memory_pool.h"
+
+#include<malloc.h> // _aligned_malloc, _aligned_free
+#include<new>
+
+
+MemoryPool & MemoryPool::Instance()
+{
+	// Pool is never destroyed, so matrices with static storage could release their memory at program exit
+	static MemoryPool * pool = new MemoryPool();
+	return *pool;
+}
+
+void * MemoryPool::Allocate(std::size_t const bytes)
+{
+	const std::size_t size = BlockSize(bytes);
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		++stats_.allocations_;
+		stats_.live_bytes_ += size;
+		if (stats_.live_bytes_ > stats_.peak_bytes_)
+			stats_.peak_bytes_ = stats_.live_bytes_;
+
+		std::vector<void*> & blocks = free_blocks_[size];
+		if (!blocks.empty())
+		{
+			void * ptr = blocks.back();
+			blocks.pop_back();
+
+			++stats_.pool_hits_;
+			stats_.cached_bytes_ -= size;
+
+			return ptr;
+		}
+	}
+
+	// System allocation is performed without lock
+	void * ptr = _aligned_malloc(size, BlockAlignment(size));
+	if (ptr == nullptr)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stats_.live_bytes_ -= size;
+
+		throw std::bad_alloc();
+	}
+
+	return ptr;
+}
+
+void MemoryPool::Deallocate(void * ptr, std::size_t const bytes)
+{
+	if (ptr == nullptr)
+		return;
+
+	const std::size_t size = BlockSize(bytes);
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		stats_.live_bytes_ -= size;
+		if (stats_.cached_bytes_ + size <= kPoolCacheLimit)
+		{
+			stats_.cached_bytes_ += size;
+			free_blocks_[size].push_back(ptr);
+
+			return;
+		}
+	}
+
+	// System deallocation is performed without lock
+	_aligned_free(ptr);
+}
+
+void MemoryPool::Release()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	for (auto & blocks : free_blocks_)
+		for (void * ptr : blocks.second)
+			_aligned_free(ptr);
+
+	free_blocks_.clear();
+	stats_.cached_bytes_ = 0;
+}
+
+MemoryPoolStats MemoryPool::GetStats() const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return stats_;
+}
+
+std::size_t MemoryPool::BlockSize(std::size_t const bytes)
+{
+	const std::size_t alignment = BlockAlignment(bytes);
+
+	// Empty request gets the smallest block, so each block has its own address
+	return (bytes == 0) ? kPoolLineSize : (bytes + alignment - 1) / alignment * alignment;
+}
+
+std::size_t MemoryPool::BlockAlignment(std::size_t const size)
+{
+	return (size < kPoolPageSize) ? kPoolLineSize : kPoolPageSize;
+}
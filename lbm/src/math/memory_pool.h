@@ -0,0 +1,115 @@
+#pragma once
+
+#ifndef MEMORY_POOL_H
+#define MEMORY_POOL_H
+
+#include<cstddef>
+#include<mutex>
+#include<unordered_map>
+#include<vector>
+
+// Pool of aligned memory blocks for bodies of matrices.
+//
+// Solvers create and destroy many matrices of the same size every time step (temporaries of expressions, results of
+// macroscopic values calculation), so released blocks are kept in the pool and given to the next request of the same
+// size instead of returning them to the system. Sizes are rounded up to cache line (small blocks) or page (large
+// blocks), blocks are aligned on the same boundary. Pool counts live bytes and requests served from it, so memory
+// footprint of solution could be observed (see PerformanceMonitor). Define LBM_NO_MEMORY_POOL to use default allocator.
+//
+// Pool lives as long as the process, so released blocks are reused by all solvers. Released blocks over kPoolCacheLimit
+// are returned to the system at once, the whole cache is returned by owner of solution (main, benchmark) with Release().
+
+//! Alignment (in bytes) of small blocks: cache line size
+const std::size_t kPoolLineSize = 64;
+//! Alignment (in bytes) of blocks, which are not smaller than it: page size
+const std::size_t kPoolPageSize = 4096;
+//! Maximum number of bytes of released blocks, which are kept in the pool
+const std::size_t kPoolCacheLimit = std::size_t(256) << 20;
+
+//! Counters of memory pool
+struct MemoryPoolStats
+{
+	MemoryPoolStats() : live_bytes_(0), peak_bytes_(0), cached_bytes_(0), allocations_(0), pool_hits_(0) {}
+
+	//! Bytes of blocks, which are used now
+	std::size_t live_bytes_;
+	//! Maximum of live bytes
+	std::size_t peak_bytes_;
+	//! Bytes of released blocks, which are kept in the pool
+	std::size_t cached_bytes_;
+	//! Number of requests of blocks
+	long long allocations_;
+	//! Number of requests, which were served by released blocks (without system allocation)
+	long long pool_hits_;
+};
+
+//! Pool of aligned memory blocks, the only one for the whole program
+class MemoryPool
+{
+public:
+	//! Returns the pool
+	static MemoryPool & Instance();
+
+	//! Returns block of at least 'bytes' bytes (aligned on cache line or page)
+	void * Allocate(std::size_t const bytes);
+	//! Returns block 'ptr', given by Allocate('bytes'), to the pool (or to the system, if the pool is full)
+	void Deallocate(void * ptr, std::size_t const bytes);
+
+	//! Returns all released blocks to the system (when solution is finished, blocks of its sizes are not needed anymore)
+	void Release();
+
+	//! Returns counters of the pool
+	MemoryPoolStats GetStats() const;
+
+private:
+	MemoryPool() {}
+	~MemoryPool() {}
+
+	MemoryPool(MemoryPool const &) = delete;
+	MemoryPool & operator=(MemoryPool const &) = delete;
+
+	//! Returns size of block, which is given for request of 'bytes' bytes
+	static std::size_t BlockSize(std::size_t const bytes);
+	//! Returns alignment of block of 'size' bytes
+	static std::size_t BlockAlignment(std::size_t const size);
+
+private:
+	//! Released blocks of each size
+	std::unordered_map<std::size_t, std::vector<void*>> free_blocks_;
+	MemoryPoolStats stats_;
+	//! Matrices could be created by several threads (solver and output writer)
+	mutable std::mutex mutex_;
+};
+
+//! Allocator of standard containers, which takes memory from MemoryPool
+template<typename T>
+class PooledAllocator
+{
+public:
+	typedef T value_type;
+
+	PooledAllocator() {}
+	template<typename U>
+	PooledAllocator(PooledAllocator<U> const &) {}
+
+	T * allocate(std::size_t const n);
+	void deallocate(T * ptr, std::size_t const n);
+};
+
+template<typename T, typename U>
+bool operator==(PooledAllocator<T> const &, PooledAllocator<U> const &) { return true; }
+template<typename T, typename U>
+bool operator!=(PooledAllocator<T> const &, PooledAllocator<U> const &) { return false; }
+
+//! Storage of matrix body
+#ifdef LBM_NO_MEMORY_POOL
+template<typename T>
+using MatrixBody = std::vector<T>;
+#else
+template<typename T>
+using MatrixBody = std::vector<T, PooledAllocator<T>>;
+#endif
+
+#include"memory_pool_impl.h"
+
+#endif // !MEMORY_POOL_H
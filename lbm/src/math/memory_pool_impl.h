@@ -0,0 +1,20 @@
+#pragma once
+
+#ifndef MEMORY_POOL_IMPL_H
+#define MEMORY_POOL_IMPL_H
+
+#include"memory_pool.h"
+
+template<typename T>
+inline T * PooledAllocator<T>::allocate(std::size_t const n)
+{
+	return static_cast<T*>(MemoryPool::Instance().Allocate(n * sizeof(T)));
+}
+
+template<typename T>
+inline void PooledAllocator<T>::deallocate(T * ptr, std::size_t const n)
+{
+	MemoryPool::Instance().Deallocate(ptr, n * sizeof(T));
+}
+
+#endif // !MEMORY_POOL_IMPL_H
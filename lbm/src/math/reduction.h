@@ -0,0 +1,48 @@
+#pragma once
+
+#ifndef REDUCTION_H
+#define REDUCTION_H
+
+#include<array>
+#include<vector>
+#include<omp.h>
+
+// Parallel sums, which results do not depend on number of threads and schedule.
+//
+// Elements are split into blocks of fixed size, each block is summed by one thread with compensated (Kahan) summation,
+// then partial sums of blocks are added in block order. Partition into blocks depends only on number of elements,
+// so the same values are added in the same order for any number of threads.
+
+//! Compensated (Kahan) sum, error of the sum does not grow with number of added values
+class KahanSum
+{
+public:
+	KahanSum() : sum_(0.0), compensation_(0.0) {}
+
+	//! Adds 'value' to the sum
+	void Add(double const value);
+	//! Returns the sum
+	double Get() const { return sum_ - compensation_; }
+
+private:
+	//! Current sum
+	double sum_;
+	//! Low-order bits of added values, which are lost in 'sum_' (with opposite sign)
+	double compensation_;
+};
+
+//! Number of elements in one block of ParallelSum()
+const int kReductionBlockSize = 4096;
+
+//! Calculates 'N' sums over 'size' elements in one pass: 'terms(i, values)' writes 'N' terms of 'i' element to 'values'.
+//! Result does not depend on number of threads
+template<int N, typename Terms>
+std::array<double, N> ParallelSum(int const size, Terms terms);
+
+//! Returns sum of 'size' elements of 'data', result does not depend on number of threads
+template<typename T>
+double ParallelSum(T const * data, int const size);
+
+#include"reduction_impl.h"
+
+#endif // !REDUCTION_H
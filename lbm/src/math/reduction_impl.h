@@ -0,0 +1,63 @@
+#pragma once
+
+#ifndef REDUCTION_IMPL_H
+#define REDUCTION_IMPL_H
+
+#include"reduction.h"
+
+inline void KahanSum::Add(double const value)
+{
+	const double y = value - compensation_;
+	const double t = sum_ + y;
+
+	compensation_ = (t - sum_) - y;
+	sum_ = t;
+}
+
+template<int N, typename Terms>
+inline std::array<double, N> ParallelSum(int const size, Terms terms)
+{
+	const int blocks_number = (size + kReductionBlockSize - 1) / kReductionBlockSize;
+	std::vector<std::array<double, N>> partial(blocks_number);
+
+#pragma omp parallel for schedule(static)
+	for (int b = 0; b < blocks_number; ++b)
+	{
+		const int begin = b * kReductionBlockSize;
+		const int end = (begin + kReductionBlockSize < size) ? begin + kReductionBlockSize : size;
+
+		KahanSum sum[N];
+		double values[N];
+
+		for (int i = begin; i < end; ++i)
+		{
+			terms(i, values);
+
+			for (int k = 0; k < N; ++k)
+				sum[k].Add(values[k]);
+		}
+
+		for (int k = 0; k < N; ++k)
+			partial[b][k] = sum[k].Get();
+	}
+
+	// Partial sums are added in block order, so the result is the same for any number of threads
+	KahanSum total[N];
+	for (int b = 0; b < blocks_number; ++b)
+		for (int k = 0; k < N; ++k)
+			total[k].Add(partial[b][k]);
+
+	std::array<double, N> result;
+	for (int k = 0; k < N; ++k)
+		result[k] = total[k].Get();
+
+	return result;
+}
+
+template<typename T>
+inline double ParallelSum(T const * data, int const size)
+{
+	return ParallelSum<1>(size, [data](int const i, double values[1]) { values[0] = static_cast<double>(data[i]); })[0];
+}
+
+#endif // !REDUCTION_IMPL_H
@@ -0,0 +1,99 @@
+#pragma once
+
+#ifndef STRIDED_VIEW_H
+#define STRIDED_VIEW_H
+
+#include<cassert>
+#include<vector>
+#include<type_traits>
+
+// Non-owning views of matrix elements, which are placed in memory with constant step (rows, columns and layers).
+//
+// Views read and write elements of matrix in place, so boundary values could be processed without copies.
+// View is valid while memory of matrix is not reallocated (resize, swap with other matrix).
+
+//! View of 'size' elements, 'i' element is data[i * stride]
+template<typename T>
+class StridedView
+{
+public:
+	//! Type of elements without const qualifier
+	typedef typename std::remove_const<T>::type ValueType;
+
+	StridedView() : data_(nullptr), size_(0), stride_(0) {}
+	StridedView(T * data, int const size, int const stride) : data_(data), size_(size), stride_(stride) {}
+
+	//! Returns number of elements
+	int Size() const { return size_; }
+	//! Returns distance between neighbour elements in memory (in elements)
+	int Stride() const { return stride_; }
+
+	T & operator[](int const i) const
+	{
+		assert(i >= 0 && i < size_);
+		return data_[i * stride_];
+	}
+
+	//! Returns copy of elements
+	std::vector<ValueType> ToVector() const;
+	//! Sets all elements equal to 'value'
+	void Fill(ValueType const value) const;
+	//! Copies elements of 'values' (vector or view of the same size)
+	template<typename Values>
+	void Assign(Values const & values) const;
+
+private:
+	T * data_;
+	int size_;
+	int stride_;
+};
+
+//! View of 2D slice of 3D matrix with 'rows' x 'colls' elements, element ('i', 'j') is data[i * row_stride + j * coll_stride]
+template<typename T>
+class SliceView
+{
+public:
+	typedef typename std::remove_const<T>::type ValueType;
+
+	SliceView() : data_(nullptr), rows_(0), colls_(0), row_stride_(0), coll_stride_(0) {}
+	SliceView(T * data, int const rows, int const colls, int const row_stride, int const coll_stride) :
+		data_(data), rows_(rows), colls_(colls), row_stride_(row_stride), coll_stride_(coll_stride) {}
+
+	//! Returns number of rows of slice
+	int GetRowsNumber() const { return rows_; }
+	//! Returns number of columns of slice
+	int GetCollsNumber() const { return colls_; }
+	//! Returns number of elements of slice
+	int Size() const { return rows_ * colls_; }
+
+	T & operator()(int const i, int const j) const
+	{
+		assert(i >= 0 && i < rows_ && j >= 0 && j < colls_);
+		return data_[i * row_stride_ + j * coll_stride_];
+	}
+
+	//! Returns view of 'i' row of slice
+	StridedView<T> GetRow(int const i) const
+	{
+		assert(i >= 0 && i < rows_);
+		return StridedView<T>(data_ + i * row_stride_, colls_, coll_stride_);
+	}
+
+	//! Returns copy of elements row by row
+	std::vector<ValueType> ToVector() const;
+	//! Sets all elements equal to 'value'
+	void Fill(ValueType const value) const;
+	//! Copies elements of 'values' (row by row, as returned by ToVector())
+	void Assign(std::vector<ValueType> const & values) const;
+
+private:
+	T * data_;
+	int rows_;
+	int colls_;
+	int row_stride_;
+	int coll_stride_;
+};
+
+#include"strided_view_impl.h"
+
+#endif // !STRIDED_VIEW_H
@@ -0,0 +1,74 @@
+#pragma once
+
+#ifndef STRIDED_VIEW_IMPL_H
+#define STRIDED_VIEW_IMPL_H
+
+#include"strided_view.h"
+
+#pragma region StridedView
+
+template<typename T>
+inline std::vector<typename StridedView<T>::ValueType> StridedView<T>::ToVector() const
+{
+	std::vector<ValueType> result(size_);
+
+	for (int i = 0; i < size_; ++i)
+		result[i] = data_[i * stride_];
+
+	return result;
+}
+
+template<typename T>
+inline void StridedView<T>::Fill(ValueType const value) const
+{
+	for (int i = 0; i < size_; ++i)
+		data_[i * stride_] = value;
+}
+
+template<typename T>
+template<typename Values>
+inline void StridedView<T>::Assign(Values const & values) const
+{
+	assert(static_cast<int>(values.size()) == size_);
+
+	for (int i = 0; i < size_; ++i)
+		data_[i * stride_] = values[i];
+}
+
+#pragma endregion
+
+#pragma region SliceView
+
+template<typename T>
+inline std::vector<typename SliceView<T>::ValueType> SliceView<T>::ToVector() const
+{
+	std::vector<ValueType> result(Size());
+
+	for (int i = 0; i < rows_; ++i)
+		for (int j = 0; j < colls_; ++j)
+			result[i * colls_ + j] = data_[i * row_stride_ + j * coll_stride_];
+
+	return result;
+}
+
+template<typename T>
+inline void SliceView<T>::Fill(ValueType const value) const
+{
+	for (int i = 0; i < rows_; ++i)
+		for (int j = 0; j < colls_; ++j)
+			data_[i * row_stride_ + j * coll_stride_] = value;
+}
+
+template<typename T>
+inline void SliceView<T>::Assign(std::vector<ValueType> const & values) const
+{
+	assert(static_cast<int>(values.size()) == Size());
+
+	for (int i = 0; i < rows_; ++i)
+		for (int j = 0; j < colls_; ++j)
+			data_[i * row_stride_ + j * coll_stride_] = values[i * colls_ + j];
+}
+
+#pragma endregion
+
+#endif // !STRIDED_VIEW_IMPL_H
@@ -26,6 +26,88 @@ std::pair<unsigned, unsigned> Fluid::size() const
 	return std::make_pair(rows_, colls_);
 }
 
+FluidDiagnostics Fluid::GetDiagnostics() const
+{
+	const double * rho = rho_.Data();
+	const double * vx = vx_.Data();
+	const double * vy = vy_.Data();
+
+	// Mass, momentum and kinetic energy are summed in one pass over nodes
+	const std::array<double, 4> sum = ParallelSum<4>(static_cast<int>(rows_ * colls_), [=](int const i, double values[4])
+	{
+		values[0] = rho[i];
+		values[1] = rho[i] * vx[i];
+		values[2] = rho[i] * vy[i];
+		values[3] = 0.5 * rho[i] * (vx[i] * vx[i] + vy[i] * vy[i]);
+	});
+
+	FluidDiagnostics result;
+	result.mass_ = sum[0];
+	result.momentum_x_ = sum[1];
+	result.momentum_y_ = sum[2];
+	result.energy_ = sum[3];
+
+	return result;
+}
+
+std::string Fluid::write_fluid_vtk(std::string path, int time, VtkFormat const format, VtkPrecision const precision) const
+{
+	return WriteFluidFieldsVtk(path, time, rho_, vx_, vy_, format, precision);
+}
+
+std::string WriteFluidFieldsVtk(std::string path, int time, Matrix2D<double> const & rho, Matrix2D<double> const & vx, Matrix2D<double> const & vy,
+	VtkFormat const format, VtkPrecision const precision)
+{
+	const int rows = rho.Size().first;
+	const int colls = rho.Size().second;
+
+	// Top and bottom boundaries are not written, so data start from the first row.
+	// Node (y, x) has (x + 0.5, y - 0.5) coordinates
+	const int offset = colls;
+
+	VtkImageWriter writer(colls, rows - 2, 1, format, precision);
+	writer.SetOrigin(0.5, 0.5, 0.0);
+
+	writer.AddScalar("density", rho.Data() + offset);
+	writer.AddScalar("vx", vx.Data() + offset);
+	writer.AddScalar("vy", vy.Data() + offset);
+	writer.AddVector("velocity", vx.Data() + offset, vy.Data() + offset);
+
+	return writer.Write(path + "/fluid_t" + std::to_string(time));
+}
+
+void Fluid::SaveState(CheckpointWriter & writer) const
+{
+	const unsigned size[2]{ rows_, colls_ };
+	const std::size_t count = rows_ * colls_;
+
+	writer.Write("fluid.size", size, 2);
+	writer.Write("fluid.rho", rho_.Data(), count);
+	writer.Write("fluid.vx", vx_.Data(), count);
+	writer.Write("fluid.vy", vy_.Data(), count);
+
+	for (int q = 0; q < kQ; ++q)
+		writer.Write("fluid.f" + std::to_string(q), f_[q].Data(), count);
+}
+
+bool Fluid::LoadState(CheckpointReader const & reader)
+{
+	unsigned size[2]{ 0, 0 };
+	const std::size_t count = rows_ * colls_;
+
+	if (!reader.Read("fluid.size", size, 2) || size[0] != rows_ || size[1] != colls_)
+	{
+		std::cout << "Error! Checkpoint fluid has " << size[0] << "x" << size[1] << " size instead of " << rows_ << "x" << colls_ << ".\n";
+		return false;
+	}
+
+	bool is_ok = reader.Read("fluid.rho", rho_.Data(), count) && reader.Read("fluid.vx", vx_.Data(), count) && reader.Read("fluid.vy", vy_.Data(), count);
+
+	for (int q = 0; q < kQ && is_ok; ++q)
+		is_ok = reader.Read("fluid.f" + std::to_string(q), f_[q].Data(), count);
+
+	return is_ok;
+}
 
 #pragma endregion
 
@@ -41,8 +123,8 @@ Fluid3D::Fluid3D(int depth, int rows, int colls) : depth_(depth), rows_(rows), c
 	vy_ = std::make_unique<MacroscopicParam3D<double>>(depth_, rows_, colls_);
 	vz_ = std::make_unique<MacroscopicParam3D<double>>(depth_, rows_, colls_);
 
+	// Equilibrium field is not used by time step of solver, it is allocated on demand (see SRT3DSolver::feqCalculate())
 	f_ = std::make_unique<DistributionFunction3D<double>>(depth_, rows_, colls_);
-	feq_ = std::make_unique<DistributionFunction3D<double>>(depth_, rows_, colls_);
 }
 
 int Fluid3D::GetDepthNumber() const
@@ -67,6 +149,55 @@ void Fluid3D::PoiseuilleIC(double const dvx)
 			vy_->operator()(z, y, 1) += dvx;
 }
 
+std::string Fluid3D::WriteFluidVtk(std::string path, int time, VtkFormat const format, VtkPrecision const precision) const
+{
+	VtkImageWriter writer(colls_, rows_, depth_, format, precision);
+
+	writer.AddScalar("density", rho_->Data());
+	writer.AddScalar("vx", vx_->Data());
+	writer.AddScalar("vy", vy_->Data());
+	writer.AddScalar("vz", vz_->Data());
+	writer.AddVector("velocity", vx_->Data(), vy_->Data(), vz_->Data());
+
+	return writer.Write(path + "/fluid_t" + std::to_string(time));
+}
+
+void Fluid3D::SaveState(CheckpointWriter & writer) const
+{
+	const int size[3]{ depth_, rows_, colls_ };
+	const std::size_t count = depth_ * rows_ * colls_;
+
+	writer.Write("fluid3d.size", size, 3);
+	writer.Write("fluid3d.rho", rho_->Data(), count);
+	writer.Write("fluid3d.vx", vx_->Data(), count);
+	writer.Write("fluid3d.vy", vy_->Data(), count);
+	writer.Write("fluid3d.vz", vz_->Data(), count);
+
+	for (int q = 0; q < kQ3d; ++q)
+		writer.Write("fluid3d.f" + std::to_string(q), (*f_)[q].Data(), count);
+}
+
+bool Fluid3D::LoadState(CheckpointReader const & reader)
+{
+	int size[3]{ 0, 0, 0 };
+	const std::size_t count = depth_ * rows_ * colls_;
+
+	if (!reader.Read("fluid3d.size", size, 3) || size[0] != depth_ || size[1] != rows_ || size[2] != colls_)
+	{
+		std::cout << "Error! Checkpoint fluid has " << size[0] << "x" << size[1] << "x" << size[2] << " size instead of "
+			<< depth_ << "x" << rows_ << "x" << colls_ << ".\n";
+		return false;
+	}
+
+	bool is_ok = reader.Read("fluid3d.rho", rho_->Data(), count) && reader.Read("fluid3d.vx", vx_->Data(), count) &&
+		reader.Read("fluid3d.vy", vy_->Data(), count) && reader.Read("fluid3d.vz", vz_->Data(), count);
+
+	for (int q = 0; q < kQ3d && is_ok; ++q)
+		is_ok = reader.Read("fluid3d.f" + std::to_string(q), (*f_)[q].Data(), count);
+
+	return is_ok;
+}
+
 void Fluid3D::SetDistributionFuncValue(const int q, double const value)
 {
 	assert(q < kQ3d);
@@ -102,9 +233,9 @@ void Fluid3D::RecalculateRho()
 
 void Fluid3D::RecalculateV()
 {
-	RecalculateVelocityComponent(vx_, ex);
-	RecalculateVelocityComponent(vy_, ey);
-	RecalculateVelocityComponent(vz_, ez);
+	RecalculateVelocityComponent(vx_, D3Q19::kEx);
+	RecalculateVelocityComponent(vy_, D3Q19::kEy);
+	RecalculateVelocityComponent(vz_, D3Q19::kEz);
 }
 
 long double Fluid3D::TotalRho()
@@ -112,15 +243,48 @@ long double Fluid3D::TotalRho()
 	return rho_->GetSum();
 }
 
-void Fluid3D::RecalculateVelocityComponent(const MacroscopicParamPtr & v_ptr, const int e[])
+FluidDiagnostics Fluid3D::GetDiagnostics() const
+{
+	const double * rho = rho_->Data();
+	const double * vx = vx_->Data();
+	const double * vy = vy_->Data();
+	const double * vz = vz_->Data();
+
+	// Mass, momentum and kinetic energy are summed in one pass over nodes
+	const std::array<double, 5> sum = ParallelSum<5>(depth_ * rows_ * colls_, [=](int const i, double values[5])
+	{
+		values[0] = rho[i];
+		values[1] = rho[i] * vx[i];
+		values[2] = rho[i] * vy[i];
+		values[3] = rho[i] * vz[i];
+		values[4] = 0.5 * rho[i] * (vx[i] * vx[i] + vy[i] * vy[i] + vz[i] * vz[i]);
+	});
+
+	FluidDiagnostics result;
+	result.mass_ = sum[0];
+	result.momentum_x_ = sum[1];
+	result.momentum_y_ = sum[2];
+	result.momentum_z_ = sum[3];
+	result.energy_ = sum[4];
+
+	return result;
+}
+
+void Fluid3D::RecalculateVelocityComponent(const MacroscopicParamPtr & v_ptr, const double e[])
 {
 	v_ptr->FillWith(0.0);
 
 	for (int q = 0; q < kQ3d; ++q)
-		*v_ptr += (*f_)[q] * (double) e[q];
+		*v_ptr += (*f_)[q] * e[q];
 
-	v_ptr->TimesDivide(*rho_);
+	const int size = depth_ * rows_ * colls_;
+	double * v = v_ptr->Data();
+	const double * rho = rho_->Data();
 
+	// Momentum is divided by density in place, nodes without populations (boundaries) have zero velocity as in NodeMacroscopic()
+#pragma omp parallel for schedule(runtime)
+	for (int i = 0; i < size; ++i)
+		v[i] = (rho[i] == 0.0) ? 0.0 : v[i] / rho[i];
 }
 
 
@@ -11,9 +11,32 @@
 
 #include"medium.h"
 #include"../solver/solver.h"
+#include"../output/vtk_writer.h"
 
 class SRTsolver;
 
+//! Integral values of fluid, which are used to check solution (calculated by GetDiagnostics() of fluid in one pass)
+struct FluidDiagnostics
+{
+	FluidDiagnostics() : mass_(0.0), momentum_x_(0.0), momentum_y_(0.0), momentum_z_(0.0), energy_(0.0) {}
+
+	//! Total mass (sum of density)
+	double mass_;
+	//! Total momentum (Z-component is 0 in 2D case)
+	double momentum_x_;
+	double momentum_y_;
+	double momentum_z_;
+	//! Total kinetic energy
+	double energy_;
+};
+
+//! Writes diagnostics in one line
+inline std::ostream & operator<<(std::ostream & os, FluidDiagnostics const & diagnostics)
+{
+	return os << "Total rho = " << diagnostics.mass_ << ", momentum = (" << diagnostics.momentum_x_ << ", " << diagnostics.momentum_y_
+		<< ", " << diagnostics.momentum_z_ << "), kinetic energy = " << diagnostics.energy_;
+}
+
 #pragma region 2d
 
 class Fluid
@@ -46,80 +69,19 @@ public:
 	}
 
 
-	void write_fluid_vtk(std::string path,  int time) {
-
-		// Create filename
-
-		path += "/fluid_t" + std::to_string(time) + ".vtk";
-
-		//std::stringstream output_filename;
-		//output_filename << "vtk_fluid/fluid_t" << time << ".vtk";
-		std::ofstream output_file;
-
-		output_file.open(path); //output_filename.str().c_str());
-		if (output_file.is_open())
-		{
-
-			// Write VTK header
-
-			int Nx = size().second;
-			int Ny = size().first;
-
-			output_file << "# vtk DataFile Version 3.0\n";
-			output_file << "fluid_state\n";
-			output_file << "ASCII\n";
-			output_file << "DATASET RECTILINEAR_GRID\n";
-			output_file << "DIMENSIONS " << Nx << " " << Ny - 2 << " 1" << "\n";
-			output_file << "X_COORDINATES " << Nx << " float\n";
-
-			for (int X = 0; X < Nx; ++X)
-				output_file << X + 0.5 << " ";
-
-			output_file << "\n";
-			output_file << "Y_COORDINATES " << Ny - 2 << " float\n";
-
-			for (int Y = 1; Y < Ny - 1; ++Y)
-				output_file << Y - 0.5 << " ";
-
-			output_file << "\n";
-			output_file << "Z_COORDINATES " << 1 << " float\n";
-			output_file << 0 << "\n";
-			output_file << "POINT_DATA " << Nx * (Ny - 2) << "\n";
-
-			output_file << "SCALARS density float 1\n";
-			output_file << "LOOKUP_TABLE default\n";
-
-			for (int Y = 1; Y < Ny - 1; ++Y)
-				for (int X = 0; X < Nx; ++X)
-					output_file << rho_(Y, X) << "\n";
-
-			output_file << "SCALARS vx float 1\n";
-			output_file << "LOOKUP_TABLE default\n";
-
-			for (int Y = 1; Y < Ny - 1; ++Y)
-				for (int X = 0; X < Nx; ++X)
-					output_file << vx_(Y, X) << "\n";
+	//! Returns total mass, momentum and kinetic energy of fluid, result does not depend on number of threads
+	FluidDiagnostics GetDiagnostics() const;
 
-			output_file << "SCALARS vy float 1\n";
-			output_file << "LOOKUP_TABLE default\n";
+	//! Writes density and velocity of fluid (without top and bottom boundaries) to binary VTK file 'path'/fluid_t'time'.
+	//! Returns full name of written file or empty string in case of error
+	std::string write_fluid_vtk(std::string path, int time, VtkFormat const format = VtkFormat::XML_APPENDED,
+		VtkPrecision const precision = VtkPrecision::FLOAT32) const;
 
-			for (int Y = 1; Y < Ny - 1; ++Y)
-				for (int X = 0; X < Nx; ++X)
-					output_file << vy_(Y, X) << "\n";
-
-			output_file << "VECTORS velocity float\n";
-
-			for (int Y = 1; Y < Ny - 1; ++Y)
-				for (int X = 0; X < Nx; ++X)
-					output_file << vx_(Y, X) << " " << vy_(Y, X) << " 0\n";
-		}
-		else
-		{
-			std::cout << "Could not open file for fluid vtk writing!\n";
-		}
-		
-		output_file.close();
-	}
+	//! Writes macroscopic fields and distribution function to checkpoint (equilibrium function is not written,
+	//! because it is calculated from macroscopic fields)
+	void SaveState(CheckpointWriter & writer) const;
+	//! Reads fields, written by SaveState(). Returns false if checkpoint has fluid of other size
+	bool LoadState(CheckpointReader const & reader);
 
 private:
 
@@ -143,6 +105,36 @@ public:
 	DistributionFunction<double> feq_;
 };
 
+//! Writes fields of 2D fluid (without top and bottom boundaries) to binary VTK file 'path'/fluid_t'time'.
+//! Returns full name of written file or empty string in case of error
+std::string WriteFluidFieldsVtk(std::string path, int time, Matrix2D<double> const & rho, Matrix2D<double> const & vx, Matrix2D<double> const & vy,
+	VtkFormat const format = VtkFormat::XML_APPENDED, VtkPrecision const precision = VtkPrecision::FLOAT32);
+
+//! Copy of macroscopic fields of fluid, which is written to files by writer thread while solution continues (see AsyncOutput)
+struct FluidSnapshot
+{
+	FluidSnapshot(unsigned rows, unsigned colls) : rho_(rows, colls), vx_(rows, colls), vy_(rows, colls) {}
+
+	//! Copies fields of 'fluid' (memory of snapshot is reused)
+	void CopyFrom(Fluid const & fluid)
+	{
+		rho_ = fluid.rho_;
+		vx_ = fluid.vx_;
+		vy_ = fluid.vy_;
+	}
+
+	//! The same as Fluid::write_fluid_vtk() for copied fields
+	std::string write_fluid_vtk(std::string path, int time, VtkFormat const format = VtkFormat::XML_APPENDED,
+		VtkPrecision const precision = VtkPrecision::FLOAT32) const
+	{
+		return WriteFluidFieldsVtk(path, time, rho_, vx_, vy_, format, precision);
+	}
+
+	MacroscopicParam<double> rho_;
+	MacroscopicParam<double> vx_;
+	MacroscopicParam<double> vy_;
+};
+
 #pragma endregion
 
 #pragma region 3d
@@ -194,6 +186,18 @@ public:
 	void RecalculateV();
 	// Total rho calculation of all fluid domain (For check onlly)
 	long double TotalRho();
+	//! Returns total mass, momentum and kinetic energy of fluid, result does not depend on number of threads
+	FluidDiagnostics GetDiagnostics() const;
+
+	//! Writes density and velocity of fluid to binary VTK file 'path'/fluid_t'time'.
+	//! Returns full name of written file or empty string in case of error
+	std::string WriteFluidVtk(std::string path, int time, VtkFormat const format = VtkFormat::XML_APPENDED,
+		VtkPrecision const precision = VtkPrecision::FLOAT32) const;
+
+	//! Writes macroscopic fields and distribution function to checkpoint
+	void SaveState(CheckpointWriter & writer) const;
+	//! Reads fields, written by SaveState(). Returns false if checkpoint has fluid of other size
+	bool LoadState(CheckpointReader const & reader);
 
 private:
 
@@ -205,7 +209,7 @@ private:
 	int depth_;
 
 	// Recalculate single velocity component
-	void RecalculateVelocityComponent(const MacroscopicParamPtr & v_ptr, const int e[]);
+	void RecalculateVelocityComponent(const MacroscopicParamPtr & v_ptr, const double e[]);
 
 public:
 
@@ -220,7 +224,7 @@ public:
 
 	//! Probability distribution function field
 	DistributionFuncPtr f_;
-	//! Equilibrium probability distribution function field
+	//! Equilibrium probability distribution function field (empty until it is calculated)
 	DistributionFuncPtr feq_;
 
 };
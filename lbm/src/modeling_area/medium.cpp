@@ -137,6 +137,27 @@ void Medium::AddCircleBottomFalf(const int x0, const int y0, const int radius)
 	}
 }
 
+void Medium::SaveState(CheckpointWriter & writer) const
+{
+	const unsigned size[2]{ rows_, colls_ };
+
+	writer.Write("medium.size", size, 2);
+	writer.Write("medium.nodes", medium_.Data(), rows_ * colls_);
+}
+
+bool Medium::LoadState(CheckpointReader const & reader)
+{
+	unsigned size[2]{ 0, 0 };
+
+	if (!reader.Read("medium.size", size, 2) || size[0] != rows_ || size[1] != colls_)
+	{
+		std::cout << "Error! Checkpoint medium has " << size[0] << "x" << size[1] << " size instead of " << rows_ << "x" << colls_ << ".\n";
+		return false;
+	}
+
+	return reader.Read("medium.nodes", medium_.Data(), rows_ * colls_);
+}
+
 
 std::ostream & operator<<(std::ostream & os, Medium const & medium) {
 
@@ -207,6 +228,28 @@ int Medium3D::GetColumnsNumber() const
 	return colls_;
 }
 
+void Medium3D::SaveState(CheckpointWriter & writer) const
+{
+	const int size[3]{ depth_, rows_, colls_ };
+
+	writer.Write("medium3d.size", size, 3);
+	writer.Write("medium3d.nodes", medium_->Data(), depth_ * rows_ * colls_);
+}
+
+bool Medium3D::LoadState(CheckpointReader const & reader)
+{
+	int size[3]{ 0, 0, 0 };
+
+	if (!reader.Read("medium3d.size", size, 3) || size[0] != depth_ || size[1] != rows_ || size[2] != colls_)
+	{
+		std::cout << "Error! Checkpoint medium has " << size[0] << "x" << size[1] << "x" << size[2] << " size instead of "
+			<< depth_ << "x" << rows_ << "x" << colls_ << ".\n";
+		return false;
+	}
+
+	return reader.Read("medium3d.nodes", medium_->Data(), depth_ * rows_ * colls_);
+}
+
 void Medium3D::FillMedium()
 {
 	// TOP and BOTTOM layers of modeling cube (Oxy plane)
@@ -4,6 +4,7 @@
 
 #include"../math/2d/my_matrix_2d.h"
 #include"../math/3d/my_matrix_3d.h"
+#include"../output/checkpoint.h"
 
 //! Type of Eulerian grid node: fluid or one kind of boundary
 enum class NodeType : int 
@@ -57,6 +58,11 @@ public:
 		return medium_(y, x);
 	}
 
+	//! Writes types of all nodes to checkpoint
+	void SaveState(CheckpointWriter & writer) const;
+	//! Reads types of all nodes from checkpoint. Returns false if checkpoint has medium of other size
+	bool LoadState(CheckpointReader const & reader);
+
 private:
 	//! Number of rows in modeling area
 	unsigned rows_;
@@ -98,6 +104,11 @@ public:
 	//! Returns depth number of medium, or number size along X-axis
 	int GetColumnsNumber() const;
 
+	//! Writes types of all nodes to checkpoint
+	void SaveState(CheckpointWriter & writer) const;
+	//! Reads types of all nodes from checkpoint. Returns false if checkpoint has medium of other size
+	bool LoadState(CheckpointReader const & reader);
+
 private:
 
 	//! Fills each node of medium body with appropriate boundary type
@@ -0,0 +1,130 @@
+#include"sparse_lattice.h"
+
+
+#pragma region 2d
+
+
+SparseLattice::SparseLattice() : rows_(0), colls_(0) {}
+
+SparseLattice::SparseLattice(Medium const & medium) : rows_(0), colls_(0)
+{
+	Build(medium);
+}
+
+void SparseLattice::Build(Medium const & medium)
+{
+	rows_ = medium.size().first;
+	colls_ = medium.size().second;
+
+	fluid_nodes_.clear();
+	neighbours_.clear();
+	border_nodes_.clear();
+	for (int q = 0; q < D2Q9::kQ; ++q)
+		empty_slots_[q].clear();
+
+	for (int y = 0; y < rows_; ++y)
+	{
+		for (int x = 0; x < colls_; ++x)
+		{
+			if (!medium.is_fluid(y, x))
+				continue;
+
+			const int id = y * colls_ + x;
+
+			if (y == 1 || y == rows_ - 2 || x == 1 || x == colls_ - 2)
+				border_nodes_.push_back(static_cast<int>(fluid_nodes_.size()));
+
+			fluid_nodes_.push_back(id);
+
+			for (int q = 0; q < D2Q9::kQ; ++q)
+			{
+				// Neighbour in 'q' direction, the same as in SRTsolver::Streaming()
+				const int y_to = y - static_cast<int>(kEy[q]);
+				const int x_to = x + static_cast<int>(kEx[q]);
+
+				// Fluid nodes are surrounded by boundary nodes, so neighbours are always inside modeling area
+				assert(y_to >= 0 && y_to < rows_ && x_to >= 0 && x_to < colls_);
+				neighbours_.push_back(y_to * colls_ + x_to);
+
+				// Node gets nothing in 'q' direction, if neighbour upstream is not fluid
+				const int y_from = y + static_cast<int>(kEy[q]);
+				const int x_from = x - static_cast<int>(kEx[q]);
+
+				if (!medium.is_fluid(y_from, x_from))
+					empty_slots_[q].push_back(id);
+			}
+		}
+	}
+}
+
+double SparseLattice::GetPorosity() const
+{
+	return (rows_ * colls_ == 0) ? 0.0 : static_cast<double>(fluid_nodes_.size()) / (rows_ * colls_);
+}
+
+#pragma endregion
+
+
+#pragma region 3d
+
+
+SparseLattice3D::SparseLattice3D() {}
+
+SparseLattice3D::SparseLattice3D(Medium3D const & medium)
+{
+	Build(medium);
+}
+
+void SparseLattice3D::Build(Medium3D const & medium)
+{
+	const int depth = medium.GetDepthNumber();
+	const int rows = medium.GetRowsNumber();
+	const int colls = medium.GetColumnsNumber();
+
+	fluid_nodes_.clear();
+	neighbours_.clear();
+	sources_.clear();
+	layer_offsets_.assign(1, 0);
+
+	for (int z = 0; z < depth; ++z)
+	{
+		for (int y = 0; y < rows; ++y)
+		{
+			for (int x = 0; x < colls; ++x)
+			{
+				if (!medium.IsFluid(z, y, x))
+					continue;
+
+				fluid_nodes_.push_back(z * rows * colls + y * colls + x);
+
+				// Neighbour in 'q' direction, the same as in SRT3DSolver::Streaming()
+				for (int q = 0; q < D3Q19::kQ; ++q)
+				{
+					const int z_to = z + static_cast<int>(D3Q19::kEz[q]);
+					const int y_to = y + static_cast<int>(D3Q19::kEy[q]);
+					const int x_to = x + static_cast<int>(D3Q19::kEx[q]);
+
+					assert(z_to >= 0 && z_to < depth);
+					assert(y_to >= 0 && y_to < rows);
+					assert(x_to >= 0 && x_to < colls);
+
+					neighbours_.push_back(z_to * rows * colls + y_to * colls + x_to);
+				}
+
+				// Component comes from the node upstream, the opposite neighbour
+				for (int q = 0; q < D3Q19::kQ; ++q)
+				{
+					const int z_from = z - static_cast<int>(D3Q19::kEz[q]);
+					const int y_from = y - static_cast<int>(D3Q19::kEy[q]);
+					const int x_from = x - static_cast<int>(D3Q19::kEx[q]);
+
+					sources_.push_back(medium.IsFluid(z_from, y_from, x_from) ? z_from * rows * colls + y_from * colls + x_from : -1);
+				}
+			}
+		}
+
+		layer_offsets_.push_back(static_cast<int>(fluid_nodes_.size()));
+	}
+}
+
+#pragma endregion
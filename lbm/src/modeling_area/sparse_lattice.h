@@ -0,0 +1,102 @@
+#pragma once
+
+#include<vector>
+
+#include"medium.h"
+#include"../solver/solver.h"
+
+#pragma region 2d
+
+//! Indirect addressing of fluid nodes of modeling area (sparse lattice).
+//
+// Medium stores type of every node, so dense solver loops check each node and spend time on solid nodes
+// (boundaries and nodes inside bodies). Sparse lattice is built once from Medium and contains only:
+//	- list of fluid nodes (dense index y * colls + x of each fluid node, in row-major order);
+//	- neighbour table: dense index of the neighbour in each velocity direction for each fluid node;
+//	- lists of slots, which get nothing during streaming because neighbour upstream is not fluid.
+// Size of all tables is proportional to the number of fluid nodes, so collision and streaming over them
+// take time in proportion to porosity of modeling area.
+class SparseLattice
+{
+public:
+	SparseLattice();
+	explicit SparseLattice(Medium const & medium);
+	~SparseLattice() {}
+
+	//! Rebuilds all tables for 'medium' (should be called if medium is changed)
+	void Build(Medium const & medium);
+
+	//! Returns number of fluid nodes
+	int GetFluidNodesNumber() const { return static_cast<int>(fluid_nodes_.size()); }
+	//! Returns ratio of fluid nodes number to total nodes number
+	double GetPorosity() const;
+
+	//! Returns dense indexes of fluid nodes
+	std::vector<int> const & GetFluidNodes() const { return fluid_nodes_; }
+	//! Returns neighbour table: element [i * kQ + q] is dense index of the neighbour of 'i' fluid node in 'q' direction
+	std::vector<int> const & GetNeighbours() const { return neighbours_; }
+	//! Returns dense indexes of fluid nodes, which get nothing in 'q' direction during streaming (neighbour upstream is not fluid)
+	std::vector<int> const & GetEmptySlots(int const q) const { return empty_slots_[q]; }
+	//! Returns positions in fluid nodes list of fluid nodes, which lie next to the border of modeling area (rows 1, rows-2 and columns 1, colls-2)
+	std::vector<int> const & GetBorderNodes() const { return border_nodes_; }
+
+private:
+	//! Number of rows in modeling area
+	int rows_;
+	//! Number of columns in modeling area
+	int colls_;
+
+	//! Dense indexes of fluid nodes
+	std::vector<int> fluid_nodes_;
+	//! Dense indexes of neighbours of fluid nodes (kQ elements per fluid node)
+	std::vector<int> neighbours_;
+	//! Fluid nodes, which get nothing in appropriate direction during streaming
+	std::vector<int> empty_slots_[kQ];
+	//! Positions of fluid nodes next to the border in fluid nodes list
+	std::vector<int> border_nodes_;
+};
+
+#pragma endregion
+
+
+#pragma region 3d
+
+//! Indirect addressing of fluid nodes of 3D modeling area (D3Q19 model), idea is identical to 2D.
+//
+// Dense index of the node is z * rows * colls + y * colls + x (the same as in Matrix3D). Fluid nodes are listed layer by
+// layer along z-axis, so each layer (slab) of nodes is a continuous range of the list. Besides neighbour table for
+// streaming from the node (push), lattice has source table for streaming to the node (pull).
+class SparseLattice3D
+{
+public:
+	SparseLattice3D();
+	explicit SparseLattice3D(Medium3D const & medium);
+	~SparseLattice3D() {}
+
+	//! Rebuilds all tables for 'medium' (should be called if medium is changed)
+	void Build(Medium3D const & medium);
+
+	//! Returns number of fluid nodes
+	int GetFluidNodesNumber() const { return static_cast<int>(fluid_nodes_.size()); }
+	//! Returns dense indexes of fluid nodes
+	std::vector<int> const & GetFluidNodes() const { return fluid_nodes_; }
+	//! Returns neighbour table: element [i * kQ3d + q] is dense index of the neighbour of 'i' fluid node in 'q' direction
+	std::vector<int> const & GetNeighbours() const { return neighbours_; }
+	//! Returns source table: element [i * kQ3d + q] is dense index of the node, from which 'q' component comes to 'i' fluid node
+	//! during streaming, or -1 if this node is not fluid (component is bounced back)
+	std::vector<int> const & GetSources() const { return sources_; }
+	//! Returns position of the first fluid node of each layer along z-axis in fluid nodes list (depth + 1 elements)
+	std::vector<int> const & GetLayerOffsets() const { return layer_offsets_; }
+
+private:
+	//! Dense indexes of fluid nodes
+	std::vector<int> fluid_nodes_;
+	//! Dense indexes of neighbours of fluid nodes (kQ3d elements per fluid node)
+	std::vector<int> neighbours_;
+	//! Dense indexes of fluid nodes, from which components come to fluid nodes (kQ3d elements per fluid node)
+	std::vector<int> sources_;
+	//! Position of the first fluid node of each layer in fluid nodes list
+	std::vector<int> layer_offsets_;
+};
+
+#pragma endregion
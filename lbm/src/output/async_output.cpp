@@ -0,0 +1,81 @@
+#include"async_output.h"
+
+#include<iostream>
+#include<exception>
+
+
+AsyncOutput::AsyncOutput(int const capacity) : capacity_((capacity < 1) ? 1 : capacity), is_busy_(false), is_stopped_(false)
+{
+	// Thread is started after all other members are initialized
+	writer_ = std::thread(&AsyncOutput::Run, this);
+}
+
+AsyncOutput::~AsyncOutput()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		is_stopped_ = true;
+	}
+	job_added_.notify_one();
+
+	writer_.join();
+}
+
+void AsyncOutput::Push(std::function<void()> job)
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+
+	job_taken_.wait(lock, [this]() { return static_cast<int>(jobs_.size()) < capacity_; });
+
+	jobs_.push_back(std::move(job));
+	lock.unlock();
+
+	job_added_.notify_one();
+}
+
+void AsyncOutput::Flush()
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+	job_done_.wait(lock, [this]() { return jobs_.empty() && !is_busy_; });
+}
+
+void AsyncOutput::Run()
+{
+	for (;;)
+	{
+		std::function<void()> job;
+
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			job_added_.wait(lock, [this]() { return !jobs_.empty() || is_stopped_; });
+
+			// Remaining jobs are performed before stop
+			if (jobs_.empty())
+				return;
+
+			job = std::move(jobs_.front());
+			jobs_.pop_front();
+			is_busy_ = true;
+		}
+		job_taken_.notify_one();
+
+		// Error in one job should not stop output of the next ones
+		try
+		{
+			job();
+		}
+		catch (std::exception const & e)
+		{
+			std::cout << "Error! Output job failed: " << e.what() << std::endl;
+		}
+
+		// Job (and staging buffers, captured by it) is destroyed before it is reported as done
+		job = nullptr;
+
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			is_busy_ = false;
+		}
+		job_done_.notify_all();
+	}
+}
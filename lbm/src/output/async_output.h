@@ -0,0 +1,95 @@
+#pragma once
+
+#ifndef ASYNC_OUTPUT_H
+#define ASYNC_OUTPUT_H
+
+#include<thread>
+#include<mutex>
+#include<condition_variable>
+#include<functional>
+#include<deque>
+#include<vector>
+#include<memory>
+
+// Asynchronous output.
+//
+// At output step solver copies necessary fields to the staging buffer and puts writing job to the queue,
+// dedicated writer thread performs jobs while solution continues. Both the queue and the staging buffers
+// are bounded: if writing is slower than solution, solver waits for free buffer (backpressure), so memory
+// consumption does not grow.
+
+//! Writer thread with bounded queue of output jobs
+class AsyncOutput
+{
+public:
+	//! 'capacity' - maximum number of jobs waiting in the queue (besides the one being performed)
+	explicit AsyncOutput(int const capacity = 1);
+	//! Performs all remaining jobs and stops writer thread
+	~AsyncOutput();
+
+	AsyncOutput(AsyncOutput const &) = delete;
+	AsyncOutput & operator=(AsyncOutput const &) = delete;
+
+	//! Puts 'job' to the queue. If the queue is full waits until writer thread takes a job from it
+	void Push(std::function<void()> job);
+	//! Waits until all jobs are performed
+	void Flush();
+
+	//! Returns maximum number of jobs in the queue
+	int GetCapacity() const { return capacity_; }
+
+private:
+	//! Body of writer thread
+	void Run();
+
+private:
+	int const capacity_;
+
+	std::deque<std::function<void()> > jobs_;
+	//! Is writer thread performing a job now
+	bool is_busy_;
+	//! Should writer thread stop after the queue becomes empty
+	bool is_stopped_;
+
+	std::mutex mutex_;
+	std::condition_variable job_added_;
+	std::condition_variable job_taken_;
+	std::condition_variable job_done_;
+
+	std::thread writer_;
+};
+
+
+//! Fixed set of staging buffers, which are reused from one output step to another.
+// Acquired buffer is returned to the set automatically, when the last copy of returned pointer is destroyed
+// (usually when output job, which captured it, is performed). Set should outlive all acquired buffers.
+template<typename T>
+class StagingBuffers
+{
+public:
+	//! Creates 'count' buffers, each one is constructed with 'args'
+	template<typename ... Args>
+	explicit StagingBuffers(int const count, Args const & ... args);
+	~StagingBuffers() {}
+
+	StagingBuffers(StagingBuffers const &) = delete;
+	StagingBuffers & operator=(StagingBuffers const &) = delete;
+
+	//! Returns free buffer. If all buffers are in use waits until one of them is returned
+	std::shared_ptr<T> Acquire();
+
+private:
+	//! Returns buffer to the set of free ones
+	void Release(T * buffer);
+
+private:
+	std::vector<std::unique_ptr<T> > buffers_;
+	std::vector<T*> free_;
+
+	std::mutex mutex_;
+	std::condition_variable released_;
+};
+
+#include"async_output_impl.h"
+
+#endif // !ASYNC_OUTPUT_H
@@ -0,0 +1,37 @@
+#pragma once
+
+#include"async_output.h"
+
+template<typename T>
+template<typename ... Args>
+StagingBuffers<T>::StagingBuffers(int const count, Args const & ... args)
+{
+	for (int i = 0; i < count; ++i)
+	{
+		buffers_.push_back(std::unique_ptr<T>(new T(args...)));
+		free_.push_back(buffers_.back().get());
+	}
+}
+
+template<typename T>
+inline std::shared_ptr<T> StagingBuffers<T>::Acquire()
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+	released_.wait(lock, [this]() { return !free_.empty(); });
+
+	T * buffer = free_.back();
+	free_.pop_back();
+
+	// Buffer is not deleted, but returned to the set
+	return std::shared_ptr<T>(buffer, [this](T * released) { Release(released); });
+}
+
+template<typename T>
+inline void StagingBuffers<T>::Release(T * buffer)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		free_.push_back(buffer);
+	}
+	released_.notify_one();
+}
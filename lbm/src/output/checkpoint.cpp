@@ -0,0 +1,223 @@
+#include"checkpoint.h"
+
+#include<iostream>
+#include<cstdio>
+#include<cstring>
+
+
+//! Signature at the beginning of checkpoint file
+static const char kCheckpointSignature[8]{ 'L', 'B', 'M', 'C', 'H', 'K', 'P', 'T' };
+//! Byte order mark: it is read as another value on processor with other byte order
+static const std::uint32_t kByteOrderMark = 0x01020304;
+//! Name of the last section
+static const std::string kEndSection = "end";
+
+std::uint64_t CheckpointChecksum(const char * data, std::size_t size)
+{
+	const std::uint64_t prime = 1099511628211ULL;
+	std::uint64_t hash = 14695981039346656037ULL;
+
+	// Data are processed by 8-byte words, the rest by single bytes
+	std::size_t i = 0;
+	for (; i + sizeof(std::uint64_t) <= size; i += sizeof(std::uint64_t))
+	{
+		std::uint64_t word;
+		std::memcpy(&word, data + i, sizeof(word));
+		hash = (hash ^ word) * prime;
+	}
+	for (; i < size; ++i)
+		hash = (hash ^ static_cast<unsigned char>(data[i])) * prime;
+
+	return hash;
+}
+
+
+#pragma region writer
+
+CheckpointWriter::CheckpointWriter(std::string const & file_name) : file_name_(file_name), temp_name_(file_name + ".tmp"), is_ok_(true)
+{
+	file_.open(temp_name_, std::ios::binary | std::ios::trunc);
+
+	if (!file_.is_open())
+	{
+		std::cout << "Error! Could not open file " << temp_name_ << " to write checkpoint.\n";
+		is_ok_ = false;
+		return;
+	}
+
+	file_.write(kCheckpointSignature, sizeof(kCheckpointSignature));
+	file_.write(reinterpret_cast<const char *>(&kCheckpointVersion), sizeof(kCheckpointVersion));
+	file_.write(reinterpret_cast<const char *>(&kByteOrderMark), sizeof(kByteOrderMark));
+}
+
+CheckpointWriter::~CheckpointWriter()
+{
+	if (file_.is_open())
+		file_.close();
+}
+
+void CheckpointWriter::WriteSection(std::string const & name, const char * data, std::size_t const size)
+{
+	if (!is_ok_)
+		return;
+
+	const std::uint32_t name_length = static_cast<std::uint32_t>(name.size());
+	const std::uint64_t data_size = size;
+	const std::uint64_t checksum = CheckpointChecksum(data, size);
+
+	file_.write(reinterpret_cast<const char *>(&name_length), sizeof(name_length));
+	file_.write(name.data(), name.size());
+	file_.write(reinterpret_cast<const char *>(&data_size), sizeof(data_size));
+	file_.write(data, size);
+	file_.write(reinterpret_cast<const char *>(&checksum), sizeof(checksum));
+
+	if (!file_.good())
+	{
+		std::cout << "Error! Could not write section " << name << " to checkpoint " << temp_name_ << ".\n";
+		is_ok_ = false;
+	}
+}
+
+bool CheckpointWriter::Close()
+{
+	if (!file_.is_open())
+		return false;
+
+	WriteSection(kEndSection, nullptr, 0);
+	file_.close();
+
+	if (!is_ok_ || file_.fail())
+		return false;
+
+	// Old checkpoint is replaced only by completely written one (std::rename does not replace existing file on Windows)
+	std::remove(file_name_.c_str());
+	if (std::rename(temp_name_.c_str(), file_name_.c_str()) != 0)
+	{
+		std::cout << "Error! Could not rename " << temp_name_ << " to " << file_name_ << ".\n";
+		is_ok_ = false;
+	}
+
+	return is_ok_;
+}
+
+#pragma endregion
+
+
+#pragma region reader
+
+CheckpointReader::CheckpointReader(std::string const & file_name) : is_ok_(false)
+{
+	std::ifstream file(file_name, std::ios::binary | std::ios::ate);
+
+	if (!file.is_open())
+	{
+		std::cout << "Error! Could not open checkpoint " << file_name << ".\n";
+		return;
+	}
+
+	// The whole file is read at once
+	const std::streamoff file_size = file.tellg();
+	body_.resize(static_cast<std::size_t>(file_size));
+	file.seekg(0);
+	file.read(body_.data(), file_size);
+
+	if (!file.good())
+	{
+		std::cout << "Error! Could not read checkpoint " << file_name << ".\n";
+		return;
+	}
+
+	const std::size_t header_size = sizeof(kCheckpointSignature) + 2 * sizeof(std::uint32_t);
+	std::uint32_t version = 0, byte_order = 0;
+
+	if (body_.size() >= header_size)
+	{
+		std::memcpy(&version, body_.data() + sizeof(kCheckpointSignature), sizeof(version));
+		std::memcpy(&byte_order, body_.data() + sizeof(kCheckpointSignature) + sizeof(version), sizeof(byte_order));
+	}
+
+	if (body_.size() < header_size || std::memcmp(body_.data(), kCheckpointSignature, sizeof(kCheckpointSignature)) != 0)
+	{
+		std::cout << "Error! File " << file_name << " is not a checkpoint.\n";
+		return;
+	}
+	if (version != kCheckpointVersion || byte_order != kByteOrderMark)
+	{
+		std::cout << "Error! Checkpoint " << file_name << " has version " << version << " or byte order, which is not supported.\n";
+		return;
+	}
+
+	// Sections are indexed, data of each section is checked with its checksum
+	std::size_t pos = header_size;
+	bool is_end_found = false;
+
+	while (pos < body_.size() && !is_end_found)
+	{
+		std::uint32_t name_length;
+		std::uint64_t data_size, checksum;
+
+		if (pos + sizeof(name_length) > body_.size())
+			break;
+		std::memcpy(&name_length, body_.data() + pos, sizeof(name_length));
+		pos += sizeof(name_length);
+
+		if (pos + name_length + sizeof(data_size) > body_.size())
+			break;
+		const std::string name(body_.data() + pos, name_length);
+		pos += name_length;
+		std::memcpy(&data_size, body_.data() + pos, sizeof(data_size));
+		pos += sizeof(data_size);
+
+		if (data_size > body_.size() - pos || pos + data_size + sizeof(checksum) > body_.size())
+			break;
+		const std::size_t data_pos = pos;
+		pos += static_cast<std::size_t>(data_size);
+		std::memcpy(&checksum, body_.data() + pos, sizeof(checksum));
+		pos += sizeof(checksum);
+
+		if (checksum != CheckpointChecksum(body_.data() + data_pos, static_cast<std::size_t>(data_size)))
+		{
+			std::cout << "Error! Section " << name << " of checkpoint " << file_name << " is corrupted.\n";
+			return;
+		}
+
+		if (name == kEndSection)
+			is_end_found = true;
+		else
+			sections_[name] = std::make_pair(data_pos, static_cast<std::size_t>(data_size));
+	}
+
+	if (!is_end_found)
+	{
+		std::cout << "Error! Checkpoint " << file_name << " is truncated.\n";
+		return;
+	}
+
+	is_ok_ = true;
+}
+
+std::size_t CheckpointReader::GetSize(std::string const & name) const
+{
+	auto section = sections_.find(name);
+	return (section == sections_.end()) ? 0 : section->second.second;
+}
+
+const char * CheckpointReader::FindSection(std::string const & name, std::size_t const size) const
+{
+	auto section = sections_.find(name);
+
+	if (!is_ok_ || section == sections_.end())
+	{
+		std::cout << "Error! There is no section " << name << " in checkpoint.\n";
+		return nullptr;
+	}
+	if (section->second.second != size)
+	{
+		std::cout << "Error! Section " << name << " of checkpoint has " << section->second.second << " bytes instead of " << size << ".\n";
+		return nullptr;
+	}
+
+	return body_.data() + section->second.first;
+}
+
+#pragma endregion
@@ -0,0 +1,108 @@
+#pragma once
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include<string>
+#include<vector>
+#include<map>
+#include<fstream>
+#include<cstdint>
+#include<type_traits>
+
+// Binary checkpoint file.
+//
+// File consists of header and named sections:
+//	header	: "LBMCHKPT" | version (uint32) | byte order mark 0x01020304 (uint32)
+//	section	: name length (uint32) | name | data size in bytes (uint64) | data | checksum of data (uint64)
+// The last section is "end" without data, so truncated file is detected. Data are written in byte order
+// of the processor (file with other byte order is rejected). Each section is written with one call and
+// the whole file is read with one call, so writing and reading are large sequential operations.
+// Checkpoint is written to temporary file, which replaces the old checkpoint only after successful writing.
+
+//! Version of checkpoint file format
+const std::uint32_t kCheckpointVersion = 1;
+
+//! Returns 64-bit checksum of 'size' bytes (FNV-1a over 8-byte words)
+std::uint64_t CheckpointChecksum(const char * data, std::size_t size);
+
+
+//! Writes named sections to checkpoint file
+class CheckpointWriter
+{
+public:
+	//! Opens temporary file for 'file_name' checkpoint and writes header
+	explicit CheckpointWriter(std::string const & file_name);
+	//! Closes file, if Close() was not called checkpoint is not replaced
+	~CheckpointWriter();
+
+	CheckpointWriter(CheckpointWriter const &) = delete;
+	CheckpointWriter & operator=(CheckpointWriter const &) = delete;
+
+	//! Writes 'count' values from 'data' to section 'name'
+	template<typename T>
+	void Write(std::string const & name, const T * data, std::size_t const count);
+	//! Writes single 'value' to section 'name'
+	template<typename T>
+	void Write(std::string const & name, T const & value);
+
+	//! Finishes file and replaces old checkpoint with it. Returns false in case of any writing error
+	bool Close();
+
+	//! Returns true if no errors occured
+	bool IsOk() const { return is_ok_; }
+
+private:
+	//! Writes section with raw bytes
+	void WriteSection(std::string const & name, const char * data, std::size_t const size);
+
+private:
+	//! Name of checkpoint
+	std::string file_name_;
+	//! Name of temporary file
+	std::string temp_name_;
+
+	std::ofstream file_;
+	bool is_ok_;
+};
+
+
+//! Reads checkpoint file and gives access to its sections
+class CheckpointReader
+{
+public:
+	//! Reads the whole 'file_name' and checks header, checksums of all sections and presence of the "end" section
+	explicit CheckpointReader(std::string const & file_name);
+	~CheckpointReader() {}
+
+	//! Returns true if file was read and checked successfully
+	bool IsOk() const { return is_ok_; }
+
+	//! Reads 'count' values of section 'name' to 'data'. Returns false if there is no such section or its size differs
+	template<typename T>
+	bool Read(std::string const & name, T * data, std::size_t const count) const;
+	//! Reads single value of section 'name' to 'value'
+	template<typename T>
+	bool Read(std::string const & name, T & value) const;
+
+	//! Checks if section 'name' is present
+	bool Has(std::string const & name) const { return sections_.count(name) != 0; }
+	//! Returns size of section 'name' in bytes (0 if there is no such section)
+	std::size_t GetSize(std::string const & name) const;
+
+private:
+	//! Returns pointer to data of section 'name' if it has 'size' bytes, otherwise nullptr
+	const char * FindSection(std::string const & name, std::size_t const size) const;
+
+private:
+	//! Content of the whole file
+	std::vector<char> body_;
+	//! Offset and size of each section data in file body
+	std::map<std::string, std::pair<std::size_t, std::size_t> > sections_;
+
+	bool is_ok_;
+};
+
+#include"checkpoint_impl.h"
+
+#endif // !CHECKPOINT_H
@@ -0,0 +1,38 @@
+#pragma once
+
+#include"checkpoint.h"
+
+#include<cstring>
+
+template<typename T>
+inline void CheckpointWriter::Write(std::string const & name, const T * data, std::size_t const count)
+{
+	static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values could be written to checkpoint");
+	WriteSection(name, reinterpret_cast<const char *>(data), count * sizeof(T));
+}
+
+template<typename T>
+inline void CheckpointWriter::Write(std::string const & name, T const & value)
+{
+	Write(name, &value, 1);
+}
+
+template<typename T>
+inline bool CheckpointReader::Read(std::string const & name, T * data, std::size_t const count) const
+{
+	static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values could be read from checkpoint");
+
+	const char * section = FindSection(name, count * sizeof(T));
+	if (section == nullptr)
+		return false;
+
+	if (count > 0)
+		std::memcpy(data, section, count * sizeof(T));
+	return true;
+}
+
+template<typename T>
+inline bool CheckpointReader::Read(std::string const & name, T & value) const
+{
+	return Read(name, &value, 1);
+}
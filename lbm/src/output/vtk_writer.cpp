@@ -0,0 +1,353 @@
+#include"vtk_writer.h"
+
+#include<iostream>
+#include<sstream>
+#include<cassert>
+#include<algorithm>
+#include<cstring>
+#include<cstdint>
+
+
+#pragma region binary data
+
+//! Checks byte order of the processor
+static bool IsLittleEndian()
+{
+	const std::uint16_t one = 1;
+	return *reinterpret_cast<const char *>(&one) == 1;
+}
+
+//! Byte order, which is written in XML files (data are written in byte order of the processor)
+static const char * XmlByteOrder()
+{
+	return IsLittleEndian() ? "LittleEndian" : "BigEndian";
+}
+
+//! Converts 'count' nodes values of field with 'components' components to binary block of 'T' type (components of node are placed together).
+//! Missing components (nullptr) are equal to zero. Bytes of each value are reversed if 'swap_bytes' is true
+template<typename T>
+static void PackValues(const double * const data[], int const components, std::size_t const count, bool const swap_bytes, std::vector<char> & block)
+{
+	block.resize(count * components * sizeof(T));
+	char * out = block.data();
+
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		for (int c = 0; c < components; ++c)
+		{
+			const T value = (data[c] == nullptr) ? T(0) : static_cast<T>(data[c][i]);
+			std::memcpy(out, &value, sizeof(T));
+
+			if (swap_bytes)
+				std::reverse(out, out + sizeof(T));
+
+			out += sizeof(T);
+		}
+	}
+}
+
+//! Packs field values with chosen precision
+static void PackValues(const double * const data[], int const components, std::size_t const count, VtkPrecision const precision,
+	bool const swap_bytes, std::vector<char> & block)
+{
+	if (precision == VtkPrecision::FLOAT32)
+		PackValues<float>(data, components, count, swap_bytes, block);
+	else
+		PackValues<double>(data, components, count, swap_bytes, block);
+}
+
+//! Converts integer values to binary block of 32-bit integers
+static void PackIntegers(std::vector<int> const & values, bool const swap_bytes, std::vector<char> & block)
+{
+	block.resize(values.size() * sizeof(std::int32_t));
+	char * out = block.data();
+
+	for (int v : values)
+	{
+		const std::int32_t value = static_cast<std::int32_t>(v);
+		std::memcpy(out, &value, sizeof(value));
+
+		if (swap_bytes)
+			std::reverse(out, out + sizeof(value));
+
+		out += sizeof(value);
+	}
+}
+
+//! Writes binary blocks as appended raw data of XML file: each block is preceded by its size in bytes (UInt64 header)
+static void WriteAppendedData(std::ofstream & file, std::vector<std::vector<char> > const & blocks)
+{
+	file << "  <AppendedData encoding=\"raw\">\n   _";
+
+	for (auto const & block : blocks)
+	{
+		const std::uint64_t size = block.size();
+		file.write(reinterpret_cast<const char *>(&size), sizeof(size));
+		file.write(block.data(), block.size());
+	}
+
+	file << "\n  </AppendedData>\n";
+	file << "</VTKFile>\n";
+}
+
+//! Returns name of VTK type for values with chosen precision
+static const char * TypeName(VtkPrecision const precision, VtkFormat const format)
+{
+	if (format == VtkFormat::LEGACY_BINARY)
+		return (precision == VtkPrecision::FLOAT32) ? "float" : "double";
+	else
+		return (precision == VtkPrecision::FLOAT32) ? "Float32" : "Float64";
+}
+
+#pragma endregion
+
+
+#pragma region image data
+
+VtkImageWriter::VtkImageWriter(int nx, int ny, int nz, VtkFormat format, VtkPrecision precision) :
+	nx_(nx), ny_(ny), nz_(nz), origin_{ 0.0, 0.0, 0.0 }, format_(format), precision_(precision) {}
+
+void VtkImageWriter::SetOrigin(double const x, double const y, double const z)
+{
+	origin_[0] = x;
+	origin_[1] = y;
+	origin_[2] = z;
+}
+
+void VtkImageWriter::AddScalar(std::string const & name, const double * data)
+{
+	fields_.push_back(Field{ name, 1, { data, nullptr, nullptr } });
+}
+
+void VtkImageWriter::AddVector(std::string const & name, const double * vx, const double * vy, const double * vz)
+{
+	fields_.push_back(Field{ name, 3, { vx, vy, vz } });
+}
+
+std::string VtkImageWriter::Write(std::string const & file_name) const
+{
+	const std::string full_name = file_name + ((format_ == VtkFormat::LEGACY_BINARY) ? ".vtk" : ".vti");
+
+	std::ofstream file(full_name, std::ios::binary);
+
+	if (!file.is_open())
+	{
+		std::cout << "Error! Could not open file " << full_name << " to write data.\n";
+		return std::string();
+	}
+
+	if (format_ == VtkFormat::LEGACY_BINARY)
+		WriteLegacy(file);
+	else
+		WriteXml(file);
+
+	return full_name;
+}
+
+void VtkImageWriter::WriteLegacy(std::ofstream & file) const
+{
+	const std::size_t count = static_cast<std::size_t>(nx_) * ny_ * nz_;
+	// Legacy format requires big-endian data
+	const bool swap_bytes = IsLittleEndian();
+
+	file << "# vtk DataFile Version 3.0\n";
+	file << "fluid_state\n";
+	file << "BINARY\n";
+	file << "DATASET STRUCTURED_POINTS\n";
+	file << "DIMENSIONS " << nx_ << " " << ny_ << " " << nz_ << "\n";
+	file << "ORIGIN " << origin_[0] << " " << origin_[1] << " " << origin_[2] << "\n";
+	file << "SPACING 1 1 1\n";
+	file << "POINT_DATA " << count << "\n";
+
+	std::vector<char> block;
+
+	for (auto const & field : fields_)
+	{
+		if (field.components_ == 1)
+			file << "SCALARS " << field.name_ << " " << TypeName(precision_, format_) << " 1\nLOOKUP_TABLE default\n";
+		else
+			file << "VECTORS " << field.name_ << " " << TypeName(precision_, format_) << "\n";
+
+		PackValues(field.data_, field.components_, count, precision_, swap_bytes, block);
+		file.write(block.data(), block.size());
+		file << "\n";
+	}
+}
+
+void VtkImageWriter::WriteXml(std::ofstream & file) const
+{
+	const std::size_t count = static_cast<std::size_t>(nx_) * ny_ * nz_;
+
+	std::ostringstream extent;
+	extent << "0 " << nx_ - 1 << " 0 " << ny_ - 1 << " 0 " << nz_ - 1;
+
+	file << "<?xml version=\"1.0\"?>\n";
+	file << "<VTKFile type=\"ImageData\" version=\"1.0\" byte_order=\"" << XmlByteOrder() << "\" header_type=\"UInt64\">\n";
+	file << "  <ImageData WholeExtent=\"" << extent.str() << "\" Origin=\"" << origin_[0] << " " << origin_[1] << " " << origin_[2]
+		<< "\" Spacing=\"1 1 1\">\n";
+	file << "    <Piece Extent=\"" << extent.str() << "\">\n";
+	file << "      <PointData>\n";
+
+	// Blocks are placed in appended data in the same order as fields, offset of each block includes headers of previous ones
+	std::vector<std::vector<char> > blocks(fields_.size());
+	std::uint64_t offset = 0;
+
+	for (std::size_t i = 0; i < fields_.size(); ++i)
+	{
+		PackValues(fields_[i].data_, fields_[i].components_, count, precision_, false, blocks[i]);
+
+		file << "        <DataArray type=\"" << TypeName(precision_, format_) << "\" Name=\"" << fields_[i].name_
+			<< "\" NumberOfComponents=\"" << fields_[i].components_ << "\" format=\"appended\" offset=\"" << offset << "\"/>\n";
+
+		offset += sizeof(std::uint64_t) + blocks[i].size();
+	}
+
+	file << "      </PointData>\n";
+	file << "    </Piece>\n";
+	file << "  </ImageData>\n";
+
+	WriteAppendedData(file, blocks);
+}
+
+#pragma endregion
+
+
+#pragma region polyline
+
+std::string WriteVtkPolyline(std::string const & file_name, std::vector<double> const & x, std::vector<double> const & y,
+	VtkFormat const format, VtkPrecision const precision)
+{
+	assert(x.size() == y.size());
+
+	const std::string full_name = file_name + ((format == VtkFormat::LEGACY_BINARY) ? ".vtk" : ".vtp");
+	const int nodes_num = static_cast<int>(x.size());
+
+	std::ofstream file(full_name, std::ios::binary);
+
+	if (!file.is_open())
+	{
+		std::cout << "Error! Could not open file " << full_name << " to write form of immersed body. \n";
+		return std::string();
+	}
+
+	const double * points[3]{ x.data(), y.data(), nullptr };
+
+	// Lines between neighbouring nodes (the last node is connected to the first one) and vertex in each node
+	std::vector<int> lines_connectivity, vertices_connectivity;
+	for (int i = 0; i < nodes_num; ++i)
+	{
+		lines_connectivity.push_back(i);
+		lines_connectivity.push_back((i + 1) % nodes_num);
+		vertices_connectivity.push_back(i);
+	}
+
+	if (format == VtkFormat::LEGACY_BINARY)
+	{
+		const bool swap_bytes = IsLittleEndian();
+		std::vector<char> block;
+
+		file << "# vtk DataFile Version 3.0\n";
+		file << "particle_state\n";
+		file << "BINARY\n";
+		file << "DATASET POLYDATA\n";
+
+		file << "POINTS " << nodes_num << " " << TypeName(precision, format) << "\n";
+		PackValues(points, 3, nodes_num, precision, swap_bytes, block);
+		file.write(block.data(), block.size());
+
+		// Each cell is stored as number of its points and their ids
+		std::vector<int> lines, vertices{ nodes_num };
+		for (int i = 0; i < nodes_num; ++i)
+		{
+			lines.insert(lines.end(), { 2, lines_connectivity[2 * i], lines_connectivity[2 * i + 1] });
+			vertices.push_back(i);
+		}
+
+		file << "\nLINES " << nodes_num << " " << 3 * nodes_num << "\n";
+		PackIntegers(lines, swap_bytes, block);
+		file.write(block.data(), block.size());
+
+		file << "\nVERTICES 1 " << nodes_num + 1 << "\n";
+		PackIntegers(vertices, swap_bytes, block);
+		file.write(block.data(), block.size());
+		file << "\n";
+	}
+	else
+	{
+		std::vector<int> lines_offsets, vertices_offsets{ nodes_num };
+		for (int i = 0; i < nodes_num; ++i)
+			lines_offsets.push_back(2 * (i + 1));
+
+		// Points, vertices connectivity and offsets, lines connectivity and offsets
+		std::vector<std::vector<char> > blocks(5);
+		PackValues(points, 3, nodes_num, precision, false, blocks[0]);
+		PackIntegers(vertices_connectivity, false, blocks[1]);
+		PackIntegers(vertices_offsets, false, blocks[2]);
+		PackIntegers(lines_connectivity, false, blocks[3]);
+		PackIntegers(lines_offsets, false, blocks[4]);
+
+		std::uint64_t offsets[5]{ 0 };
+		for (int i = 1; i < 5; ++i)
+			offsets[i] = offsets[i - 1] + sizeof(std::uint64_t) + blocks[i - 1].size();
+
+		file << "<?xml version=\"1.0\"?>\n";
+		file << "<VTKFile type=\"PolyData\" version=\"1.0\" byte_order=\"" << XmlByteOrder() << "\" header_type=\"UInt64\">\n";
+		file << "  <PolyData>\n";
+		file << "    <Piece NumberOfPoints=\"" << nodes_num << "\" NumberOfVerts=\"1\" NumberOfLines=\"" << nodes_num
+			<< "\" NumberOfStrips=\"0\" NumberOfPolys=\"0\">\n";
+		file << "      <Points>\n";
+		file << "        <DataArray type=\"" << TypeName(precision, format) << "\" NumberOfComponents=\"3\" format=\"appended\" offset=\"" << offsets[0] << "\"/>\n";
+		file << "      </Points>\n";
+		file << "      <Verts>\n";
+		file << "        <DataArray type=\"Int32\" Name=\"connectivity\" format=\"appended\" offset=\"" << offsets[1] << "\"/>\n";
+		file << "        <DataArray type=\"Int32\" Name=\"offsets\" format=\"appended\" offset=\"" << offsets[2] << "\"/>\n";
+		file << "      </Verts>\n";
+		file << "      <Lines>\n";
+		file << "        <DataArray type=\"Int32\" Name=\"connectivity\" format=\"appended\" offset=\"" << offsets[3] << "\"/>\n";
+		file << "        <DataArray type=\"Int32\" Name=\"offsets\" format=\"appended\" offset=\"" << offsets[4] << "\"/>\n";
+		file << "      </Lines>\n";
+		file << "    </Piece>\n";
+		file << "  </PolyData>\n";
+
+		WriteAppendedData(file, blocks);
+	}
+
+	return full_name;
+}
+
+#pragma endregion
+
+
+#pragma region time series
+
+VtkSeries::VtkSeries(std::string const & file_name) : file_name_(file_name) {}
+
+void VtkSeries::Add(double const time, std::string const & data_file)
+{
+	if (data_file.empty() || file_name_.empty())
+		return;
+
+	// Data files are placed in the same folder as *.pvd file, so only their names are stored
+	const std::string::size_type pos = data_file.find_last_of("\\/");
+	entries_.push_back(std::make_pair(time, (pos == std::string::npos) ? data_file : data_file.substr(pos + 1)));
+
+	std::ofstream file(file_name_);
+
+	if (!file.is_open())
+	{
+		std::cout << "Error! Could not open file " << file_name_ << " to write time series.\n";
+		return;
+	}
+
+	file << "<?xml version=\"1.0\"?>\n";
+	file << "<VTKFile type=\"Collection\" version=\"0.1\" byte_order=\"" << XmlByteOrder() << "\">\n";
+	file << "  <Collection>\n";
+
+	for (auto const & entry : entries_)
+		file << "    <DataSet timestep=\"" << entry.first << "\" group=\"\" part=\"0\" file=\"" << entry.second << "\"/>\n";
+
+	file << "  </Collection>\n";
+	file << "</VTKFile>\n";
+}
+
+#pragma endregion
@@ -0,0 +1,105 @@
+#pragma once
+
+#ifndef VTK_WRITER_H
+#define VTK_WRITER_H
+
+#include<string>
+#include<vector>
+#include<fstream>
+#include<utility>
+
+// Binary VTK output.
+//
+// Fields are written as image data (uniform grid with unit spacing): either legacy *.vtk file with big-endian
+// binary data or XML *.vti file with raw binary data appended to the end of file. Closed polylines (forms of
+// immersed bodies) are written as polydata: legacy *.vtk or XML *.vtp. Values could be converted to float32
+// to make files twice smaller. Time series of output files is indexed by *.pvd file, so ParaView opens
+// all of them as one dataset.
+
+//! Format of VTK files
+enum class VtkFormat
+{
+	LEGACY_BINARY,	// legacy *.vtk file with big-endian binary data
+	XML_APPENDED,	// XML file (*.vti or *.vtp) with raw binary data appended to the end of file
+};
+
+//! Precision of floating point values in VTK files
+enum class VtkPrecision
+{
+	FLOAT32,	// values are converted to float
+	FLOAT64,	// values are written as is
+};
+
+
+//! Writes fields on uniform grid (image data) to binary VTK file.
+// Fields are not copied: writer keeps pointers to their values, which should be valid until Write() is called.
+// Value in node (z, y, x) is taken from data[(z * ny + y) * nx + x], so bodies of Matrix2D and Matrix3D could be passed directly.
+class VtkImageWriter
+{
+public:
+	VtkImageWriter(int nx, int ny, int nz, VtkFormat format, VtkPrecision precision);
+	~VtkImageWriter() {}
+
+	//! Sets coordinates of the first node ((0, 0, 0) by default), distance between neighbour nodes is equal to 1
+	void SetOrigin(double const x, double const y, double const z);
+
+	//! Adds scalar field with 'name'
+	void AddScalar(std::string const & name, const double * data);
+	//! Adds vector field with 'name' (z-component is equal to zero if 'vz' is nullptr)
+	void AddVector(std::string const & name, const double * vx, const double * vy, const double * vz = nullptr);
+
+	//! Writes all fields to 'file_name' with extension of chosen format. Returns full file name or empty string if file could not be written
+	std::string Write(std::string const & file_name) const;
+
+private:
+	//! Field with 1 or 3 components
+	struct Field
+	{
+		std::string name_;
+		int components_;
+		const double * data_[3];
+	};
+
+	void WriteLegacy(std::ofstream & file) const;
+	void WriteXml(std::ofstream & file) const;
+
+private:
+	//! Number of nodes along axes
+	int nx_, ny_, nz_;
+	//! Coordinates of the first node
+	double origin_[3];
+
+	VtkFormat format_;
+	VtkPrecision precision_;
+
+	std::vector<Field> fields_;
+};
+
+
+//! Writes closed polyline with nodes ('x'[i], 'y'[i]) to binary VTK file 'file_name' with extension of chosen format.
+//! Returns full file name or empty string if file could not be written
+std::string WriteVtkPolyline(std::string const & file_name, std::vector<double> const & x, std::vector<double> const & y,
+	VtkFormat const format, VtkPrecision const precision);
+
+
+//! Time series index (*.pvd file), which allows ParaView to open all output files of solution as one dataset.
+// Index is rewritten after each added file, so it is valid even if solution is interrupted.
+class VtkSeries
+{
+public:
+	VtkSeries() {}
+	//! 'file_name' is full name of *.pvd file, data files should be placed in the same folder
+	explicit VtkSeries(std::string const & file_name);
+	~VtkSeries() {}
+
+	//! Adds 'data_file' with results at 'time' to the series (does nothing if 'data_file' is empty)
+	void Add(double const time, std::string const & data_file);
+
+private:
+	//! Full name of *.pvd file
+	std::string file_name_;
+	//! Time and name of data file (relative to *.pvd file) of each series element
+	std::vector<std::pair<double, std::string> > entries_;
+};
+
+#endif // !VTK_WRITER_H
@@ -0,0 +1,174 @@
+#pragma once
+
+#ifndef ALIGNED_DISTRIBUTION_FUNC_2D_H
+#define ALIGNED_DISTRIBUTION_FUNC_2D_H
+
+#include<malloc.h> // _aligned_malloc, _aligned_free
+#include<memory>
+
+#include"distribution_func_2d.h"
+
+// Alignment (in bytes) of probability distribution function storage: cache line size
+std::size_t const kDistrFuncAlignment{ 64 };
+
+/// <summary>
+/// Probability distribution function field, stored in a single aligned block of memory.
+/// <remarks>
+/// Alternative storage of DistributionFunction for performance critical kernels.
+/// All kQ components are stored one after another in one allocation aligned on kDistrFuncAlignment bytes
+/// in [q][y][x] order (structure of arrays):
+///  - each component (plane) is surrounded by "halo" ghost layers of nodes from all sides,
+///    so streaming could write to the neighbour node without checking the modeling area edges;
+///  - each row is padded, so the first interior node of each row is aligned on kDistrFuncAlignment bytes.
+///
+/// Nodes are indexed in modeling area coordinates: interior nodes are [0, rows) x [0, colls),
+/// ghost nodes have indexes in [-halo, 0) and [rows, rows + halo) (the same for columns).
+/// Kernels could work directly with raw pointers: Row(q, y) + x, next row is Stride() elements further.
+/// </remarks>
+/// </summary>
+template<typename T>
+class AlignedDistributionFunction
+{
+public:
+
+#pragma region Constructor
+
+	AlignedDistributionFunction();
+	AlignedDistributionFunction(unsigned rows, unsigned colls, unsigned halo = 1);
+	~AlignedDistributionFunction();
+
+	AlignedDistributionFunction(AlignedDistributionFunction<T> const & other);
+
+	AlignedDistributionFunction<T> & operator=(AlignedDistributionFunction<T> const & other)
+	{
+		if (this != &other) {
+			AlignedDistributionFunction<T> temp(other);
+			temp.Swap(*this);
+		}
+		return *this;
+	}
+
+	//! Swap all values (sizes and storage) with "other" distribution function without copying
+	void Swap(AlignedDistributionFunction<T> & other);
+
+#pragma endregion
+
+#pragma region Proprerties (Get/Set)
+
+	//! Gets value of 'q'-component at [y][x] node (halo nodes are allowed)
+	T & operator()(unsigned q, int y, int x)
+	{
+		assert(q < kQ && y >= -halo_ && y < rows_ + halo_ && x >= -halo_ && x < colls_ + halo_);
+		return Row(q, y)[x];
+	}
+
+	//! Gets value of 'q'-component at [y][x] node as a constant (halo nodes are allowed)
+	T const & operator()(unsigned q, int y, int x) const
+	{
+		assert(q < kQ && y >= -halo_ && y < rows_ + halo_ && x >= -halo_ && x < colls_ + halo_);
+		return Row(q, y)[x];
+	}
+
+	//! Gets pointer to the [0][0] node of 'q'-component. Node [y][x] is at Data(q) + y * Stride() + x
+	T * Data(unsigned q)
+	{
+		return body_.get() + q * plane_stride_ + origin_;
+	}
+
+	//! Gets constant pointer to the [0][0] node of 'q'-component
+	T const * Data(unsigned q) const
+	{
+		return body_.get() + q * plane_stride_ + origin_;
+	}
+
+	//! Gets pointer to the first interior node (x = 0) of 'y' row in 'q'-component. Row is aligned on kDistrFuncAlignment bytes
+	T * Row(unsigned q, int y)
+	{
+		return Data(q) + static_cast<std::ptrdiff_t>(y) * stride_;
+	}
+
+	//! Gets constant pointer to the first interior node (x = 0) of 'y' row in 'q'-component
+	T const * Row(unsigned q, int y) const
+	{
+		return Data(q) + static_cast<std::ptrdiff_t>(y) * stride_;
+	}
+
+	//! Get pair in witch: first = rows_, second = colls_ (without halo)
+	std::pair<unsigned int, unsigned int> size() const;
+
+	//! Number of elements between the beginnings of two neighbour rows
+	int Stride() const { return stride_; }
+
+	//! Number of elements between the beginnings of two neighbour components
+	std::size_t PlaneStride() const { return plane_stride_; }
+
+	//! Width of ghost layer (in nodes)
+	int Halo() const { return halo_; }
+
+#pragma endregion
+
+#pragma region Methods
+
+	//! Resize distribution function. All previous values are lost, new values are equal to zero
+	void resize(unsigned rows, unsigned colls, unsigned halo = 1);
+
+	//! Fill all nodes (including halo) of each of kQ component with value
+	void fillWith(T const value);
+
+	//! Fill ghost layer of each of kQ component with value
+	void fillHalo(T const value);
+
+	//! Copy interior nodes values from "other" distribution function. Sizes must be equal
+	void CopyFrom(DistributionFunction<T> & other);
+
+	//! Copy interior nodes values to "other" distribution function. Sizes must be equal
+	void CopyTo(DistributionFunction<T> & other) const;
+
+	/// <summary>
+	/// Streams values of fluid nodes to "dst": dst(q, y - ey[q], x + ex[q]) = this(q, y, x), the same as SRTsolver::Streaming().
+	/// Nodes of "dst", which get nothing (downstream of solid nodes), are equal to zero.
+	/// Values, which leave modeling area, are written to the halo of "dst", so no edge checks are performed.
+	/// </summary>
+	/// <param name="dst"> Distribution function of the same size, with halo width not less than 1. </param>
+	/// <param name="medium"> Modeling area of the same size, values of its solid nodes are not streamed. </param>
+	/// <param name="ex"> Projections of lattice velocities on x-axis. </param>
+	/// <param name="ey"> Projections of lattice velocities on y-axis. </param>
+	void StreamTo(AlignedDistributionFunction<T> & dst, Medium const & medium, const double ex[kQ], const double ey[kQ]) const;
+
+#pragma endregion
+
+private:
+
+	// Release memory with _aligned_free, as it was allocated with _aligned_malloc
+	struct AlignedDeleter
+	{
+		void operator()(T * ptr) const { _aligned_free(ptr); }
+	};
+
+	//! Calculates sizes of padded storage and allocates it (filled with zeros)
+	void Allocate();
+
+private:
+
+	// Height of modeling area across Y axis direction.
+	int rows_;
+	// Lenght of modeling area across X axis direction.
+	int colls_;
+	// Width of ghost layer around modeling area.
+	int halo_;
+
+	// Number of elements in padded row.
+	int stride_;
+	// Number of elements in padded component (plane).
+	std::size_t plane_stride_;
+	// Offset of [0][0] node from the beginning of the component.
+	std::size_t origin_;
+
+	// Storage of all components of probability distribution function.
+	std::unique_ptr<T, AlignedDeleter> body_;
+
+};
+
+#include"aligned_distribution_func_2d_impl.h"
+
+#endif // !ALIGNED_DISTRIBUTION_FUNC_2D_H
@@ -0,0 +1,169 @@
+#pragma once
+
+#include"aligned_distribution_func_2d.h"
+
+template<typename T>
+inline AlignedDistributionFunction<T>::AlignedDistributionFunction() :
+	rows_(0), colls_(0), halo_(0), stride_(0), plane_stride_(0), origin_(0), body_(nullptr) {}
+
+template<typename T>
+AlignedDistributionFunction<T>::AlignedDistributionFunction(unsigned rows, unsigned colls, unsigned halo) :
+	rows_(rows), colls_(colls), halo_(halo), stride_(0), plane_stride_(0), origin_(0), body_(nullptr)
+{
+	Allocate();
+}
+
+template<typename T>
+AlignedDistributionFunction<T>::~AlignedDistributionFunction() {}
+
+template<typename T>
+inline AlignedDistributionFunction<T>::AlignedDistributionFunction(AlignedDistributionFunction<T> const & other) :
+	rows_(other.rows_), colls_(other.colls_), halo_(other.halo_), stride_(0), plane_stride_(0), origin_(0), body_(nullptr)
+{
+	Allocate();
+	// Layout depends only on sizes, so storage could be copied as a whole
+	if (body_)
+		std::copy(other.body_.get(), other.body_.get() + kQ * plane_stride_, body_.get());
+}
+
+template<typename T>
+inline void AlignedDistributionFunction<T>::Swap(AlignedDistributionFunction<T> & other)
+{
+	using std::swap;
+
+	swap(rows_, other.rows_);
+	swap(colls_, other.colls_);
+	swap(halo_, other.halo_);
+	swap(stride_, other.stride_);
+	swap(plane_stride_, other.plane_stride_);
+	swap(origin_, other.origin_);
+
+	body_.swap(other.body_);
+}
+
+template<typename T>
+inline std::pair<unsigned int, unsigned int> AlignedDistributionFunction<T>::size() const
+{
+	return std::make_pair(rows_, colls_);
+}
+
+template<typename T>
+inline void AlignedDistributionFunction<T>::resize(unsigned rows, unsigned colls, unsigned halo)
+{
+	rows_ = rows;
+	colls_ = colls;
+	halo_ = halo;
+
+	Allocate();
+}
+
+template<typename T>
+inline void AlignedDistributionFunction<T>::fillWith(T const value)
+{
+	if (body_)
+		std::fill_n(body_.get(), kQ * plane_stride_, value);
+}
+
+template<typename T>
+inline void AlignedDistributionFunction<T>::fillHalo(T const value)
+{
+	if (!body_)
+		return;
+
+	for (unsigned q = 0; q < kQ; ++q)
+	{
+		for (int y = -halo_; y < rows_ + halo_; ++y)
+		{
+			T * row = Row(q, y);
+
+			if (y < 0 || y >= rows_)
+				std::fill(row - halo_, row + colls_ + halo_, value);
+			else
+			{
+				std::fill(row - halo_, row, value);
+				std::fill(row + colls_, row + colls_ + halo_, value);
+			}
+		}
+	}
+}
+
+template<typename T>
+inline void AlignedDistributionFunction<T>::CopyFrom(DistributionFunction<T> & other)
+{
+	assert(other.size() == size());
+
+	for (unsigned q = 0; q < kQ; ++q)
+	{
+		T const * src = other[q].Data();
+
+		for (int y = 0; y < rows_; ++y)
+			std::copy(src + y * colls_, src + (y + 1) * colls_, Row(q, y));
+	}
+}
+
+template<typename T>
+inline void AlignedDistributionFunction<T>::CopyTo(DistributionFunction<T> & other) const
+{
+	assert(other.size() == size());
+
+	for (unsigned q = 0; q < kQ; ++q)
+	{
+		T * dst = other[q].Data();
+
+		for (int y = 0; y < rows_; ++y)
+			std::copy(Row(q, y), Row(q, y) + colls_, dst + y * colls_);
+	}
+}
+
+template<typename T>
+inline void AlignedDistributionFunction<T>::StreamTo(AlignedDistributionFunction<T>& dst, Medium const & medium, const double ex[kQ], const double ey[kQ]) const
+{
+	assert(dst.size() == size() && dst.halo_ >= 1);
+	assert(medium.size() == size());
+
+	// Values of solid nodes are not streamed, so nodes downstream of them are cleared first
+	dst.fillWith(T());
+
+	for (unsigned q = 0; q < kQ; ++q)
+	{
+		int const dx = static_cast<int>(ex[q]);
+		int const dy = -static_cast<int>(ey[q]);
+
+		// Each destination row is written by only one source row
+	#pragma omp parallel for schedule(runtime)
+		for (int y = 0; y < rows_; ++y)
+		{
+			T const * src_row = Row(q, y);
+			T * dst_row = dst.Row(q, y + dy) + dx;
+
+			for (int x = 0; x < colls_; ++x)
+				if (medium.is_fluid(y, x))
+					dst_row[x] = src_row[x];
+		}
+	}
+}
+
+template<typename T>
+inline void AlignedDistributionFunction<T>::Allocate()
+{
+	// Number of elements in kDistrFuncAlignment bytes
+	int const align_elems = std::max<int>(1, kDistrFuncAlignment / sizeof(T));
+	auto round_up = [align_elems](int value) { return (value + align_elems - 1) / align_elems * align_elems; };
+
+	// Left padding is enlarged so that the first interior node of each row is aligned
+	int const left_pad = round_up(halo_);
+	stride_ = round_up(left_pad + colls_ + halo_);
+	plane_stride_ = static_cast<std::size_t>(stride_) * (rows_ + 2 * halo_);
+	origin_ = static_cast<std::size_t>(halo_) * stride_ + left_pad;
+
+	body_.reset();
+	if (rows_ == 0 || colls_ == 0)
+		return;
+
+	T * ptr = static_cast<T*>(_aligned_malloc(kQ * plane_stride_ * sizeof(T), kDistrFuncAlignment));
+	if (ptr == nullptr)
+		throw std::bad_alloc();
+
+	body_.reset(ptr);
+	fillWith(T());
+}
@@ -128,6 +128,8 @@ public:
 
 	// Gets 'q'-component of probability distribution function
 	Matrix2D<T> & operator[](unsigned q);
+	// Gets 'q'-component of probability distribution function (as constant)
+	const Matrix2D<T> & operator[](unsigned q) const;
 	
 	// Get pair in witch: first = rows_, second = colls_
 	std::pair<unsigned int, unsigned int> size() const;
@@ -37,7 +37,7 @@ inline void DistributionFunction<T>::swap(DistributionFunction & dist_func)
 	std::swap(colls_, dist_func.colls_);
 
 	for (int q = 0; q < kQ; ++q)
-		dfunc_body_.at(q).swap(dist_func.dfunc_body_.at(q));
+		dfunc_body_.at(q).Swap(dist_func.dfunc_body_.at(q));
 }
 
 template<typename T>
@@ -47,6 +47,13 @@ inline Matrix2D<T>& DistributionFunction<T>::operator[](unsigned q)
 	return dfunc_body_.at(q);
 }
 
+template<typename T>
+inline const Matrix2D<T>& DistributionFunction<T>::operator[](unsigned q) const
+{
+	assert(q < kQ);
+	return dfunc_body_.at(q);
+}
+
 template<typename T>
 inline void DistributionFunction<T>::fillWithoutBoundaries(T const value)
 {
@@ -179,8 +186,9 @@ inline MacroscopicParam<T> DistributionFunction<T>::calculateVelocity(const doub
 	for (int q = 0; q < kQ; ++q)
 		result += dfunc_body_.at(q) * mas[q];
 
-	//    return,      error
-	result.TimesDivide(density);
+	// TimesDivide() returns new matrix, so swap it back (returning it directly loses MacroscopicParam type)
+	Matrix2D<T> velocity = result.TimesDivide(density);
+	result.Swap(velocity);
 	return result;
 }
 
@@ -195,8 +203,9 @@ inline MacroscopicParam<T> DistributionFunction<T>::calculateVelocity(const doub
 
 	result += 0.5 * f;
 
-	//    return,      error
-	result.TimesDivide(density);
+	// TimesDivide() returns new matrix, so swap it back (returning it directly loses MacroscopicParam type)
+	Matrix2D<T> velocity = result.TimesDivide(density);
+	result.Swap(velocity);
 	return result;
 }
 
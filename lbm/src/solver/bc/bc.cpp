@@ -2,943 +2,585 @@
 
 
 #include"bc.h"
-#include"../../math/array_func_impl.h" //     -
 
 
-#pragma region 2d
-
-
-BCs::BCs(DistributionFunction<double> & dfunc): f_ptr_(&dfunc) { }
+//! Boundaries with more links are gathered and recorded in parallel (shorter lists are faster in one thread)
+static const int kParallelLinksNumber = 4096;
 
-BCs::~BCs() {}
-
-bool BCs::PrepareValuesForSingleBC(Boundary const BC, BCType const bc_type)
+//! Clears links of 'boundary' and prepares it for links of 'bc_type' in 'size' nodes ('q_number' - number of components)
+static void ResetLinks(BoundaryLinks & boundary, BCType const bc_type, int const size, int const q_number)
 {
-	std::vector<double>(DistributionFunction<double>::*ptrToFunc)(int) const = nullptr;
-
-	switch (BC)
-	{
-	case Boundary::TOP:
-
-		ptrToFunc = &DistributionFunction<double>::getTopBoundaryValues;
-
-		if (bc_type == BCType::PERIODIC || bc_type == BCType::BOUNCE_BACK)
-			return WriteBoundaryValues(bc_type, top_boundary_, top_ids_, ptrToFunc);
-		// !! IMPLEMENTED BUT NOT TESTED !!!
-		else if (bc_type == BCType::VON_NEUMAN || bc_type == BCType::DIRICHLET)
-			return WriteVonNeumannBoundaryValues(bc_type, top_boundary_, top_ids_, mid_width_ids_, ptrToFunc);
-		
-		break;
-
-	case Boundary::BOTTOM:
-
-		ptrToFunc = &DistributionFunction<double>::getBottomBoundaryValue;
-
-		if (bc_type == BCType::PERIODIC || bc_type == BCType::BOUNCE_BACK)
-			return WriteBoundaryValues(bc_type, bottom_boundary_, bottom_ids_, ptrToFunc);
-		// !! IMPLEMENTED BUT NOT TESTED !!!
-		else if (bc_type == BCType::VON_NEUMAN || bc_type == BCType::DIRICHLET)
-			return WriteVonNeumannBoundaryValues(bc_type, bottom_boundary_, bottom_ids_, mid_width_ids_, ptrToFunc);
-
-		break;
-
-	case Boundary::LEFT:
-
-		ptrToFunc = &DistributionFunction<double>::getLeftBoundaryValue;
-
-		if (bc_type == BCType::PERIODIC || bc_type == BCType::BOUNCE_BACK)
-			return WriteBoundaryValues(bc_type, left_boundary_, left_ids_, ptrToFunc);
-		// !! IMPLEMENTED BUT NOT TESTED !!!
-		else if (bc_type == BCType::VON_NEUMAN || bc_type == BCType::DIRICHLET)
-			return WriteVonNeumannBoundaryValues(bc_type, left_boundary_, left_ids_, mid_height_ids_, ptrToFunc);
-
-		break;
-
-	case Boundary::RIGHT:
-
-		ptrToFunc = &DistributionFunction<double>::getRightBoundaryValue;
-
-		if (bc_type == BCType::PERIODIC || bc_type == BCType::BOUNCE_BACK)
-			return WriteBoundaryValues(bc_type, right_boundary_, right_ids_, ptrToFunc);
-		// !! IMPLEMENTED BUT NOT TESTED !!!
-		else if (bc_type == BCType::VON_NEUMAN || bc_type == BCType::DIRICHLET)
-			return WriteVonNeumannBoundaryValues(bc_type, right_boundary_, right_ids_, mid_height_ids_, ptrToFunc);
-
-		break;
-
-	default:
-		std::cout << "Try to prepare values for wrong BC Type.\n";
-		break;
-	}
+	boundary.type_ = bc_type;
+	boundary.is_built_ = true;
+	boundary.size_ = size;
+	boundary.stored_.clear();
+	boundary.recorded_.clear();
+	boundary.offset_.assign(q_number, -1);
 }
 
-void BCs::PrepareValuesForAllBC(BCType const top_bc, BCType const bottm_bc, BCType const left_bc, BCType const right_bc)
+//! Builds links of Periodic and Bounce Back BCs: value of component ids[k].first in the i-th node of 'nodes' is recorded
+//! to component ids[k].second in the i-th node of 'recorded_nodes'
+static void BuildCopyLinks(BoundaryLinks & boundary, BCType const bc_type, int const q_number, std::vector<int> const & nodes,
+	std::vector<int> const & recorded_nodes, std::vector<std::pair<int, int> > const & ids)
 {
-	if (PrepareValuesForSingleBC(Boundary::TOP, top_bc) &&
-		PrepareValuesForSingleBC(Boundary::BOTTOM, bottm_bc) &&
-		PrepareValuesForSingleBC(Boundary::LEFT, left_bc) &&
-		PrepareValuesForSingleBC(Boundary::RIGHT, right_bc)) 
+	const int size = static_cast<int>(nodes.size());
+	ResetLinks(boundary, bc_type, size, q_number);
+
+	for (auto const & id : ids)
 	{
-		//      
-	}
-	else
-	{
-		std::cout << "Error while prepairing BC values!\n";
-		throw;
+		boundary.offset_.at(id.first) = static_cast<int>(boundary.stored_.size());
+		for (auto node : nodes)
+			boundary.stored_.push_back(BoundaryLink{ id.first, node });
+		for (auto node : recorded_nodes)
+			boundary.recorded_.push_back(BoundaryLink{ id.second, node });
 	}
+
+	boundary.recorded_first_ = 0;
+	boundary.values_.assign(boundary.stored_.size(), 0.0);
 }
 
-void BCs::RecordValuesOnSingleBC(Boundary const BC, BCType const bc_type)
+//! Builds links of Von Neumann and Dirichlet BCs: components 'stored_ids' are stored in 'nodes', components
+//! 'calculated_ids' are calculated from them and recorded to the same nodes
+static void BuildCalculatedLinks(BoundaryLinks & boundary, BCType const bc_type, int const q_number, std::vector<int> const & nodes,
+	std::vector<int> const & stored_ids, std::vector<int> const & calculated_ids)
 {
-	void(DistributionFunction<double>::*ptrToFunc)(int const, std::vector<double> const &) = nullptr;
+	const int size = static_cast<int>(nodes.size());
+	ResetLinks(boundary, bc_type, size, q_number);
 
-	switch (BC)
+	for (auto id : stored_ids)
 	{
-	case Boundary::TOP:
-
-		if (bc_type == BCType::PERIODIC)
-		{
-			ptrToFunc = &DistributionFunction<double>::setBottomBoundaryValue;
-			RecordBoundaryValues(bc_type, top_boundary_, top_ids_, ptrToFunc);
-		}
-		else if (bc_type == BCType::BOUNCE_BACK || bc_type == BCType::VON_NEUMAN || bc_type == BCType::DIRICHLET) // !! VON NEUMANN IS NOT TESTED YET !!!
-		{
-			ptrToFunc = &DistributionFunction<double>::setTopBoundaryValue;
-			RecordBoundaryValues(bc_type, top_boundary_, bottom_ids_, ptrToFunc);
-		}
-
-		break;
-	case Boundary::BOTTOM:
-
-		if (bc_type == BCType::PERIODIC)
-		{
-			ptrToFunc = &DistributionFunction<double>::setTopBoundaryValue;
-			RecordBoundaryValues(bc_type, bottom_boundary_, bottom_ids_, ptrToFunc);
-		}
-		else if (bc_type == BCType::BOUNCE_BACK || bc_type == BCType::VON_NEUMAN || bc_type == BCType::DIRICHLET) // !! VON NEUMANN IS NOT TESTED YET !!!
-		{
-			ptrToFunc = &DistributionFunction<double>::setBottomBoundaryValue;
-			RecordBoundaryValues(bc_type, bottom_boundary_, top_ids_, ptrToFunc);
-		}
-
-		break;
-	case Boundary::LEFT:
-
-		if (bc_type == BCType::PERIODIC)
-		{
-			ptrToFunc = &DistributionFunction<double>::setRightBoundaryValue;
-			RecordBoundaryValues(bc_type, left_boundary_, left_ids_, ptrToFunc);
-		}
-		else if (bc_type == BCType::BOUNCE_BACK || bc_type == BCType::VON_NEUMAN || bc_type == BCType::DIRICHLET)
-		{
-			ptrToFunc = &DistributionFunction<double>::setLeftBoundaryValue;
-			RecordBoundaryValues(bc_type, left_boundary_, right_ids_, ptrToFunc);
-		}
-
-		break;
-	case Boundary::RIGHT:
+		boundary.offset_.at(id) = static_cast<int>(boundary.stored_.size());
+		for (auto node : nodes)
+			boundary.stored_.push_back(BoundaryLink{ id, node });
+	}
 
-		if (bc_type == BCType::PERIODIC)
-		{
-			ptrToFunc = &DistributionFunction<double>::setLeftBoundaryValue;
-			RecordBoundaryValues(bc_type, right_boundary_, right_ids_, ptrToFunc);
-		}
-		else if (bc_type == BCType::BOUNCE_BACK || bc_type == BCType::VON_NEUMAN || bc_type == BCType::DIRICHLET) // !! VON NEUMANN IS NOT TESTED YET !!!
-		{
-			ptrToFunc = &DistributionFunction<double>::setRightBoundaryValue;
-			RecordBoundaryValues(bc_type, right_boundary_, left_ids_, ptrToFunc);
-		}
+	boundary.recorded_first_ = static_cast<int>(boundary.stored_.size());
 
-		break;
-	default:
-		std::cout << "Wrong BC type appears while record BC.\n";
-		break;
+	for (auto id : calculated_ids)
+	{
+		boundary.offset_.at(id) = boundary.recorded_first_ + static_cast<int>(boundary.recorded_.size());
+		for (auto node : nodes)
+			boundary.recorded_.push_back(BoundaryLink{ id, node });
 	}
+
+	boundary.values_.assign(boundary.stored_.size() + boundary.recorded_.size(), 0.0);
 }
 
-void BCs::RecordValuesForAllBC(BCType const top_bc, BCType const bottm_bc, BCType const left_bc, BCType const right_bc)
+//! Stores values of all stored links of 'boundary' ('f' - pointers to bodies of distribution function components)
+static void GatherValues(BoundaryLinks & boundary, double * const f[])
 {
-	RecordValuesOnSingleBC(Boundary::TOP, top_bc);
-	RecordValuesOnSingleBC(Boundary::BOTTOM, bottm_bc);
-	RecordValuesOnSingleBC(Boundary::LEFT, left_bc);
-	RecordValuesOnSingleBC(Boundary::RIGHT, right_bc);
+	const int links_number = static_cast<int>(boundary.stored_.size());
+	BoundaryLink const * links = boundary.stored_.data();
+	double * values = boundary.values_.data();
+
+#pragma omp parallel for if(links_number > kParallelLinksNumber)
+	for (int i = 0; i < links_number; ++i)
+		values[i] = f[links[i].q_][links[i].node_];
 }
 
-bool BCs::WriteBoundaryValues(BCType const bc_type, std::map<int, std::vector<double>>& bc_boundary, const std::vector<int>& bc_ids, std::vector<double>(DistributionFunction<double>::* ptrToFunc)(int) const)
+//! Writes values to all recorded links of 'boundary' (each link of one boundary is unique, so links could be written in any order)
+static void ScatterValues(BoundaryLinks const & boundary, double * const f[])
 {
-	if (bc_type == BCType::PERIODIC || bc_type == BCType::BOUNCE_BACK)
-	{
-		for (auto bc_id : bc_ids)
-			// Get appropriate values from probability distribution function (using APPROPRIATE function via ptr. to function) 
-			// and write them in appropriate class fields.
-			bc_boundary.insert(std::make_pair(bc_id, (*f_ptr_.*ptrToFunc)(bc_id)));
-
-		return true;
+	const int links_number = static_cast<int>(boundary.recorded_.size());
+	BoundaryLink const * links = boundary.recorded_.data();
+	double const * values = boundary.values_.data() + boundary.recorded_first_;
 
-	}
-	return false;
+#pragma omp parallel for if(links_number > kParallelLinksNumber)
+	for (int i = 0; i < links_number; ++i)
+		f[links[i].q_][links[i].node_] = values[i];
 }
 
-bool BCs::WriteVonNeumannBoundaryValues(BCType const bc_type, std::map<int, std::vector<double>>& bc_boundary, const std::vector<int>& bc_ids_1, const std::vector<int>& bc_ids_2, std::vector<double>(DistributionFunction<double>::* ptrToFunc)(int) const)
+std::ostream & operator<<(std::ostream & os, BoundaryLinks const & boundary)
 {
-	if (bc_type == BCType::VON_NEUMAN || bc_type == BCType::DIRICHLET)
+	for (int q = 0; q < static_cast<int>(boundary.offset_.size()); ++q)
 	{
-		// Idea: Get Values from first and second layers: for example for BOTTOM we need ALL distribution function from MIDDLE and TOP layers
-		// Get appropriate values from probability distribution function (using APPROPRIATE function via ptr. to function) 
-		// and write them in appropriate class fields.
-
-		for (auto bc_id_1 : bc_ids_1)
-			bc_boundary.insert(std::make_pair(bc_id_1, (*f_ptr_.*ptrToFunc)(bc_id_1)));
-		for (auto bc_id_2 : bc_ids_2)
-			bc_boundary.insert(std::make_pair(bc_id_2, (*f_ptr_.*ptrToFunc)(bc_id_2)));
+		if (boundary.offset_[q] < 0)
+			continue;
 
-		return true;
+		os << "f[" << q << "] = ";
+		for (int i = 0; i < boundary.size_; ++i)
+			os << boundary.values_[boundary.offset_[q] + i] << ' ';
+		os << std::endl;
 	}
-	else
-	{
 
-	}
-	return false;
+	return os;
 }
 
-bool BCs::RecordBoundaryValues(BCType const bc_type, std::map<int, std::vector<double>>& bc_boundary, const std::vector<int>& bc_ids, void(DistributionFunction<double>::* ptrToFunc)(int const, std::vector<double> const &))
-{
 
-	if (bc_type == BCType::PERIODIC || bc_type == BCType::BOUNCE_BACK) // !!!         bc_type == BCType::VON_NEUMAN !!!
-	{
-		for (auto bc_id : bc_ids)
-		{
-			auto f_id = bc_boundary.find(bc_id);
-			(*f_ptr_.*ptrToFunc)(f_id->first, f_id->second);
-		}
-		return true;
-	}
-	else if (bc_type == BCType::VON_NEUMAN || bc_type == BCType::DIRICHLET)
-	{
-		// !!! In testing mode
-		for (auto bc_id : bc_ids)
-		{
-			auto f_id = bc_boundary.find(bc_id);
-			(*f_ptr_.*ptrToFunc)(f_id->first, f_id->second);
-		}
-		return true;
-	}
-	else
-	{
-		std::cout << "Wrong BC Type is used!\n";
-	}
-	return false;
-}
+#pragma region 2d
 
 
-void BCs::PeriodicBC(Boundary const first, Boundary const second)
-{
-	if (first == Boundary::LEFT && second == Boundary::RIGHT)
-		left_boundary_.swap(right_boundary_);
-	else if (first == Boundary::TOP && second == Boundary::BOTTOM)
-		top_boundary_.swap(bottom_boundary_);
-	else
-		throw;
-}
+BCs::BCs(DistributionFunction<double> & dfunc): f_ptr_(&dfunc) { }
 
-void BCs::BounceBackBC(Boundary const first)
-{
-	if (first == Boundary::TOP) 
-	{
-		SwapId(top_boundary_, 2, 4);
-		SwapId(top_boundary_, 5, 8);
-		SwapId(top_boundary_, 6, 7);
-	}
-	else if(first == Boundary::BOTTOM) 
-	{
-		SwapId(bottom_boundary_, 4, 2);
-		SwapId(bottom_boundary_, 8, 5);
-		SwapId(bottom_boundary_, 7, 6);
-	}
-	else if (first == Boundary::LEFT) 
-	{
-		SwapId(left_boundary_, 3, 1);
-		SwapId(left_boundary_, 6, 8);
-		SwapId(left_boundary_, 7, 5);
-	}
-	else if (first == Boundary::RIGHT) 
-	{
-		SwapId(right_boundary_, 1, 3);
-		SwapId(right_boundary_, 5, 7);
-		SwapId(right_boundary_, 8, 6);
-	}
-}
+BCs::~BCs() {}
 
-void BCs::VonNeumannBC(Boundary const first, Fluid & fluid, double const vx, double const vy)
+BoundaryLinks & BCs::GetBoundary(Boundary const BC)
 {
-	// Choose size of domain depending on boundary type
-	const int x_size = fluid.size().second;
-	const int y_size = fluid.size().first - 2;
-	const int domainSize = (first == Boundary::TOP || first == Boundary::BOTTOM) ? x_size : y_size;
-
-	switch (first)
+	switch (BC)
 	{
 	case Boundary::TOP:
-		CalculateVonNeumanBCValues(first, domainSize, top_boundary_, mid_width_ids_, top_ids_, vx, vy);
-		break;
+		return top_boundary_;
 	case Boundary::BOTTOM:
-		CalculateVonNeumanBCValues(first, domainSize, bottom_boundary_, mid_width_ids_, bottom_ids_, vx, vy);
-		break;
+		return bottom_boundary_;
 	case Boundary::LEFT:
-		CalculateVonNeumanBCValues(first, domainSize, left_boundary_, mid_height_ids_, left_ids_, vx, vy);
-		break;
+		return left_boundary_;
 	case Boundary::RIGHT:
-		CalculateVonNeumanBCValues(first, domainSize, right_boundary_, mid_height_ids_, right_ids_, vx, vy);
-		break;
+		return right_boundary_;
 	default:
-		std::cout << "Wrong boundary type while appling Von-Neumann boundary condidtions.\n";
-		break;
+		std::cout << "Wrong boundary type is used in 2D BC.\n";
+		throw;
 	}
 }
 
-void BCs::DirichletBC(Boundary const first, Fluid & fluid, double const rho_0)
+const std::vector<int> & BCs::GetIds(Boundary const BC) const
 {
-	// Choose size of domain depending on boundary type
-	const int x_size = fluid.size().second;
-	const int y_size = fluid.size().first - 2;
-	const int domainSize = (first == Boundary::TOP || first == Boundary::BOTTOM) ? x_size : y_size;
-
-	switch (first)
+	switch (BC)
 	{
 	case Boundary::TOP:
-		CalculateDirichletBCValues(first, domainSize, top_boundary_, mid_width_ids_, top_ids_, rho_0);
-		break;
+		return top_ids_;
 	case Boundary::BOTTOM:
-		CalculateDirichletBCValues(first, domainSize, bottom_boundary_, mid_width_ids_, bottom_ids_, rho_0);
-		break;
+		return bottom_ids_;
 	case Boundary::LEFT:
-		CalculateDirichletBCValues(first, domainSize, left_boundary_, mid_height_ids_, left_ids_, rho_0);
-		break;
+		return left_ids_;
 	case Boundary::RIGHT:
-		CalculateDirichletBCValues(first, domainSize, right_boundary_, mid_height_ids_, right_ids_, rho_0);
-		break;
+		return right_ids_;
 	default:
-		std::cout << "Wrong boundary type while appling Von-Neumann boundary condidtions.\n";
-		break;
+		std::cout << "Wrong boundary type is used in 2D BC.\n";
+		throw;
 	}
 }
 
-void BCs::CalculateVonNeumanBCValues(Boundary const first, const int size, std::map<int, std::vector<double>> & boundary, 
-	const std::vector<int> ids_1, const std::vector<int> ids_2, 
-	double const vx, double const vy)
+std::vector<int> BCs::GetBoundaryNodes(Boundary const BC) const
 {
-	// Final vector for density and temp for make calculations below easy to understand
-	std::vector<double> rho(size, 0.0);
-	std::vector<double> temp(size, 0.0);
-
-	// Start density calculation
-	for (auto id : ids_1)
-		rho = rho + boundary.at(id);
-	for (auto id : ids_2)
-		rho = rho + boundary.at(id) * 2.0;
-
-	// Steps below depends on chosen boundary: 1. final density calculation and 2. necessary distribution function components calclulations
-	switch (first)
-	{
-	case Boundary::TOP:
-		rho = rho / (1.0 + vy);
+	const int rows = static_cast<int>(f_ptr_->size().first);
+	const int colls = static_cast<int>(f_ptr_->size().second);
+	std::vector<int> nodes;
 
-		boundary.insert(std::make_pair(4, boundary.at(2) - 2.0 / 3.0 * rho * vy));
-
-		temp = (boundary.at(1) - boundary.at(3)) / 2.0;
-
-		boundary.insert(std::make_pair(7, boundary.at(5) + temp - (vy / 6.0 + vx / 2.0) * rho));
-		boundary.insert(std::make_pair(8, boundary.at(6) - temp - (vy / 6.0 - vx / 2.0) * rho));
-		break;
-	case Boundary::BOTTOM:
-		rho = rho / (1.0 - vy);
-
-		boundary.insert(std::make_pair(2, boundary.at(4) + 2.0 / 3.0 * rho * vy));
-
-		temp = (boundary.at(1) - boundary.at(3)) / 2.0;
-
-		boundary.insert(std::make_pair(5, boundary.at(7) - temp + (vy / 6.0 + vx / 2.0) * rho));
-		boundary.insert(std::make_pair(6, boundary.at(8) + temp + (vy / 6.0 - vx / 2.0) * rho));
-		break;
-	case Boundary::LEFT:
-		rho = rho / (1.0 - vx);
-
-		boundary.insert(std::make_pair(1, boundary.at(3) + 2.0 / 3.0 * rho * vx));
-
-		temp = (boundary.at(2) - boundary.at(4)) / 2.0;
-
-		boundary.insert(std::make_pair(5, boundary.at(7) - temp + (vx / 6.0 + vy / 2.0) * rho));
-		boundary.insert(std::make_pair(8, boundary.at(6) + temp + (vx / 6.0 - vy / 2.0) * rho));
-		break;
-	case Boundary::RIGHT:
-		rho = rho / (1.0 + vx);
-
-		boundary.insert(std::make_pair(3, boundary.at(1) - 2.0 / 3.0 * rho * vx));
-
-		temp = (boundary.at(2) - boundary.at(4)) / 2.0;
-
-		boundary.insert(std::make_pair(6, boundary.at(8) - temp - (vx / 6.0 - vy / 2.0) * rho));
-		boundary.insert(std::make_pair(7, boundary.at(5) + temp - (vx / 6.0 + vy / 2.0) * rho));
-		break;
-	default:
-		std::cout << "Wrong boundary type while Calculating Von-Neumann boundary condidtions.\n";
-		break;
+	if (BC == Boundary::TOP || BC == Boundary::BOTTOM)
+	{
+		const int y = (BC == Boundary::TOP) ? 1 : rows - 2;
+		for (int x = 0; x < colls; ++x)
+			nodes.push_back(y * colls + x);
+	}
+	else if (BC == Boundary::LEFT || BC == Boundary::RIGHT)
+	{
+		const int x = (BC == Boundary::LEFT) ? 1 : colls - 2;
+		for (int y = 1; y < rows - 1; ++y)
+			nodes.push_back(y * colls + x);
 	}
 
-	// Clear map from all incoming data, leaving only necessary distribution function components
-	for (auto id : ids_1)
-		boundary.erase(id);
-
-	for (auto id : ids_2)
-		boundary.erase(id);
+	return nodes;
 }
 
-void BCs::CalculateDirichletBCValues(Boundary const first, const int size, std::map<int, std::vector<double>>& boundary, const std::vector<int> ids_1, const std::vector<int> ids_2, double const rho_0)
+bool BCs::BuildLinks(Boundary const BC, BCType const bc_type)
 {
-	// Final vector for density and temp for make calculations below easy to understand
-	std::vector<double> v(size, 0.0);
-	std::vector<double> temp(size, 0.0);
-
-	// Start density calculation
-	for (auto id : ids_1)
-		v = v + boundary.at(id);
-	for (auto id : ids_2)
-		v = v + boundary.at(id) * 2.0;
-
-	// Steps below depends on chosen boundary: 1. final density calculation and 2. necessary distribution function components calclulations
-	switch (first)
-	{
-	case Boundary::TOP:
-		v = v / rho_0 - 1.0;
-
-		// Set the velocity of first and last elements to zero, because this is boundary
-		v.at(0) = 0.0;
-		v.at(size - 1) = 0.0;
-
-		boundary.insert(std::make_pair(4, boundary.at(2) - 2.0 / 3.0 * rho_0 * v));
+	const bool is_horizontal = (BC == Boundary::TOP || BC == Boundary::BOTTOM);
 
-		temp = (boundary.at(1) - boundary.at(3)) / 2.0;
+	// Directions, which come to the boundary and which come from it after BC applying
+	std::vector<int> const * ids = nullptr;
+	std::vector<int> const * reflected_ids = nullptr;
+	Boundary opposite = BC;
 
-		boundary.insert(std::make_pair(7, boundary.at(5) + temp - (rho_0 / 6.0) * v));
-		boundary.insert(std::make_pair(8, boundary.at(6) - temp - (rho_0 / 6.0) * v));
+	switch (BC)
+	{
+	case Boundary::TOP:
+		ids = &top_ids_;
+		reflected_ids = &bottom_ids_;
+		opposite = Boundary::BOTTOM;
 		break;
 	case Boundary::BOTTOM:
-		v =  ( v / rho_0) * -1.0 + 1.0;
-
-		v.at(0) = 0.0;
-		v.at(size - 1) = 0.0;
-
-		boundary.insert(std::make_pair(2, boundary.at(4) + 2.0 / 3.0 * rho_0 * v));
-
-		temp = (boundary.at(1) - boundary.at(3)) / 2.0;
-
-		boundary.insert(std::make_pair(5, boundary.at(7) - temp + (rho_0 / 6.0) * v));
-		boundary.insert(std::make_pair(6, boundary.at(8) + temp + (rho_0 / 6.0) * v));
+		ids = &bottom_ids_;
+		reflected_ids = &top_ids_;
+		opposite = Boundary::TOP;
 		break;
 	case Boundary::LEFT:
-		v = (v / rho_0) * -1.0 + 1.0;
-
-		v.at(0) = 0.0;
-		v.at(size - 1) = 0.0;
-
-		boundary.insert(std::make_pair(1, boundary.at(3) + 2.0 / 3.0 * rho_0 * v));
-
-		temp = (boundary.at(2) - boundary.at(4)) / 2.0;
-
-		boundary.insert(std::make_pair(5, boundary.at(7) - temp + (rho_0 / 6.0) * v));
-		boundary.insert(std::make_pair(8, boundary.at(6) + temp + (rho_0 / 6.0) * v));
+		ids = &left_ids_;
+		reflected_ids = &right_ids_;
+		opposite = Boundary::RIGHT;
 		break;
 	case Boundary::RIGHT:
-		v = v / rho_0 - 1.0;
+		ids = &right_ids_;
+		reflected_ids = &left_ids_;
+		opposite = Boundary::LEFT;
+		break;
+	default:
+		std::cout << "Try to prepare values for wrong BC Type.\n";
+		return false;
+	}
 
-		v.at(0) = 0.0;
-		v.at(size - 1) = 0.0;
+	const std::vector<int> nodes = GetBoundaryNodes(BC);
+	std::vector<std::pair<int, int> > copied_ids;
 
-		boundary.insert(std::make_pair(3, boundary.at(1) - 2.0 / 3.0 * rho_0 * v));
+	switch (bc_type)
+	{
+	case BCType::PERIODIC:
+		// Values leave the domain through the boundary and come back through the opposite one
+		for (auto id : *ids)
+			copied_ids.push_back(std::make_pair(id, id));
+		BuildCopyLinks(GetBoundary(BC), bc_type, kQ, nodes, GetBoundaryNodes(opposite), copied_ids);
+		return true;
+		
+	case BCType::BOUNCE_BACK:
+		// On LEFT and RIGHT boundaries directions are reversed, on TOP and BOTTOM only vertical component of velocity is
+		// reversed: { 2->4, 5->8, 6->7 } for TOP
+		for (auto id : *ids)
+		{
+			int reflected_id = D2Q9::kOpposite[id];
+			for (auto candidate : *reflected_ids)
+				if (is_horizontal && D2Q9::kEx[candidate] == D2Q9::kEx[id])
+					reflected_id = candidate;
+			copied_ids.push_back(std::make_pair(id, reflected_id));
+		}
+		BuildCopyLinks(GetBoundary(BC), bc_type, kQ, nodes, nodes, copied_ids);
+		return true;
 
-		temp = (boundary.at(2) - boundary.at(4)) / 2.0;
+	case BCType::VON_NEUMAN:
+	case BCType::DIRICHLET:
+		// For example for TOP we need { 0,1,3 } and { 2,5,6 } to calculate { 4,7,8 }
+		{
+			std::vector<int> stored_ids = is_horizontal ? mid_width_ids_ : mid_height_ids_;
+			stored_ids.insert(stored_ids.end(), ids->begin(), ids->end());
+			BuildCalculatedLinks(GetBoundary(BC), bc_type, kQ, nodes, stored_ids, *reflected_ids);
+		}
+		return true;
 
-		boundary.insert(std::make_pair(6, boundary.at(8) - temp - (rho_0 / 6.0) * v));
-		boundary.insert(std::make_pair(7, boundary.at(5) + temp - (rho_0 / 6.0) * v));
-		break;
 	default:
-		std::cout << "Wrong boundary type while Calculating Von-Neumann boundary condidtions.\n";
-		break;
+		std::cout << "Wrong BC Type is used!\n";
+		return false;
 	}
+}
 
-	// Clear map from all incoming data, leaving only necessary distribution function components
-	for (auto id : ids_1)
-		boundary.erase(id);
+bool BCs::PrepareValuesForSingleBC(Boundary const BC, BCType const bc_type)
+{
+	// Links are built once for each boundary and rebuilt only if BC type of boundary is changed
+	if (!GetBoundary(BC).is_built_ || GetBoundary(BC).type_ != bc_type)
+		if (!BuildLinks(BC, bc_type))
+			return false;
 
-	for (auto id : ids_2)
-		boundary.erase(id);
+	// Von Neumann and Dirichlet BCs need components, which are known after streaming, they are taken on recording
+	if (bc_type == BCType::PERIODIC || bc_type == BCType::BOUNCE_BACK)
+	{
+		double * f[kQ];
+		for (int q = 0; q < kQ; ++q)
+			f[q] = (*f_ptr_)[q].Data();
 
+		GatherValues(GetBoundary(BC), f);
+	}
+	return true;
 }
 
-void BCs::SwapId(std::map<int, std::vector<double>> & map, int const from, int const to)
+void BCs::PrepareValuesForAllBC(BCType const top_bc, BCType const bottm_bc, BCType const left_bc, BCType const right_bc)
 {
-	std::vector<double> temp;
-	auto iter = map.find(from);
-	temp.swap(iter->second);
-	map.erase(iter);
-	map.insert(std::make_pair(to, temp));
+	if (PrepareValuesForSingleBC(Boundary::TOP, top_bc) &&
+		PrepareValuesForSingleBC(Boundary::BOTTOM, bottm_bc) &&
+		PrepareValuesForSingleBC(Boundary::LEFT, left_bc) &&
+		PrepareValuesForSingleBC(Boundary::RIGHT, right_bc)) 
+	{
+		//      
+	}
+	else
+	{
+		std::cout << "Error while prepairing BC values!\n";
+		throw;
+	}
 }
 
-std::ostream & operator<<(std::ostream & os, BCs const & BC)
+void BCs::RecordValuesOnSingleBC(Boundary const BC, BCType const bc_type)
 {
-	os.precision(3);
+	BoundaryLinks & boundary = GetBoundary(BC);
 
-	os << "TOP BOUNDARY ------ \n";
-	for (auto i : BC.top_boundary_) {
-		os << "f[" << i.first << "] = ";
-		for (auto j : i.second)
-			os << j << ' ';
-		os << std::endl;
+	if (!boundary.is_built_ || boundary.type_ != bc_type)
+	{
+		std::cout << "Wrong BC type appears while record BC.\n";
+		return;
 	}
 
-	os << "BOTTOM BOUNDARY ------ \n";
-	for (auto i : BC.bottom_boundary_) {
-		os << "f[" << i.first << "] = ";
-		for (auto j : i.second)
-			os << j << ' ';
-		os << std::endl;
-	}
+	double * f[kQ];
+	for (int q = 0; q < kQ; ++q)
+		f[q] = (*f_ptr_)[q].Data();
 
-	os << "RIGHT BOUNDARY ------ \n";
-	for (auto i : BC.right_boundary_) {
-		os << "f[" << i.first << "] = ";
-		for (auto j : i.second)
-			os << j << ' ';
-		os << std::endl;
-	}
+	if (bc_type == BCType::VON_NEUMAN || bc_type == BCType::DIRICHLET)
+	{
+		// Known components are taken after streaming and recording of previous boundaries
+		GatherValues(boundary, f);
 
-	os << "LEFT BOUNDARY ------ \n";
-	for (auto i : BC.left_boundary_) {
-		os << "f[" << i.first << "] = ";
-		for (auto j : i.second)
-			os << j << ' ';
-		os << std::endl;
+		const std::vector<int> & mid_ids = (BC == Boundary::TOP || BC == Boundary::BOTTOM) ? mid_width_ids_ : mid_height_ids_;
+
+		if (bc_type == BCType::VON_NEUMAN)
+			CalculateVonNeumanBCValues(BC, boundary, mid_ids, GetIds(BC));
+		else
+			CalculateDirichletBCValues(BC, boundary, mid_ids, GetIds(BC));
 	}
 
-	return os;
+	ScatterValues(boundary, f);
 }
 
+void BCs::RecordValuesForAllBC(BCType const top_bc, BCType const bottm_bc, BCType const left_bc, BCType const right_bc)
+{
+	// Boundaries are recorded one after another, so values in corner nodes are taken from the last recorded boundary
+	RecordValuesOnSingleBC(Boundary::TOP, top_bc);
+	RecordValuesOnSingleBC(Boundary::BOTTOM, bottm_bc);
+	RecordValuesOnSingleBC(Boundary::LEFT, left_bc);
+	RecordValuesOnSingleBC(Boundary::RIGHT, right_bc);
+}
 
-#pragma endregion
-
-#pragma region 3d
 
-#include"../../math/array_func_impl.h"
+void BCs::PeriodicBC(Boundary const first, Boundary const second)
+{
+	// Stored values are recorded to the opposite boundary by links of PERIODIC type, so only boundaries are checked here
+	if (first == Boundary::LEFT && second == Boundary::RIGHT)
+		return;
+	else if (first == Boundary::TOP && second == Boundary::BOTTOM)
+		return;
+	else
+		throw;
+}
 
-BCs3D::BCs3D(int rows, int colls, DistributionFunction3D<double>& dfunc) :
-	height_(rows), length_(colls - 2), f_ptr_(&dfunc)
+void BCs::BounceBackBC(Boundary const first)
 {
-	
+	// Stored values are recorded to reflected directions by links of BOUNCE_BACK type
+	if (GetBoundary(first).type_ != BCType::BOUNCE_BACK)
+		std::cout << "Bounce back BC is applied to boundary, which values are prepared for other BC type.\n";
 }
 
-bool BCs3D::PrepareValuesForSingleBC(Boundary const BC, BCType const bc_type)
+void BCs::VonNeumannBC(Boundary const first, double const vx, double const vy)
 {
-	// Pointer to function, which gets appropriate values, bepending on wall type:
-	// for TOP : ptr to GetTopBoundaryValues, for BOTTOM ptr to GetBottomBoundaryValue
-	std::vector<double>(DistributionFunction3D<double>::*ptrToFunc)(int) const = nullptr;
+	BoundaryLinks & boundary = GetBoundary(first);
 
-	switch (BC)
+	if (boundary.type_ != BCType::VON_NEUMAN)
 	{
-	case Boundary::TOP:
-
-		// !!! VON NEUMANN IMPLEMENTATION PROCESS
-		ptrToFunc = &DistributionFunction3D<double>::GetTopBoundaryValues;
-
-		if(bc_type == BCType::BOUNCE_BACK || bc_type == BCType::PERIODIC)
-			return WriteBoundaryValues(bc_type, top_boundary_, top_ids_, ptrToFunc);
-		else if (bc_type == BCType::VON_NEUMAN)
-			return WriteVonNeumannBoundaryValues(bc_type, top_boundary_, middle_layer_ids_, top_ids_, ptrToFunc);
-		break;
-
-	case Boundary::BOTTOM:
-
-		ptrToFunc = &DistributionFunction3D<double>::GetBottomBoundaryValue;
-		return WriteBoundaryValues(bc_type, bottom_boundary_, bottom_ids_, ptrToFunc);
+		std::cout << "Von-Neumann BC is applied to boundary, which values are prepared for other BC type.\n";
+		return;
+	}
 
-		break;
+	boundary.vx_ = vx;
+	boundary.vy_ = vy;
+}
 
-	case Boundary::RIGHT:
+void BCs::DirichletBC(Boundary const first, double const rho_0)
+{
+	BoundaryLinks & boundary = GetBoundary(first);
 
-		ptrToFunc = &DistributionFunction3D<double>::GetRightBoundaryValue;
-		return WriteBoundaryValues(bc_type, right_boundary_, right_ids_, ptrToFunc);
+	if (boundary.type_ != BCType::DIRICHLET)
+	{
+		std::cout << "Dirichlet BC is applied to boundary, which values are prepared for other BC type.\n";
+		return;
+	}
 
-		break;
+	boundary.rho_ = rho_0;
+}
 
-	case Boundary::LEFT:
+void BCs::CalculateVonNeumanBCValues(Boundary const first, BoundaryLinks & boundary, const std::vector<int> & ids_1, const std::vector<int> & ids_2)
+{
+	const int size = boundary.size_;
+	const double vx = boundary.vx_;
+	const double vy = boundary.vy_;
 
-		ptrToFunc = &DistributionFunction3D<double>::GetLeftBoundaryValue;
-		return WriteBoundaryValues(bc_type, left_boundary_, left_ids_, ptrToFunc);
-		break;
+#pragma omp parallel for if(static_cast<int>(boundary.stored_.size()) > kParallelLinksNumber)
+	for (int i = 0; i < size; ++i)
+	{
+		// Density and temp for make calculations below easy to understand
+		double rho = 0.0;
+		double temp = 0.0;
 
-	case Boundary::CLOSE_IN:
+		// Start density calculation
+		for (auto id : ids_1)
+			rho = rho + boundary.Value(id, i);
+		for (auto id : ids_2)
+			rho = rho + boundary.Value(id, i) * 2.0;
 
-		ptrToFunc = &DistributionFunction3D<double>::GetNearBoundaryValue;
-		return WriteBoundaryValues(bc_type, near_boundary_, near_ids_, ptrToFunc);
-		break;
+		// Steps below depends on chosen boundary: 1. final density calculation and 2. necessary distribution function components calclulations
+		switch (first)
+		{
+		case Boundary::TOP:
+			rho = rho / (1.0 + vy);
 
-	case Boundary::FAAR:
+			boundary.Value(4, i) = boundary.Value(2, i) - 2.0 / 3.0 * rho * vy;
 
-		ptrToFunc = &DistributionFunction3D<double>::GetFarBoundaryValue;
-		return WriteBoundaryValues(bc_type, far_boundary_, far_ids_, ptrToFunc);
-		break;
+			temp = (boundary.Value(1, i) - boundary.Value(3, i)) / 2.0;
 
-	default:
-		std::cout << "Wrong Boundary type is used while prepair values for BC.\n";
-		return false;
-		break;
-	}
-}
+			boundary.Value(7, i) = boundary.Value(5, i) + temp - (vy / 6.0 + vx / 2.0) * rho;
+			boundary.Value(8, i) = boundary.Value(6, i) - temp - (vy / 6.0 - vx / 2.0) * rho;
+			break;
+		case Boundary::BOTTOM:
+			rho = rho / (1.0 - vy);
 
-bool BCs3D::WriteBoundaryValues(BCType const bc_type, std::map<int, std::vector<double> > & bc_boundary, const std::vector<int> & bc_ids, 
-	/* Pointer to function to distinguish GETTING boundaries: TOP, BOTTOM, e.t.c */ std::vector<double> (DistributionFunction3D<double>::*ptrToFunc)(int) const)
-{
-	if (bc_type == BCType::PERIODIC || bc_type == BCType::BOUNCE_BACK)
-	{
-		for (auto bc_id : bc_ids)
-			// Get appropriate values from probability distribution function (using APPROPRIATE function via ptr. to function) 
-			// and write them in appropriate class fields.
-			bc_boundary.insert(std::make_pair(bc_id, (*f_ptr_.*ptrToFunc)(bc_id)));
+			boundary.Value(2, i) = boundary.Value(4, i) + 2.0 / 3.0 * rho * vy;
 
-		return true;
+			temp = (boundary.Value(1, i) - boundary.Value(3, i)) / 2.0;
 
-	}
-	else if (bc_type == BCType::VON_NEUMAN)
-	{
-		std::cout << "Von Neumann BC are not implemented yet!\n";
+			boundary.Value(5, i) = boundary.Value(7, i) - temp + (vy / 6.0 + vx / 2.0) * rho;
+			boundary.Value(6, i) = boundary.Value(8, i) + temp + (vy / 6.0 - vx / 2.0) * rho;
+			break;
+		case Boundary::LEFT:
+			rho = rho / (1.0 - vx);
 
-		return false;
-		throw;
-	}
-	else
-	{
-		std::cout << "Wrond BC Type is used!\n";
-	}
-	return false;
-}
+			boundary.Value(1, i) = boundary.Value(3, i) + 2.0 / 3.0 * rho * vx;
 
-bool BCs3D::WriteVonNeumannBoundaryValues(BCType const bc_type, std::map<int, std::vector<double>>& bc_boundary, const std::vector<int>& bc_ids_1, const std::vector<int>& bc_ids_2, std::vector<double>(DistributionFunction3D<double>::* ptrToFunc)(int) const)
-{
-	if (bc_type == BCType::VON_NEUMAN)
-	{
-		// Idea: Get Values from first and second layers: for example for BOTTOM we need ALL distribution function from MIDDLE and TOP layers
-		// Get appropriate values from probability distribution function (using APPROPRIATE function via ptr. to function) 
-		// and write them in appropriate class fields.
+			temp = (boundary.Value(2, i) - boundary.Value(4, i)) / 2.0;
 
-		for (auto bc_id_1 : bc_ids_1)
-			bc_boundary.insert(std::make_pair(bc_id_1, (*f_ptr_.*ptrToFunc)(bc_id_1)));
-		for (auto bc_id_2 : bc_ids_2)
-			bc_boundary.insert(std::make_pair(bc_id_2, (*f_ptr_.*ptrToFunc)(bc_id_2)));
+			boundary.Value(5, i) = boundary.Value(7, i) - temp + (vx / 6.0 + vy / 2.0) * rho;
+			boundary.Value(8, i) = boundary.Value(6, i) + temp + (vx / 6.0 - vy / 2.0) * rho;
+			break;
+		case Boundary::RIGHT:
+			rho = rho / (1.0 + vx);
 
-		return true;
-	}
-	else
-	{
+			boundary.Value(3, i) = boundary.Value(1, i) - 2.0 / 3.0 * rho * vx;
 
-	}
-	return false;
-}
+			temp = (boundary.Value(2, i) - boundary.Value(4, i)) / 2.0;
 
-void BCs3D::PrepareValuesForAllBC(BCType const top_bc, BCType const bottm_bc, BCType const left_bc, BCType const right_bc, BCType const near_bc, BCType far_bc)
-{
-	if (PrepareValuesForSingleBC(Boundary::TOP, top_bc) &&
-		PrepareValuesForSingleBC(Boundary::BOTTOM, bottm_bc) &&
-		PrepareValuesForSingleBC(Boundary::LEFT, left_bc) &&
-		PrepareValuesForSingleBC(Boundary::RIGHT, right_bc) && 
-		PrepareValuesForSingleBC(Boundary::CLOSE_IN, near_bc) &&
-		PrepareValuesForSingleBC(Boundary::FAAR, far_bc) )
-	{
-		//      
-	}
-	else
-	{
-		std::cout << "Could not prepare values for all boundaries.\n";
-		throw;
+			boundary.Value(6, i) = boundary.Value(8, i) - temp - (vx / 6.0 - vy / 2.0) * rho;
+			boundary.Value(7, i) = boundary.Value(5, i) + temp - (vx / 6.0 + vy / 2.0) * rho;
+			break;
+		default:
+			break;
+		}
 	}
 }
 
-bool BCs3D::RecordValuesForSingleBC(Boundary const BC, BCType const bc_type)
+void BCs::CalculateDirichletBCValues(Boundary const first, BoundaryLinks & boundary, const std::vector<int> & ids_1, const std::vector<int> & ids_2)
 {
-	void(DistributionFunction3D<double>::*ptrToFunc)(int const, std::vector<double> const &) = nullptr;
+	const int size = boundary.size_;
+	const double rho_0 = boundary.rho_;
 
-	switch (BC)
+#pragma omp parallel for if(static_cast<int>(boundary.stored_.size()) > kParallelLinksNumber)
+	for (int i = 0; i < size; ++i)
 	{
-	case Boundary::TOP:
+		// Velocity and temp for make calculations below easy to understand
+		double v = 0.0;
+		double temp = 0.0;
 
-		if (bc_type == BCType::PERIODIC)
-		{
-			ptrToFunc = &DistributionFunction3D<double>::SetBottomBoundaryValue;
-			return RecordBoundaryValues(bc_type, bottom_boundary_, top_ids_, ptrToFunc);
-		}
-		else if (bc_type == BCType::BOUNCE_BACK)
-		{
-			ptrToFunc = &DistributionFunction3D<double>::SetTopBoundaryValue;
-			return RecordBoundaryValues(bc_type, top_boundary_, bottom_ids_, ptrToFunc);
-		}
-		else if (bc_type == BCType::VON_NEUMAN)
-		{
-			ptrToFunc = &DistributionFunction3D<double>::SetTopBoundaryValue;
-			return RecordBoundaryValues(bc_type, top_boundary_, bottom_ids_, ptrToFunc);
-		}
-		break;
+		// Start density calculation
+		for (auto id : ids_1)
+			v = v + boundary.Value(id, i);
+		for (auto id : ids_2)
+			v = v + boundary.Value(id, i) * 2.0;
 
-	case Boundary::BOTTOM:
+		// Steps below depends on chosen boundary: 1. final velocity calculation and 2. necessary distribution function components calclulations
+		if (first == Boundary::TOP || first == Boundary::RIGHT)
+			v = v / rho_0 - 1.0;
+		else
+			v = (v / rho_0) * -1.0 + 1.0;
 
-		if (bc_type == BCType::PERIODIC)
-		{
-			ptrToFunc = &DistributionFunction3D<double>::SetTopBoundaryValue;
-			return RecordBoundaryValues(bc_type, top_boundary_, bottom_ids_, ptrToFunc);
-
-		}
-		else if (bc_type == BCType::BOUNCE_BACK)
-		{
-			ptrToFunc = &DistributionFunction3D<double>::SetBottomBoundaryValue;
-			return RecordBoundaryValues(bc_type, bottom_boundary_, top_ids_, ptrToFunc);
-		}
-		break;
-
-	case Boundary::RIGHT:
+		// Set the velocity of first and last elements to zero, because this is boundary
+		if (i == 0 || i == size - 1)
+			v = 0.0;
 
-		if (bc_type == BCType::PERIODIC)
-		{
-			ptrToFunc = &DistributionFunction3D<double>::SetLeftBoundaryValue;
-			return RecordBoundaryValues(bc_type, left_boundary_, right_ids_, ptrToFunc);
-		}
-		else if (bc_type == BCType::BOUNCE_BACK)
+		switch (first)
 		{
-			ptrToFunc = &DistributionFunction3D<double>::SetRightBoundaryValue;
-			return RecordBoundaryValues(bc_type, right_boundary_, left_ids_, ptrToFunc);
-		}
+		case Boundary::TOP:
+			boundary.Value(4, i) = boundary.Value(2, i) - 2.0 / 3.0 * rho_0 * v;
 
-		break;
+			temp = (boundary.Value(1, i) - boundary.Value(3, i)) / 2.0;
 
-	case Boundary::LEFT:
+			boundary.Value(7, i) = boundary.Value(5, i) + temp - (rho_0 / 6.0) * v;
+			boundary.Value(8, i) = boundary.Value(6, i) - temp - (rho_0 / 6.0) * v;
+			break;
+		case Boundary::BOTTOM:
+			boundary.Value(2, i) = boundary.Value(4, i) + 2.0 / 3.0 * rho_0 * v;
 
-		if (bc_type == BCType::PERIODIC)
-		{
-			ptrToFunc = &DistributionFunction3D<double>::SetRightBoundaryValue;
-			return RecordBoundaryValues(bc_type, right_boundary_, left_ids_, ptrToFunc);
-		}
-		else if (bc_type == BCType::BOUNCE_BACK)
-		{
-			ptrToFunc = &DistributionFunction3D<double>::SetLeftBoundaryValue;
-			return RecordBoundaryValues(bc_type, left_boundary_, right_ids_, ptrToFunc);
-		}
-		break;
+			temp = (boundary.Value(1, i) - boundary.Value(3, i)) / 2.0;
 
-	case Boundary::CLOSE_IN:
+			boundary.Value(5, i) = boundary.Value(7, i) - temp + (rho_0 / 6.0) * v;
+			boundary.Value(6, i) = boundary.Value(8, i) + temp + (rho_0 / 6.0) * v;
+			break;
+		case Boundary::LEFT:
+			boundary.Value(1, i) = boundary.Value(3, i) + 2.0 / 3.0 * rho_0 * v;
 
-		if (bc_type == BCType::PERIODIC)
-		{
-			ptrToFunc = &DistributionFunction3D<double>::SetFarBoundaryValue;
-			return RecordBoundaryValues(bc_type, far_boundary_, near_ids_, ptrToFunc);
+			temp = (boundary.Value(2, i) - boundary.Value(4, i)) / 2.0;
 
-		}
-		else if (bc_type == BCType::BOUNCE_BACK)
-		{
-			ptrToFunc = &DistributionFunction3D<double>::SetNearBoundaryValue;
-			return RecordBoundaryValues(bc_type, near_boundary_, far_ids_, ptrToFunc);
-		}
-		break;
+			boundary.Value(5, i) = boundary.Value(7, i) - temp + (rho_0 / 6.0) * v;
+			boundary.Value(8, i) = boundary.Value(6, i) + temp + (rho_0 / 6.0) * v;
+			break;
+		case Boundary::RIGHT:
+			boundary.Value(3, i) = boundary.Value(1, i) - 2.0 / 3.0 * rho_0 * v;
 
-	case Boundary::FAAR:
+			temp = (boundary.Value(2, i) - boundary.Value(4, i)) / 2.0;
 
-		if (bc_type == BCType::PERIODIC)
-		{
-			ptrToFunc = &DistributionFunction3D<double>::SetNearBoundaryValue;
-			return RecordBoundaryValues(bc_type, near_boundary_, far_ids_, ptrToFunc);
-		}
-		else if (bc_type == BCType::BOUNCE_BACK)
-		{
-			ptrToFunc = &DistributionFunction3D<double>::SetFarBoundaryValue;
-			return RecordBoundaryValues(bc_type, far_boundary_, near_ids_, ptrToFunc);
+			boundary.Value(6, i) = boundary.Value(8, i) - temp - (rho_0 / 6.0) * v;
+			boundary.Value(7, i) = boundary.Value(5, i) + temp - (rho_0 / 6.0) * v;
+			break;
+		default:
+			break;
 		}
-		break;
-
-	default:
-		std::cout << "Wrong Boundary type is used while prepair values for BC.\n";
-		return false;
-		break;
 	}
 }
 
-bool BCs3D::RecordBoundaryValues(BCType const bc_type, std::map<int, std::vector<double>>& bc_boundary, const std::vector<int>& bc_ids, 
-	/* Pointer to function to distinguish GETTING boundaries: TOP, BOTTOM, e.t.c */ void(DistributionFunction3D<double>::* ptrToFunc)(int const, std::vector<double> const &))
+std::ostream & operator<<(std::ostream & os, BCs const & BC)
 {
-	if (bc_type == BCType::PERIODIC || bc_type == BCType::BOUNCE_BACK)
-	{
-		for (auto bc_id : bc_ids)
-		{
-			auto f_id = bc_boundary.find(bc_id);
-			(*f_ptr_.*ptrToFunc)(f_id->first, f_id->second);
-		}
-		return true;
-	}
-	else if (bc_type == BCType::VON_NEUMAN)
-	{
-		// !!! In testing mode
-		for (auto bc_id : bc_ids)
-		{
-			auto f_id = bc_boundary.find(bc_id);
-			(*f_ptr_.*ptrToFunc)(f_id->first, f_id->second);
-		}
-		return true;
-	}
-	else
-	{
-		std::cout << "Wrong BC Type is used!\n";
-	}
-	return false;
-}
+	os.precision(3);
 
+	os << "TOP BOUNDARY ------ \n" << BC.top_boundary_;
+	os << "BOTTOM BOUNDARY ------ \n" << BC.bottom_boundary_;
+	os << "RIGHT BOUNDARY ------ \n" << BC.right_boundary_;
+	os << "LEFT BOUNDARY ------ \n" << BC.left_boundary_;
 
-void BCs3D::RecordValuesForAllBC(BCType const top_bc, BCType const bottm_bc, BCType const left_bc, BCType const right_bc, BCType const near_bc, BCType far_bc)
-{
-	if (RecordValuesForSingleBC(Boundary::TOP, top_bc) &&
-		RecordValuesForSingleBC(Boundary::BOTTOM, bottm_bc) &&
-		RecordValuesForSingleBC(Boundary::LEFT, left_bc) &&
-		RecordValuesForSingleBC(Boundary::RIGHT, right_bc) &&
-		RecordValuesForSingleBC(Boundary::CLOSE_IN, near_bc) &&
-		RecordValuesForSingleBC(Boundary::FAAR, far_bc))
-	{
-		f_ptr_->ClearBoundaries();
-	}
-	else
-	{
-		std::cout << "Could not record values for all boundaries.\n";
-		throw;
-	}
-
-	
+	return os;
 }
 
-void BCs3D::PeriodicBC(Boundary const first, Boundary const second)
-{
-	if (first == Boundary::LEFT && second == Boundary::RIGHT)
-		left_boundary_.swap(right_boundary_);
-	else if (first == Boundary::TOP && second == Boundary::BOTTOM)
-		top_boundary_.swap(bottom_boundary_);
-	else if (first == Boundary::CLOSE_IN && second == Boundary::FAAR)
-		near_boundary_.swap(far_boundary_);
-	else
-	{
-		std::cout << "Check parameters in PeriodicBC function.\n";
-		throw;
-	}	
-}
 
-void BCs3D::BounceBackBC(Boundary const first)
+void BodyBCs::Build(Medium const & medium)
 {
-	if (first == Boundary::TOP) 
-	{
-		SwapIds(top_boundary_, 9, 14);
-		SwapIds(top_boundary_, 10, 17);
-		SwapIds(top_boundary_, 11, 18);
-		SwapIds(top_boundary_, 12, 15);
-		SwapIds(top_boundary_, 13, 16);
-	}
-	else if (first == Boundary::BOTTOM) 
-	{
-		SwapIds(bottom_boundary_, 14, 9);
-		SwapIds(bottom_boundary_, 15, 12);
-		SwapIds(bottom_boundary_, 16, 13);
-		SwapIds(bottom_boundary_, 17, 10);
-		SwapIds(bottom_boundary_, 18, 11);
-	}
-	else if (first == Boundary::LEFT) 
-	{
-		SwapIds(left_boundary_, 3, 1);
-		SwapIds(left_boundary_, 6, 8);
-		SwapIds(left_boundary_, 7, 5);
-		SwapIds(left_boundary_, 12, 15);
-		SwapIds(left_boundary_, 17, 10);
-	}
-	else if (first == Boundary::RIGHT) 
-	{
-		SwapIds(right_boundary_, 1, 3);
-		SwapIds(right_boundary_, 5, 7);
-		SwapIds(right_boundary_, 8, 6);
-		SwapIds(right_boundary_, 10, 17);
-		SwapIds(right_boundary_, 15, 12);
-	}
-	else if (first == Boundary::CLOSE_IN)
-	{
-		SwapIds(near_boundary_, 4, 2);
-		SwapIds(near_boundary_, 7, 5);
-		SwapIds(near_boundary_, 8, 6);
-		SwapIds(near_boundary_, 13, 16);
-		SwapIds(near_boundary_, 18, 11);
-	}
-	else if (first == Boundary::FAAR)
+	const int rows = static_cast<int>(medium.size().first);
+	const int colls = static_cast<int>(medium.size().second);
+
+	links_.clear();
+
+	for (int y = 1; y < rows - 1; ++y)
 	{
-		SwapIds(far_boundary_, 2, 4);
-		SwapIds(far_boundary_, 5, 7);
-		SwapIds(far_boundary_, 6, 8);
-		SwapIds(far_boundary_, 11, 18);
-		SwapIds(far_boundary_, 16, 13);
+		for (int x = 1; x < colls - 1; ++x)
+		{
+			if (medium.Get(y, x) != NodeType::BODY_IN_FLUID)
+				continue;
+
+			// Component 'q' comes to the body node from the upstream neighbour, only fluid neighbours stream
+			for (int q = 1; q < kQ; ++q)
+			{
+				const int y_from = y + static_cast<int>(D2Q9::kEy[q]);
+				const int x_from = x - static_cast<int>(D2Q9::kEx[q]);
+
+				if (medium.is_fluid(y_from, x_from))
+					links_.push_back(BodyLink{ q, y * colls + x, y_from * colls + x_from });
+			}
+		}
 	}
+
+	values_.assign(links_.size(), 0.0);
 }
 
-void BCs3D::VonNeumannBC(Boundary const first, const double vx, const double vy, const double vz)
+void BodyBCs::PrepareValues(DistributionFunction<double> & f)
 {
-	if (first == Boundary::TOP)
-	{
-		typedef std::vector< std::pair<int, std::vector<double>>> VectorOfPairs;
-
-		// Copy from map to vector for easy work
-		const int size = top_boundary_.begin()->second.size();
-		std::vector<double> rho(size, 0.0);
-		// >>> Calculate rho
-		for (auto middleId : middle_layer_ids_)
-			rho = rho + top_boundary_.at(middleId);
-
-		for (auto topId : top_ids_)
-				rho = rho + top_boundary_.at(topId) * 2.0;
-			
-		rho = rho / (1.0 + vz);
-		// >>>
-		
-
-		// >>> Calculate  coefs N
-		std::vector<double> Nxz(size, 0.0);
-		Nxz = 0.5 * (top_boundary_.at(1) + top_boundary_.at(5) + top_boundary_.at(8) - (top_boundary_.at(3) + top_boundary_.at(6) + top_boundary_.at(7))) - 1.0 / 3.0 * rho * vx;
-
-		std::vector<double> Nyz(size, 0.0);
-		Nyz = 0.5 * (top_boundary_.at(2) + top_boundary_.at(5) + top_boundary_.at(6) - (top_boundary_.at(4) + top_boundary_.at(7) + top_boundary_.at(8))) - 1.0 / 3.0 * rho * vy;
+	const int links_number = static_cast<int>(links_.size());
+	BodyLink const * links = links_.data();
+	double * values = values_.data();
 
-		// >>>
+	double * f_ptr[kQ];
+	for (int q = 0; q < kQ; ++q)
+		f_ptr[q] = f[q].Data();
 
-		auto f14 = top_boundary_.at(9) - 1.0 / 3.0 * rho * vz;
-		auto f15 = top_boundary_.at(12) + rho / 6.0 *(-vz + vx) - Nxz;
-		auto f17 = top_boundary_.at(10) + rho / 6.0 *(-vz - vx) + Nxz;
-		auto f16 = top_boundary_.at(13) + rho / 6.0 *(-vz + vx) - Nyz; // May be change signs
-		auto f18 = top_boundary_.at(11) + rho / 6.0 *(-vz - vx) + Nyz; // May be change signs
-
-		top_boundary_.clear();
-		top_boundary_.insert(std::make_pair(14, f14));
-		top_boundary_.insert(std::make_pair(15, f15));
-		top_boundary_.insert(std::make_pair(16, f16));
-		top_boundary_.insert(std::make_pair(17, f17));
-		top_boundary_.insert(std::make_pair(18, f18));
-	}
-	else
+#pragma omp parallel for if(links_number > kParallelLinksNumber)
+	for (int i = 0; i < links_number; ++i)
 	{
-		std::cout << "Is not implemented yet!";
-		throw;
+		values[i] = f_ptr[links[i].q_][links[i].solid_];
+		f_ptr[links[i].q_][links[i].solid_] = 0.0;
 	}
 }
 
-void BCs3D::SwapIds(std::map<int, std::vector<double>>& map, int const from, int const to)
+void BodyBCs::RecordValues(DistributionFunction<double> & f) const
 {
-	std::vector<double> temp;
-	auto iter = map.find(from);
-	temp.swap(iter->second);
-	map.erase(iter);
-	map.insert(std::make_pair(to, temp));
+	const int links_number = static_cast<int>(links_.size());
+	BodyLink const * links = links_.data();
+	double const * values = values_.data();
+
+	double * f_ptr[kQ];
+	for (int q = 0; q < kQ; ++q)
+		f_ptr[q] = f[q].Data();
+
+	// Each fluid node gets each component from one body node at most, so links could be written in any order
+#pragma omp parallel for if(links_number > kParallelLinksNumber)
+	for (int i = 0; i < links_number; ++i)
+		f_ptr[D2Q9::kOpposite[links[i].q_]][links[i].fluid_] = values[i];
 }
 
-#pragma endregion
\ No newline at end of file
+
+#pragma endregion
@@ -1,9 +1,9 @@
 #pragma once
 
 #include<memory>
-#include<map>
 
 #include"../../modeling_area/fluid.h"
+#include"../lattice.h"
 
 //! SmartPoiner to DistriputionFunction
 typedef std::unique_ptr<DistributionFunction<double>> distr_func_ptr;
@@ -33,8 +33,57 @@ enum class Boundary {
 	1. Store all necessary probability distribution function values on chosen boundary before STREAMING.
 	2. Change this values depending on choosen BC type : Periodic, Bounce Back, e.t.c.
 	3. Record this values to an appropriate probability distribution functions values
+
+	Von Neumann and Dirichlet BCs need components, which are known after streaming, so their values are taken and
+	calculated on step 3, after previous boundaries are recorded (it matters in corner nodes).
+
+	Nodes and components of each boundary are not searched every step: they are listed once (when BC type of boundary
+	is set or changed) as flat lists of links, so steps 1 and 3 are single passes over these lists without allocations.
 */
 
+//! Link of boundary: component 'q_' of distribution function in node 'node_' (index of node in matrix body)
+struct BoundaryLink
+{
+	int q_;
+	int node_;
+};
+
+//! Links of one boundary, which are built for its BC type.
+//! Value of the i-th 'recorded_' link is taken from 'values_' at position 'recorded_first_' + i: it is the value of the i-th
+//! 'stored_' link, gathered before streaming, for Periodic and Bounce Back BCs and the i-th value, calculated from 'stored_'
+//! links after streaming, for Von Neumann and Dirichlet BCs
+struct BoundaryLinks
+{
+	//! BC type, for which links are built
+	BCType type_;
+	//! Is links built
+	bool is_built_{ false };
+	//! Number of nodes of boundary
+	int size_{ 0 };
+
+	//! Links, which values are stored before streaming
+	std::vector<BoundaryLink> stored_;
+	//! Links, which are written after streaming
+	std::vector<BoundaryLink> recorded_;
+	//! Position of value of the first recorded link in 'values_'
+	int recorded_first_{ 0 };
+
+	//! Stored and calculated values: values of component q in nodes of boundary start from 'offset_[q]' (-1 if there are no values of q)
+	std::vector<double> values_;
+	std::vector<int> offset_;
+
+	//! Velocity of Von Neumann BC and density of Dirichlet BC
+	double vx_{ 0.0 };
+	double vy_{ 0.0 };
+	double rho_{ 1.0 };
+
+	//! Returns value of component 'q' in the 'i'-th node of boundary
+	double & Value(int const q, int const i) { return values_[offset_[q] + i]; }
+};
+
+//! Writes stored values of each component of boundary
+std::ostream & operator<<(std::ostream & os, BoundaryLinks const & boundary);
+
 #pragma region 2d
 
 class BCs
@@ -58,10 +107,10 @@ public:
 	void PeriodicBC(Boundary const first, Boundary const second);
 	//! Applies bounce back boundary conditions
 	void BounceBackBC(Boundary const first);
-	//! Applies Von-Neumann boundary conditions
-	void VonNeumannBC(Boundary const first, Fluid & fluid, double const vx, double const vy);
-	//! Applies Dirichlet boundary conditions
-	void DirichletBC(Boundary const first, Fluid & fluid, double const rho_0);
+	//! Applies Von-Neumann boundary conditions (values are calculated from known components after streaming, when boundary is recorded)
+	void VonNeumannBC(Boundary const first, double const vx, double const vy);
+	//! Applies Dirichlet boundary conditions (values are calculated from known components after streaming, when boundary is recorded)
+	void DirichletBC(Boundary const first, double const rho_0);
 
 	friend std::ostream & operator<<(std::ostream & os, BCs const & BC);
 
@@ -73,268 +122,99 @@ public:
 		b = a;
 	}
 
-	void PrepareAdditionalBCs(Medium & medium)
-	{
-		for (int q = 0; q < kQ; ++q)
-		{
-			std::vector<ImmersedBodyVal> v;
-
-			for (int y = 1; y < f_ptr_->size().first - 1; ++y)
-			{
-				for (int x = 1; x < f_ptr_->size().second - 1; ++x)
-				{
-					if (medium.Get(y, x) == NodeType::BODY_IN_FLUID && f_ptr_->Get(q, y, x) != 0.0)
-					{
-						v.push_back(ImmersedBodyVal(y, x, f_ptr_->Get(q, y, x)));
-						f_ptr_->Set(q, y, x, 0.0);
-					}
-				}
-			}
-
-			additionalBCs.insert(std::make_pair(q, v));
-		}
-
-		/*for (auto i : additionalBCs)
-		{
-			std::cout << i.first << " : ";
-			for (auto j : i.second)
-				std::cout << j.distrFuncValue_ << "(" << j.y_ << " , " << j.x_ << ") ";
-			std::cout << std::endl;
-		}*/
-	}
-
-	void AdditionalBounceBackBCs()
-	{
-		std::swap(additionalBCs.at(1), additionalBCs.at(3));
-		std::swap(additionalBCs.at(2), additionalBCs.at(4));
-		std::swap(additionalBCs.at(5), additionalBCs.at(7));
-		std::swap(additionalBCs.at(6), additionalBCs.at(8));
-
-		/*for (auto i : additionalBCs)
-		{
-			std::cout << i.first << " : ";
-			for (auto j : i.second)
-				std::cout << j.distrFuncValue_ << "(" << j.y_ << " , " << j.x_ << ") ";
-			std::cout << std::endl;
-		}*/
-	}
-
-	void RecordAdditionalBCs()
-	{
-		for (auto row : additionalBCs)
-		{
-			for (auto j : row.second)
-				f_ptr_->Set(row.first, j.y_ + ey[row.first], j.x_ + ex[row.first], j.distrFuncValue_);
-		}
-		additionalBCs.clear();
-	}
-
-
 private:
 
 	//! Prepare values for CHOOSEN ONE BC BEFORE Streaming
 	bool PrepareValuesForSingleBC(Boundary const BC, BCType const boundary_condition_type);
-	//! Writes a single distribution function components to an appropriate class field
-	bool WriteBoundaryValues(BCType const bc_type, std::map<int, std::vector<double> > & bc_boundary, const std::vector<int> & bc_ids, std::vector<double>(DistributionFunction<double>::*ptrToFunc)(int)const);
-	bool WriteVonNeumannBoundaryValues(BCType const bc_type, std::map<int, std::vector<double> > & bc_boundary, const std::vector<int> & bc_ids_1, const std::vector<int> & bc_ids_2, std::vector<double>(DistributionFunction<double>::*ptrToFunc)(int)const);
-
-
 	//! Record values for choosen ONE BC AFTER Streaming (BC applying itself)
 	void RecordValuesOnSingleBC(Boundary const BC, BCType const boundary_condition_type);
-	//! Records a single component distribution function component boundary to appropriate boundary of distribution function
-	bool RecordBoundaryValues(BCType const bc_type, std::map<int, std::vector<double> > & bc_boundary, const std::vector<int> & bc_ids, void(DistributionFunction<double>::* ptrToFunc)(int const, std::vector<double> const &));
 
-	//! Swap two stored boundary values
-	void SwapId(std::map<int, std::vector<double> > & map, int const from, int const to);
+	//! Builds links of boundary 'BC' for BC type 'bc_type'. Returns false if BC type is not supported on this boundary
+	bool BuildLinks(Boundary const BC, BCType const bc_type);
+	//! Returns indexes of nodes of boundary 'BC' (full rows for TOP and BOTTOM, columns without the first and the last rows for LEFT and RIGHT)
+	std::vector<int> GetBoundaryNodes(Boundary const BC) const;
+	//! Returns links of boundary 'BC'
+	BoundaryLinks & GetBoundary(Boundary const BC);
+
 
+	//! Returns ids of directions, which come to the boundary 'BC'
+	const std::vector<int> & GetIds(Boundary const BC) const;
 	
 	//! Directly calculate all distribution function components for choosen boundary
-	void CalculateVonNeumanBCValues(Boundary const first, const int size, std::map<int, std::vector<double>> & boundary,
-		/* Ids of disr. functions are necessary for calculations: example for top ew need {0,1,3} and {2,5,6} */const std::vector<int> ids_1, const std::vector<int> ids_2,
-		double const vx, double const vy);
+	void CalculateVonNeumanBCValues(Boundary const first, BoundaryLinks & boundary,
+		/* Ids of disr. functions are necessary for calculations: example for top ew need {0,1,3} and {2,5,6} */const std::vector<int> & ids_1, const std::vector<int> & ids_2);
 
 	//! Directly calculate all distribution function components for choosen boundary
-	void CalculateDirichletBCValues(Boundary const first, const int size, std::map<int, std::vector<double>> & boundary,
-		/* Ids of disr. functions are necessary for calculations: example for top ew need {0,1,3} and {2,5,6} */const std::vector<int> ids_1, const std::vector<int> ids_2,
-		double const rho_0);
+	void CalculateDirichletBCValues(Boundary const first, BoundaryLinks & boundary,
+		/* Ids of disr. functions are necessary for calculations: example for top ew need {0,1,3} and {2,5,6} */const std::vector<int> & ids_1, const std::vector<int> & ids_2);
 
 private:
 
-	//! Ids of approppriate boundaries
-	const std::vector<int> top_ids_{ 2,5,6 };
-	const std::vector<int> bottom_ids_{ 4,7,8 };
-	const std::vector<int> left_ids_{ 3,6,7 };
-	const std::vector<int> right_ids_{ 1,5,8 };
+	//! Ids of approppriate boundaries: { 2,5,6 }, { 4,7,8 }, { 3,6,7 } and { 1,5,8 } (directions, which come to the boundary)
+	const std::vector<int> top_ids_ = LatticeDirections<D2Q9>(Axis::Y, 1);
+	const std::vector<int> bottom_ids_ = LatticeDirections<D2Q9>(Axis::Y, -1);
+	const std::vector<int> left_ids_ = LatticeDirections<D2Q9>(Axis::X, -1);
+	const std::vector<int> right_ids_ = LatticeDirections<D2Q9>(Axis::X, 1);
 
-	//! Ids of boundaries for Von-Neumann BCs
-	const std::vector<int> mid_height_ids_{ 0,2,4 };
-	const std::vector<int> mid_width_ids_{ 0,1,3 };
+	//! Ids of boundaries for Von-Neumann BCs: { 0,2,4 } and { 0,1,3 } (directions, which are parallel to the boundary)
+	const std::vector<int> mid_height_ids_ = LatticeDirections<D2Q9>(Axis::X, 0);
+	const std::vector<int> mid_width_ids_ = LatticeDirections<D2Q9>(Axis::Y, 0);
 
 	//! Poiner to Fluid distribution function to work with it's boundaries (   )
 	DistributionFunction<double>* f_ptr_;
 
-	//! Store index of probability distribution function and it's values on TOP boundary
-	//!	Example: top_boundary_[1] = { Store values f[1] on top boundary }
-	std::map<int, std::vector<double> > top_boundary_;
-	std::map<int, std::vector<double> > bottom_boundary_;
-	std::map<int, std::vector<double> > left_boundary_;	
-	std::map<int, std::vector<double> > right_boundary_;
-
-
-	// for additional BCs
-
-	struct ImmersedBodyVal
-	{
-		
-		int y_;
-		int x_;
-
-		double distrFuncValue_;
-
-		ImmersedBodyVal(int y, int x, double value) : y_(y), x_(x), distrFuncValue_(value) {}
-	};
-
-	typedef std::map<int, std::vector<ImmersedBodyVal> > VectorOfMap;
-
-	VectorOfMap additionalBCs;
+	//! Links and stored values of each boundary
+	//!	Example: top_boundary_.Value(1, x) = { Stored value f[1] in node x of top boundary }
+	BoundaryLinks top_boundary_;
+	BoundaryLinks bottom_boundary_;
+	BoundaryLinks left_boundary_;
+	BoundaryLinks right_boundary_;
 
 };
 
-#pragma endregion
-
 
-#pragma region 3d
+/*!
+	Halfway bounce back on bodies in fluid (nodes NodeType::BODY_IN_FLUID).
 
+	Only fluid nodes stream, so after streaming body node gets components only from its fluid neighbours. Each of these
+	components is taken from the body node (the node is cleared) and, after boundaries are recorded, is returned to the fluid
+	node it came from in the opposite direction.
 
-// Class of 3D boundary conditions:
-// - Calculate and apply choosen boundary condidtions to each boundary of modeling fluid domain.
+	Links between body and fluid nodes are listed once from Medium (Build() should be called if medium is changed), so
+	each step takes time in proportion to the wetted surface of bodies instead of the area of modeling area.
+*/
 
-class BCs3D
+//! Link between body node and fluid node: component 'q_' comes to body node 'solid_' from fluid node 'fluid_' (indexes of nodes in matrix body)
+struct BodyLink
 {
-	friend class Fluid;
+	int q_;
+	int solid_;
+	int fluid_;
+};
 
+class BodyBCs
+{
 public:
+	BodyBCs() {}
+	explicit BodyBCs(Medium const & medium) { Build(medium); }
+	~BodyBCs() {}
 
-	BCs3D(int rows, int colls, DistributionFunction3D<double> & dfunc);
-	~BCs3D() {}
-
-	//! Prepare ALL values for choosen BC BEFORE Streaming
-	void PrepareValuesForAllBC(BCType const top_bc, BCType const bottm_bc, BCType const left_bc, BCType const right_bc, BCType const near_bc, BCType far_bc);
-	//! Record ALL values for choosen BC AFTER Streaming (BC applying itself)
-	void RecordValuesForAllBC(BCType const top_bc, BCType const bottm_bc, BCType const left_bc, BCType const right_bc, BCType const near_bc, BCType far_bc);
-	
-	
-	//! Applies periodic boundary conditions
-	void PeriodicBC(Boundary const first, Boundary const second);
-	//! Applies bounce back boundary conditions
-	void BounceBackBC(Boundary const first);
+	//! Rebuilds links for 'medium' (should be called if medium is changed)
+	void Build(Medium const & medium);
 
-	void VonNeumannBC(Boundary const first, const double vx = 0.0, const double vy = 0.0, const double vz = 0.0);
+	//! Returns number of links between body and fluid nodes
+	int GetLinksNumber() const { return static_cast<int>(links_.size()); }
 
-	friend std::ostream & operator<<(std::ostream & os, BCs3D const & BC)
-	{
-		os.precision(3);
-
-		os << "TOP BOUNDARY ------ \n";
-		for (auto i : BC.top_boundary_) {
-			os << "f[" << i.first << "] = ";
-			for (auto j : i.second)
-				os << j << ' ';
-			os << std::endl;
-		}
-
-		os << "BOTTOM BOUNDARY ------ \n";
-		for (auto i : BC.bottom_boundary_) {
-			os << "f[" << i.first << "] = ";
-			for (auto j : i.second)
-				os << j << ' ';
-			os << std::endl;
-		}
-
-		os << "RIGHT BOUNDARY ------ \n";
-		for (auto i : BC.right_boundary_) {
-			os << "f[" << i.first << "] = ";
-			for (auto j : i.second)
-				os << j << ' ';
-			os << std::endl;
-		}
-
-		os << "LEFT BOUNDARY ------ \n";
-		for (auto i : BC.left_boundary_) {
-			os << "f[" << i.first << "] = ";
-			for (auto j : i.second)
-				os << j << ' ';
-			os << std::endl;
-		}
-
-		os << "NEAR BOUNDARY ------ \n";
-		for (auto i : BC.near_boundary_) {
-			os << "f[" << i.first << "] = ";
-			for (auto j : i.second)
-				os << j << ' ';
-			os << std::endl;
-		}
-
-		os << "FAR BOUNDARY ------ \n";
-		for (auto i : BC.far_boundary_) {
-			os << "f[" << i.first << "] = ";
-			for (auto j : i.second)
-				os << j << ' ';
-			os << std::endl;
-		}
-
-		return os;
-	}
+	//! Takes components, which came to body nodes during streaming, and clears them (after streaming)
+	void PrepareValues(DistributionFunction<double> & f);
+	//! Returns taken components to fluid nodes in opposite directions (after boundaries are recorded)
+	void RecordValues(DistributionFunction<double> & f) const;
 
 private:
-
-	//! Prepare values for CHOOSEN ONE BC BEFORE Streaming
-	bool PrepareValuesForSingleBC(Boundary const BC, BCType const bc_type);
-	//! Writes a single distribution function components to an appropriate class field
-	bool WriteBoundaryValues(BCType const bc_type, std::map<int, std::vector<double> > & bc_boundary, const std::vector<int> & bc_ids, std::vector<double>(DistributionFunction3D<double>::*ptrToFunc)(int)const);
-	bool WriteVonNeumannBoundaryValues(BCType const bc_type, std::map<int, std::vector<double> > & bc_boundary, const std::vector<int> & bc_ids_1, const std::vector<int> & bc_ids_2, std::vector<double>(DistributionFunction3D<double>::*ptrToFunc)(int)const);
-
-
-	//! Record values for choosen ONE BC AFTER Streaming (BC applying itself)
-	bool RecordValuesForSingleBC(Boundary const BC, BCType const boundary_condition_type);
-	//! Records a single component distribution function component boundary to appropriate boundary of distribution function
-	bool RecordBoundaryValues(BCType const bc_type, std::map<int, std::vector<double> > & bc_boundary, const std::vector<int> & bc_ids, void(DistributionFunction3D<double>::* ptrToFunc)(int const, std::vector<double> const &));
-
-	//! Swap two stored boundary values
-	void SwapIds(std::map<int, std::vector<double> > & map, int const from, int const to);
-
-private:
-
-	//! Indexes of velocity components on appropriate boundaries
-	const std::vector<int> top_ids_{ 9,10,11,12,13 };
-	const std::vector<int> bottom_ids_{ 14,15,16,17,18 };
-	const std::vector<int> left_ids_{ 3,6,7,12,17 };
-	const std::vector<int> right_ids_{ 1,5,8,10,15 };
-	const std::vector<int> near_ids_{ 4,7,8,13,18 };
-	const std::vector<int> far_ids_{ 2,5,6,11,16 };
-	
-	// For Von Neumann BC
-	const std::vector<int> middle_layer_ids_{ 0,1,2,3,4,5,6,7,8 };
-
-	// !!!   -   !!!
-
-	//! Columns height [equal to colls_ - 2 of matrix] because UP and DOWN nodes are already counted in TOP and BOTTOM BC
-	unsigned height_;
-	//! Rows length [equal to rows_ of matrix]  beacuse all nodes takes placr in BC
-	unsigned length_;
-	
-
-	//! Poiner to Fluid distribution function to work with it's boundaries (   )
-	DistributionFunction3D<double>* f_ptr_;
-
-	//! Store index of probability distribution function and it's values on TOP boundary
-	//!	Example: top_boundary_[1] = { Store values f[1] on top boundary }
-	std::map<int, std::vector<double> > top_boundary_;
-	std::map<int, std::vector<double> > bottom_boundary_;
-	std::map<int, std::vector<double> > left_boundary_;
-	std::map<int, std::vector<double> > right_boundary_;
-	std::map<int, std::vector<double> > near_boundary_;
-	std::map<int, std::vector<double> > far_boundary_;
+	//! Links between body and fluid nodes
+	std::vector<BodyLink> links_;
+	//! Components, taken from body nodes (one value per link)
+	std::vector<double> values_;
 };
 
-#pragma endregion
\ No newline at end of file
+#pragma endregion
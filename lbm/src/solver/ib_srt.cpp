@@ -24,7 +24,8 @@ IBSolver::IBSolver(double tau, Fluid & fluid, Medium & medium, std::unique_ptr<I
 	fx_ = std::make_unique<Matrix2D<double>>(rows, colls);
 	fy_ = std::make_unique<Matrix2D<double>>(rows, colls);
 
-	force_member_.resize(kQ, 0.0);
+	checkpoint_interval_ = 0;
+	start_iter_ = 0;
 }
 
 IBSolver::IBSolver(double tau, Fluid & fluid, Medium & medium, std::vector<ImmersedBody*> bodies) : tau_(tau)
@@ -46,72 +47,103 @@ IBSolver::IBSolver(double tau, Fluid & fluid, Medium & medium, std::vector<Immer
 	for (const auto& e : bodies)
 		im_bodies_.push_back(bodies.at(i++));
 
+	// Nodes of all bodies are moved to one set, so they are processed by one pass
+	markers_ = std::make_shared<IBMarkers>();
+	for (auto body : im_bodies_)
+		body->AttachTo(markers_);
+
 	int rows = fluid_->size().first;
 	int colls = fluid_->size().second;
 
 	fx_ = std::make_unique<Matrix2D<double>>(rows, colls);
 	fy_ = std::make_unique<Matrix2D<double>>(rows, colls);
 
-	force_member_.resize(kQ, 0.0);
+	checkpoint_interval_ = 0;
+	start_iter_ = 0;
 }
 
 void IBSolver::feqCalculate()
 {
-	//   ,     
-	fluid_->feq_.fillWithoutBoundaries(0.0);
+	const int size = fluid_->size().first * fluid_->size().second;
 
-	for (int q = 0; q < kQ; ++q) {
-		Matrix2D<double> v(fluid_->size().first, fluid_->size().second);
-		v = fluid_->vx_ * kEx[q] + fluid_->vy_ * kEy[q];
+	const double * rho = fluid_->rho_.Data();
+	const double * vx = fluid_->vx_.Data();
+	const double * vy = fluid_->vy_.Data();
 
-		fluid_->feq_[q] = kW[q] * fluid_->rho_.ScalarMultiplication(
-			(1.0 + 3.0 * v + 4.5 * v.ScalarMultiplication(v) - 1.5 *
-			(fluid_->vx_.ScalarMultiplication(fluid_->vx_) + fluid_->vy_.ScalarMultiplication(fluid_->vy_)))
-		);
-	}
+	double * feq[kQ];
+	for (int q = 0; q < kQ; ++q)
+		feq[q] = fluid_->feq_[q].Data();
+
+#pragma omp parallel for schedule(runtime)
+	for (int id = 0; id < size; ++id)
+		for (int q = 0; q < kQ; ++q)
+			feq[q][id] = Equilibrium(q, rho[id], vx[id], vy[id]);
 }
 
 void IBSolver::Streaming()
 {
+	const int rows = fluid_->size().first;
+	const int colls = fluid_->size().second;
+
+	Matrix2D<double> temp(rows, colls);
+
 	for (int q = 0; q < kQ; ++q)
 	{
-		Matrix2D<double> temp = fluid_->f_[q];
+		// Old values are moved to temp without copying
+		temp.Swap(fluid_->f_[q]);
 		fluid_->f_[q].FillWith(0.0);
 
-		for (unsigned y = 0; y < fluid_->size().first; ++y)
-			for (unsigned x = 0; x < fluid_->size().second; ++x)
+		const double * from = temp.Data();
+		double * to = fluid_->f_[q].Data();
+		const int dy = -static_cast<int>(kEy[q]);
+		const int dx = static_cast<int>(kEx[q]);
+
+		// Each destination node is written by only one source node
+	#pragma omp parallel for schedule(runtime)
+		for (int y = 0; y < rows; ++y)
+			for (int x = 0; x < colls; ++x)
 				if (medium_->is_fluid(y, x))
-					fluid_->f_[q](y - kEy[q], x + kEx[q]) = temp(y, x);
+					to[(y + dy) * colls + x + dx] = from[y * colls + x];
 	}
 
 	fluid_->f_.fillBoundaries(0.0);
 }
 
-void IBSolver::CalculateForces()
-{
-	double gravity = 0.0;
-
-	for (int y = 0; y < fluid_->size().first; ++y)
-		for (int x = 0; x < fluid_->size().second; ++x)
-		{
-			force_member_.at(0) = (1.0 - 0.5 / tau_) * kW[0] * (3.0 * ((-fluid_->vx_(y, x) * ((*fx_)(y, x) + gravity) + -fluid_->vy_(y, x) * (*fy_)(y, x))));
-			force_member_[1] = (1 - 0.5 / tau_) * kW[1] * (3.0 * ((1 - fluid_->vx_(y, x)) * ((*fx_)(y, x) + gravity) + (-fluid_->vy_(y, x)) * (*fy_)(y, x)) + 9.0 * (fluid_->vx_(y, x)) * ((*fx_)(y, x) + gravity));
-			force_member_[2] = (1 - 0.5 / tau_) * kW[2] * (3.0* ((-1 - fluid_->vx_(y, x)) * ((*fx_)(y, x) + gravity) + (-fluid_->vy_(y, x)) * (*fy_)(y, x)) + 9.0 * (fluid_->vx_(y, x)) * ((*fx_)(y, x) + gravity));
-			force_member_[3] = (1 - 0.5 / tau_) * kW[3] * (3.0 * ((-fluid_->vx_(y, x)) * ((*fx_)(y, x) + gravity) + (1 - fluid_->vy_(y, x)) * (*fy_)(y, x)) + 9.0 * (fluid_->vy_(y, x)) * (*fy_)(y, x));
-			force_member_[4] = (1 - 0.5 / tau_) * kW[4] * (3.0 * ((-fluid_->vx_(y, x)) * ((*fx_)(y, x) + gravity) + (-1 - fluid_->vy_(y, x)) * (*fy_)(y, x)) + 9.0 * (fluid_->vy_(y, x)) * (*fy_)(y, x));
-			force_member_[5] = (1 - 0.5 / tau_) * kW[5] * (3.0 * ((1 - fluid_->vx_(y, x)) * ((*fx_)(y, x) + gravity) + (1 - fluid_->vy_(y, x)) * (*fy_)(y, x)) + 9.0 * (fluid_->vx_(y, x) + fluid_->vy_(y, x)) * ((*fx_)(y, x) + gravity + (*fy_)(y, x)));
-			force_member_[6] = (1 - 0.5 / tau_) * kW[6] * (3.0 * ((-1 - fluid_->vx_(y, x)) * ((*fx_)(y, x) + gravity) + (-1 - fluid_->vy_(y, x)) * (*fy_)(y, x)) + 9.0 * (fluid_->vx_(y, x) + fluid_->vy_(y, x)) * ((*fx_)(y, x) + gravity + (*fy_)(y, x)));
-			force_member_[7] = (1 - 0.5 / tau_) * kW[7] * (3.0 * ((1 - fluid_->vx_(y, x)) * ((*fx_)(y, x) + gravity) + (-1 - fluid_->vy_(y, x)) * (*fy_)(y, x)) + 9.0 * (fluid_->vx_(y, x) - fluid_->vy_(y, x)) * ((*fx_)(y, x) + gravity - (*fy_)(y, x)));
-			force_member_[8] = (1 - 0.5 / tau_) * kW[8] * (3.0 * ((-1 - fluid_->vx_(y, x)) * ((*fx_)(y, x) + gravity) + (1 - fluid_->vy_(y, x)) * (*fy_)(y, x)) + 9 * (fluid_->vx_(y, x) - fluid_->vy_(y, x)) * ((*fx_)(y, x) + gravity - (*fy_)(y, x)));
-		}
-}
-
 void IBSolver::Collision()
 {
-	CalculateForces();
+	const int size = fluid_->size().first * fluid_->size().second;
 
+	double * f[kQ];
+	const double * feq[kQ];
 	for (int q = 0; q < kQ; ++q)
-		fluid_->f_[q] += (fluid_->feq_[q] - fluid_->f_[q]) / tau_ + force_member_.at(q);
+	{
+		f[q] = fluid_->f_[q].Data();
+		feq[q] = fluid_->feq_[q].Data();
+	}
+
+	const double * vx = fluid_->vx_.Data();
+	const double * vy = fluid_->vy_.Data();
+	const double * fx = fx_->Data();
+	const double * fy = fy_->Data();
+
+	const double force_factor = 1.0 - 0.5 / tau_;
+
+	// Guo forcing term is calculated from external force and velocity of each node and added in the same pass:
+	// F_q = (1 - 1 / 2tau) * w_q * (3 * (e_q - v) * F + 9 * (e_q * v) * (e_q * F))
+#pragma omp parallel for schedule(runtime)
+	for (int id = 0; id < size; ++id)
+	{
+		const double vF = vx[id] * fx[id] + vy[id] * fy[id];
+
+		for (int q = 0; q < kQ; ++q)
+		{
+			const double ev = kEx[q] * vx[id] + kEy[q] * vy[id];
+			const double eF = kEx[q] * fx[id] + kEy[q] * fy[id];
+			const double force = force_factor * kW[q] * (3.0 * (eF - vF) + 9.0 * ev * eF);
+
+			f[q][id] += (feq[q][id] - f[q][id]) / tau_ + force;
+		}
+	}
 }
 
 void IBSolver::Recalculate()
@@ -127,86 +159,191 @@ void IBSolver::Solve(int iter_numb)
 {
 	feqCalculate();
 
-	for (int q = 0; q < kQ; ++q)
-		fluid_->f_[q] = fluid_->feq_[q];
+	// After restart distribution function is already restored
+	if (start_iter_ == 0)
+		for (int q = 0; q < kQ; ++q)
+			fluid_->f_[q] = fluid_->feq_[q];
 
 	BCs BC(fluid_->f_);
 	Microphone mic;
 
-	for (int iter = 0; iter < iter_numb; ++iter)
+	const int rows = fluid_->size().first;
+	const int colls = fluid_->size().second;
+
+	if (contacts_.IsEnabled())
+		contacts_.Update(*markers_, colls, rows);
+
+	// Indexes of all written VTK files of fluid and of each immersed body, ParaView opens them as one dataset
+	VtkSeries fluid_series("Data\\ib_lbm_data\\fluid_vtk\\fluid.pvd");
+	std::vector<VtkSeries> bodies_series;
+	for (int i = 0; i < im_bodies_.size(); ++i)
+		bodies_series.push_back(VtkSeries("Data\\ib_lbm_data\\body_form_vtk\\body_form" + std::to_string(i) + ".pvd"));
+
+	// Fluid fields are written by writer thread: one staging buffer is written, while another one could be filled by solver.
+	// Output is destroyed first, so it finishes all jobs before buffers and series are destroyed
+	StagingBuffers<FluidSnapshot> snapshots(2, fluid_->size().first, fluid_->size().second);
+	AsyncOutput output;
+
+	// Collision (f, feq, v, F -> f), streaming (f -> f), recalculation (f, F -> rho, v) and feq calculation (rho, v -> feq)
+	performance_.SetLattice("ib", static_cast<long long>(fluid_->size().first) * fluid_->size().second, (7 * kQ + 12) * sizeof(double));
+
+	for (int iter = start_iter_; iter < iter_numb; ++iter)
 	{
+		performance_.BeginIteration();
+
 		//mic.PerformMeasurements(iter, im_bodies_, fluid_->vx_, "vx");
 		//mic.PerformMeasurements(iter, im_bodies_, fluid_->vx_, "vy");
 		//mic.PerformMeasurements(iter, im_bodies_, fluid_->vx_, "rho");
 
-		// Clean fx, fy fields
-		fx_->FillWith(0.0);
-		fy_->FillWith(0.0);
-
-		for (auto& i : im_bodies_)
+		performance_.Measure(Phase::IB_FORCES, [&]()
 		{
-			i->CalculateForces();
-			//i->SpreadForces(*fx_, *fy_);
-		}
+			// Clean fx, fy fields
+			fx_->FillWith(0.0);
+			fy_->FillWith(0.0);
 
-		// Deal with RBC-Wall intearaction
-		//Interaction(im_bodies_.at(2), im_bodies_.at(0));
-		//Interaction(im_bodies_.at(2), im_bodies_.at(1));
+			// Elastic forces of each body depend only on its own nodes
+			const int bodies_number = static_cast<int>(im_bodies_.size());
+		#pragma omp parallel for schedule(dynamic)
+			for (int i = 0; i < bodies_number; ++i)
+				im_bodies_[i]->CalculateForces();
 
-		for (auto& i : im_bodies_)
-		{
-			//i->CalculateForces();
-			i->SpreadForces(*fx_, *fy_);
-		}
+			// Deal with RBC-RBC and RBC-Wall interaction (walls are static bodies)
+			contacts_.AddForces(*markers_);
 
-		Collision();
-		BC.PrepareValuesForAllBC(BCType::BOUNCE_BACK, BCType::BOUNCE_BACK, BCType::DIRICHLET, BCType::DIRICHLET);
+			coupling_.SpreadForces(*markers_, colls, *fx_, *fy_);
+		});
 
-		Streaming();
+		performance_.Measure(Phase::COLLISION, [&]() { Collision(); });
+		performance_.Measure(Phase::BC_PREPARE, [&]()
+		{
+			BC.PrepareValuesForAllBC(BCType::BOUNCE_BACK, BCType::BOUNCE_BACK, BCType::DIRICHLET, BCType::DIRICHLET);
+		});
 
-		//BC.PrepareAdditionalBCs(*medium_);
+		performance_.Measure(Phase::STREAMING, [&]() { Streaming(); });
 
-		BC.BounceBackBC(Boundary::TOP);
-		BC.BounceBackBC(Boundary::BOTTOM);
+		performance_.Measure(Phase::BC_RECORD, [&]()
+		{
+			//body_BC.PrepareValues(fluid_->f_);
 
-		double vx = 0.001; 
-		BC.DirichletBC(Boundary::LEFT, *fluid_, 1.0);
-		BC.DirichletBC(Boundary::RIGHT, *fluid_, 0.99);
+			BC.BounceBackBC(Boundary::TOP);
+			BC.BounceBackBC(Boundary::BOTTOM);
 
-		//BC.AdditionalBounceBackBCs();
+			BC.DirichletBC(Boundary::LEFT, 1.0);
+			BC.DirichletBC(Boundary::RIGHT, 0.99);
 
-		BC.RecordValuesForAllBC(BCType::BOUNCE_BACK, BCType::BOUNCE_BACK, BCType::DIRICHLET, BCType::DIRICHLET);
+			BC.RecordValuesForAllBC(BCType::BOUNCE_BACK, BCType::BOUNCE_BACK, BCType::DIRICHLET, BCType::DIRICHLET);
 
-		//BC.RecordAdditionalBCs();
+			//body_BC.RecordValues(fluid_->f_);
+		});
 
-		Recalculate();
+		performance_.Measure(Phase::RECALCULATE, [&]() { Recalculate(); });
 
-		feqCalculate();
+		performance_.Measure(Phase::FEQ, [&]() { feqCalculate(); });
 
-		for (auto& i : im_bodies_)
+		performance_.Measure(Phase::IB_FORCES, [&]()
 		{
-			i->SpreadVelocity(*fluid_);
-			i->UpdatePosition();
-		}
+			coupling_.SpreadVelocity(*markers_, colls, *fluid_);
 
-		std::cout << iter << " Total rho = " << fluid_->rho_.GetSum() << std::endl;
+			markers_->UpdatePosition();
 
-		if (iter % 50 == 0)
-		{
-			fluid_->write_fluid_vtk("Data\\ib_lbm_data\\fluid_vtk", iter);
+			if (contacts_.IsEnabled())
+				contacts_.Update(*markers_, colls, rows);
+		});
+
+		if (checkpoint_interval_ > 0 && (iter + 1) % checkpoint_interval_ == 0)
+			performance_.Measure(Phase::CHECKPOINT, [&]() { WriteCheckpoint(iter + 1); });
 
-			for (int i = 0; i < im_bodies_.size(); ++i)
+		performance_.Measure(Phase::OUTPUT, [&]()
+		{
+			if (iter % 50 == 0)
 			{
-				im_bodies_.at(i)->WriteBodyFormToTxt(iter, i);
-				im_bodies_.at(i)->WriteBodyFormToVtk("Data\\ib_lbm_data\\body_form_vtk", i, iter);
+				std::cout << iter << " " << fluid_->GetDiagnostics() << '\n';
+
+				std::shared_ptr<FluidSnapshot> snapshot = snapshots.Acquire();
+				snapshot->CopyFrom(*fluid_);
+
+				output.Push([snapshot, iter, &fluid_series]()
+				{
+					fluid_series.Add(iter, snapshot->write_fluid_vtk("Data\\ib_lbm_data\\fluid_vtk", iter));
+					snapshot->vx_.WriteFieldToTxt("Data\\ib_lbm_data\\fluid_txt", "vx", iter);
+					snapshot->vy_.WriteFieldToTxt("Data\\ib_lbm_data\\fluid_txt", "vy", iter);
+					snapshot->rho_.WriteFieldToTxt("Data\\ib_lbm_data\\fluid_txt", "rho", iter);
+				});
+
+				// Forms of bodies are small, so they are written directly
+				for (int i = 0; i < im_bodies_.size(); ++i)
+				{
+					im_bodies_.at(i)->WriteBodyFormToTxt(iter, i);
+					bodies_series.at(i).Add(iter, im_bodies_.at(i)->WriteBodyFormToVtk("Data\\ib_lbm_data\\body_form_vtk", i, iter));
+				}
 			}
+		});
 
-			fluid_->vx_.WriteFieldToTxt("Data\\ib_lbm_data\\fluid_txt", "vx", iter);
-			fluid_->vy_.WriteFieldToTxt("Data\\ib_lbm_data\\fluid_txt", "vy", iter);
-			fluid_->rho_.WriteFieldToTxt("Data\\ib_lbm_data\\fluid_txt", "rho", iter);
-		}
+		performance_.EndIteration(iter + 1);
+	}
+
+	performance_.Finish(iter_numb);
+}
 
+void IBSolver::SetPerformanceLog(std::string const & file_name, int const interval, PerformanceFormat const format)
+{
+	performance_.Enable(file_name, interval, format);
+}
+
+void IBSolver::SetContactForces(double const radius, double const stiffness)
+{
+	contacts_.Enable(radius, stiffness);
+}
+
+void IBSolver::SetCheckpoint(std::string const & file_name, int const interval)
+{
+	checkpoint_file_ = file_name;
+	checkpoint_interval_ = (interval > 0) ? interval : 0;
+}
+
+bool IBSolver::Restart(std::string const & file_name)
+{
+	CheckpointReader reader(file_name);
+	int iter = 0;
+	int bodies_num = 0;
+
+	bool is_ok = reader.IsOk() && reader.Read("solver.iteration", iter) && reader.Read("solver.bodies_num", bodies_num);
+
+	if (is_ok && bodies_num != static_cast<int>(im_bodies_.size()))
+	{
+		std::cout << "Error! Checkpoint has " << bodies_num << " immersed bodies instead of " << im_bodies_.size() << ".\n";
+		is_ok = false;
+	}
+
+	is_ok = is_ok && medium_->LoadState(reader) && fluid_->LoadState(reader);
+	for (int i = 0; i < bodies_num && is_ok; ++i)
+		is_ok = im_bodies_.at(i)->LoadState(reader, i);
+
+	if (!is_ok)
+	{
+		std::cout << "Error! Could not restart from checkpoint " << file_name << ".\n";
+		return false;
 	}
+
+	start_iter_ = iter;
+
+	return true;
+}
+
+void IBSolver::WriteCheckpoint(int const iter) const
+{
+	CheckpointWriter writer(checkpoint_file_);
+
+	writer.Write("solver.iteration", iter);
+	writer.Write("solver.bodies_num", static_cast<int>(im_bodies_.size()));
+	medium_->SaveState(writer);
+	fluid_->SaveState(writer);
+
+	for (int i = 0; i < im_bodies_.size(); ++i)
+		im_bodies_.at(i)->SaveState(writer, i);
+
+	if (!writer.Close())
+		std::cout << "Error! Checkpoint at iteration " << iter << " was not written.\n";
 }
 
 void IBSolver::CreateDataFolder(std::string folder_name) const
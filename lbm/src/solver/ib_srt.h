@@ -8,7 +8,11 @@
 #include"..\modeling_area\fluid.h"
 #include"..\modeling_area\medium.h"
 #include"im_body\immersed_body.h"
+#include"im_body\ib_coupling.h"
+#include"im_body\ib_contacts.h"
 #include"bc\bc.h"
+#include"performance.h"
+#include"..\output\async_output.h"
 
 
 class IBSolver : iSolver
@@ -27,12 +31,24 @@ public:
 	void Recalculate() override;
 	void Solve(int iter_numb) override;
 
+	//! Enables writing of checkpoint 'file_name' every 'interval' iterations (disabled if 'interval' <= 0)
+	void SetCheckpoint(std::string const & file_name, int const interval);
+	//! Restores medium, fluid and immersed bodies from checkpoint 'file_name', next Solve() continues from the saved iteration
+	//! up to the same total number of iterations. Returns false if checkpoint could not be read
+	bool Restart(std::string const & file_name);
+
+	//! Enables contact forces between immersed bodies closer than 'radius' with 'stiffness' (disabled by default)
+	void SetContactForces(double const radius, double const stiffness);
+
+	//! Enables reports of performance (MLUPS, memory bandwidth and time of time step phases) every 'interval' iterations to 'file_name'
+	void SetPerformanceLog(std::string const & file_name, int const interval, PerformanceFormat const format = PerformanceFormat::JSON);
+
 private:
 
-	//! Performs calculation of external force terms from immersed boundary on fluid
-	void CalculateForces();
 	//! Creates folder for output data if not existed yet
 	void CreateDataFolder(std::string folder_name) const;
+	//! Writes medium, fluid, immersed bodies and number of performed iterations 'iter' to checkpoint
+	void WriteCheckpoint(int const iter) const;
 
 private:
 	//! Relaxation time
@@ -50,9 +66,22 @@ private:
 	//! Pointer to y-component external forces for all modeling area
 	std::unique_ptr<Matrix2D<double>> fy_;
 
-	std::vector<double> force_member_;
-
 	// Add many immersed bodies
 	std::vector<ImmersedBody*> im_bodies_;
+	//! Nodes of all immersed bodies
+	std::shared_ptr<IBMarkers> markers_;
+	//! Spreading of forces and interpolation of velocity for all immersed bodies
+	IBCoupling coupling_;
+	//! Contact forces between immersed bodies
+	IBContacts contacts_;
+
+	//! Name of checkpoint file
+	std::string checkpoint_file_;
+	//! Number of iterations between checkpoints (checkpoints are not written if it is 0)
+	int checkpoint_interval_;
+	//! Iteration, from which solution starts (not 0 after restart)
+	int start_iter_;
 
+	//! Time of time step phases and performance reports
+	PerformanceMonitor performance_;
 };
\ No newline at end of file
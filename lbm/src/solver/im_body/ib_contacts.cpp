@@ -0,0 +1,148 @@
+#include"ib_contacts.h"
+
+#include<algorithm>
+
+
+void IBContacts::Enable(double const radius, double const stiffness)
+{
+	radius_ = radius;
+	stiffness_ = stiffness;
+
+	// Cell list is built for new radius at the next update
+	marker_cell_.clear();
+}
+
+int IBContacts::GetCell(double const x, double const y) const
+{
+	const int cell_x = std::min(std::max(static_cast<int>(floor(x / radius_)), 0), cells_x_ - 1);
+	const int cell_y = std::min(std::max(static_cast<int>(floor(y / radius_)), 0), cells_y_ - 1);
+
+	return cell_y * cells_x_ + cell_x;
+}
+
+void IBContacts::Update(IBMarkers const & markers, int const domain_x, int const domain_y)
+{
+	const int markers_number = markers.GetNodesNumber();
+
+	// Bodies of markers are listed once, only their cells are updated later
+	const bool is_new = (static_cast<int>(marker_cell_.size()) != markers_number);
+
+	if (is_new)
+	{
+		marker_body_.resize(markers_number);
+		for (int b = 0; b < markers.GetBodiesNumber(); ++b)
+			std::fill(marker_body_.begin() + markers.GetBegin(b), marker_body_.begin() + markers.GetEnd(b), b);
+
+		marker_cell_.assign(markers_number, -1);
+
+		cells_x_ = std::max(static_cast<int>(ceil(domain_x / radius_)), 1);
+		cells_y_ = std::max(static_cast<int>(ceil(domain_y / radius_)), 1);
+	}
+
+	bool is_changed = is_new;
+
+	for (int i = 0; i < markers_number; ++i)
+	{
+		const int cell = GetCell(markers.x_[i], markers.y_[i]);
+
+		if (cell != marker_cell_[i])
+		{
+			marker_cell_[i] = cell;
+			is_changed = true;
+		}
+	}
+
+	if (!is_changed)
+		return;
+
+	// Stable counting sort of markers by cells
+	const int cells_number = cells_x_ * cells_y_;
+
+	cell_offset_.assign(cells_number + 1, 0);
+	for (int cell : marker_cell_)
+		++cell_offset_[cell + 1];
+	for (int cell = 0; cell < cells_number; ++cell)
+		cell_offset_[cell + 1] += cell_offset_[cell];
+
+	std::vector<int> position(cell_offset_.begin(), cell_offset_.end() - 1);
+	cell_markers_.resize(markers_number);
+	for (int i = 0; i < markers_number; ++i)
+		cell_markers_[position[marker_cell_[i]]++] = i;
+}
+
+void IBContacts::AddForces(IBMarkers & markers) const
+{
+	if (!IsEnabled())
+		return;
+
+	const int markers_number = static_cast<int>(marker_cell_.size());
+	const double radius_sq = radius_ * radius_;
+
+	// Each marker writes only its own force
+#pragma omp parallel
+	{
+		std::vector<Neighbour> neighbours;
+
+	#pragma omp for schedule(dynamic, 64)
+		for (int i = 0; i < markers_number; ++i)
+		{
+			if (!markers.IsMoving(i))
+				continue;
+
+			// Nodes of other bodies closer than contact radius lie in neighbouring cells
+			neighbours.clear();
+
+			const int cell_x = marker_cell_[i] % cells_x_;
+			const int cell_y = marker_cell_[i] / cells_x_;
+
+			for (int y = std::max(cell_y - 1, 0); y <= std::min(cell_y + 1, cells_y_ - 1); ++y)
+				for (int x = std::max(cell_x - 1, 0); x <= std::min(cell_x + 1, cells_x_ - 1); ++x)
+				{
+					const int cell = y * cells_x_ + x;
+
+					for (int k = cell_offset_[cell]; k < cell_offset_[cell + 1]; ++k)
+					{
+						const int j = cell_markers_[k];
+						if (marker_body_[j] == marker_body_[i])
+							continue;
+
+						const double dx = markers.x_[i] - markers.x_[j];
+						const double dy = markers.y_[i] - markers.y_[j];
+
+						if (SQ(dx) + SQ(dy) < radius_sq)
+							neighbours.push_back(Neighbour{ j, dx, dy });
+					}
+				}
+
+			// Forces of bodies are added in order of bodies and their nodes (nodes of bodies are stored one after another),
+			// so result does not depend on cells
+			std::sort(neighbours.begin(), neighbours.end(), [](Neighbour const & a, Neighbour const & b)
+			{
+				return a.marker_ < b.marker_;
+			});
+
+			for (std::size_t first = 0; first < neighbours.size();)
+			{
+				std::size_t last = first;
+				double min_distance_sq = SQ(neighbours[first].x_) + SQ(neighbours[first].y_);
+
+				while (last < neighbours.size() && marker_body_[neighbours[last].marker_] == marker_body_[neighbours[first].marker_])
+				{
+					min_distance_sq = std::min(min_distance_sq, SQ(neighbours[last].x_) + SQ(neighbours[last].y_));
+					++last;
+				}
+
+				const double min_distance = sqrt(min_distance_sq);
+				const double factor = stiffness_ / (min_distance * min_distance * min_distance);
+
+				for (std::size_t k = first; k < last; ++k)
+				{
+					markers.Fx_[i] += factor * neighbours[k].x_;
+					markers.Fy_[i] += factor * neighbours[k].y_;
+				}
+
+				first = last;
+			}
+		}
+	}
+}
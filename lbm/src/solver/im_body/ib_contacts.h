@@ -0,0 +1,64 @@
+#pragma once
+
+#ifndef IB_CONTACTS_H
+#define IB_CONTACTS_H
+
+#include<vector>
+
+#include"immersed_body.h"
+
+//! Contact (repulsion) forces between immersed bodies, walls are static bodies.
+//
+// Node of body is pushed away from each node of other body closer than contact radius 'rc':
+//	F += kr * r / d^3, where r - vector from node of other body, d - distance to the nearest node of this other body.
+// Nodes of all bodies are binned to uniform grid of cells with size 'rc' (cell list), so only nodes of 3x3 neighbouring
+// cells are checked and cost is proportional to the number of nodes. Cell list is updated after bodies are moved and
+// is rebuilt only if some node moved to other cell (static bodies never cause rebuilding).
+class IBContacts
+{
+public:
+	IBContacts() {}
+	~IBContacts() {}
+
+	//! Enables contact forces with contact radius 'radius' and stiffness 'stiffness' (disabled if 'stiffness' <= 0)
+	void Enable(double const radius, double const stiffness);
+	//! Returns true if contact forces are enabled
+	bool IsEnabled() const { return stiffness_ > 0.0; }
+
+	//! Updates cell list after 'markers' of bodies in modeling area 'domain_x' x 'domain_y' are moved
+	void Update(IBMarkers const & markers, int const domain_x, int const domain_y);
+	//! Adds contact forces to all moving 'markers' (cell list should be updated for current positions)
+	void AddForces(IBMarkers & markers) const;
+
+private:
+	//! Returns cell of point ('x', 'y') (points outside of modeling area are put to the nearest cell)
+	int GetCell(double const x, double const y) const;
+
+	//! Node of other body, which is closer than contact radius: number of node and vector from it
+	struct Neighbour
+	{
+		int marker_;
+		double x_;
+		double y_;
+	};
+
+	//! Contact radius
+	double radius_{ 1.0 };
+	//! Stiffness of contact forces
+	double stiffness_{ 0.0 };
+
+	//! Number of cells along x- and y-axis
+	int cells_x_{ 0 };
+	int cells_y_{ 0 };
+
+	//! Body and cell of each node of all bodies
+	std::vector<int> marker_body_;
+	std::vector<int> marker_cell_;
+
+	//! Markers, sorted by cells (in ascending order in each cell)
+	std::vector<int> cell_markers_;
+	//! Position of the first marker of each cell in 'cell_markers_' (cells number + 1 elements)
+	std::vector<int> cell_offset_;
+};
+
+#endif // !IB_CONTACTS_H
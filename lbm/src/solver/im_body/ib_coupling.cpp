@@ -0,0 +1,74 @@
+#include"ib_coupling.h"
+
+
+void IBCoupling::SpreadForces(IBMarkers const & markers, int const domain_x, Matrix2D<double> & fx, Matrix2D<double> & fy)
+{
+	const int markers_number = markers.GetNodesNumber();
+	const int rows = static_cast<int>(fx.Size().first);
+
+	contributions_.resize(4 * markers_number);
+
+	// Each marker writes only its own contributions
+#pragma omp parallel for schedule(runtime)
+	for (int i = 0; i < markers_number; ++i)
+	{
+		const IBStencil stencil(Point(markers.y_[i], markers.x_[i]), domain_x);
+
+		Contribution * contribution = contributions_.data() + 4 * i;
+
+		for (int X = 0; X < 2; ++X)
+			for (int Y = 0; Y < 2; ++Y)
+				*contribution++ = Contribution{ stencil.y_[Y], stencil.x_[X],
+					markers.Fx_[i] * stencil.weight_x_[X] * stencil.weight_y_[Y], markers.Fy_[i] * stencil.weight_x_[X] * stencil.weight_y_[Y] };
+	}
+
+	// Stable counting sort by rows keeps order of markers in each row
+	row_offset_.assign(rows + 1, 0);
+	for (auto const & contribution : contributions_)
+		++row_offset_[contribution.row_ + 1];
+	for (int y = 0; y < rows; ++y)
+		row_offset_[y + 1] += row_offset_[y];
+
+	row_position_.assign(row_offset_.begin(), row_offset_.end() - 1);
+	sorted_.resize(contributions_.size());
+	for (auto const & contribution : contributions_)
+		sorted_[row_position_[contribution.row_]++] = contribution;
+
+	// Each row of force fields is written by one thread
+#pragma omp parallel for schedule(runtime)
+	for (int y = 0; y < rows; ++y)
+	{
+		for (int k = row_offset_[y]; k < row_offset_[y + 1]; ++k)
+		{
+			fx(y, sorted_[k].coll_) += sorted_[k].fx_;
+			fy(y, sorted_[k].coll_) += sorted_[k].fy_;
+		}
+	}
+}
+
+void IBCoupling::SpreadVelocity(IBMarkers & markers, int const domain_x, Fluid const & fluid)
+{
+	const int markers_number = markers.GetNodesNumber();
+
+	// Each marker reads fluid and writes only its own velocity
+#pragma omp parallel for schedule(runtime)
+	for (int i = 0; i < markers_number; ++i)
+	{
+		const IBStencil stencil(Point(markers.y_[i], markers.x_[i]), domain_x);
+
+		double vx = 0.0;
+		double vy = 0.0;
+
+		for (int X = 0; X < 2; ++X)
+		{
+			for (int Y = 0; Y < 2; ++Y)
+			{
+				vx += (fluid.vx_(stencil.y_[Y], stencil.x_[X]) * stencil.weight_x_[X] * stencil.weight_y_[Y]);
+				vy += (fluid.vy_(stencil.y_[Y], stencil.x_[X]) * stencil.weight_x_[X] * stencil.weight_y_[Y]);
+			}
+		}
+
+		markers.vx_[i] = vx;
+		markers.vy_[i] = vy;
+	}
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#ifndef IB_COUPLING_H
+#define IB_COUPLING_H
+
+#include<vector>
+
+#include"immersed_body.h"
+
+//! Interaction of all immersed bodies with fluid: spreading of forces of body nodes (markers) to fluid and
+//! interpolation of fluid velocity to markers.
+//
+// Each marker interacts with 2x2 fluid nodes (see IBStencil). Markers of all bodies are stored together in IBMarkers, so
+// the work is shared by threads equally for a few large bodies and for hundreds of small ones.
+//	- Interpolation of velocity only reads fluid, so all markers are processed in parallel.
+//	- Spreading writes to shared force fields, so contributions of markers are calculated in parallel, grouped by
+//	  rows of modeling area (stable counting sort) and each row is summed by one thread.
+// Contributions to each fluid node are added in order of bodies and their markers, so result does not depend on number
+// of threads and is the same as of serial ImmersedBody::SpreadForces() of all bodies.
+class IBCoupling
+{
+public:
+	IBCoupling() {}
+	~IBCoupling() {}
+
+	//! Adds forces of all 'markers' to external force fields 'fx' and 'fy' (modeling area is periodic with 'domain_x' columns)
+	void SpreadForces(IBMarkers const & markers, int const domain_x, Matrix2D<double> & fx, Matrix2D<double> & fy);
+	//! Calculates velocities of all 'markers' from velocity of 'fluid' (modeling area is periodic with 'domain_x' columns)
+	void SpreadVelocity(IBMarkers & markers, int const domain_x, Fluid const & fluid);
+
+private:
+	//! Force of marker, which is spread to fluid node ('row_', 'coll_')
+	struct Contribution
+	{
+		int row_;
+		int coll_;
+		double fx_;
+		double fy_;
+	};
+
+	//! Contributions of markers (4 per marker, in order of markers)
+	std::vector<Contribution> contributions_;
+	//! Contributions, grouped by rows
+	std::vector<Contribution> sorted_;
+	//! Position of the first contribution of each row in sorted list ('rows' + 1 elements)
+	std::vector<int> row_offset_;
+	//! Position of the next contribution of each row during sorting
+	std::vector<int> row_position_;
+};
+
+#endif // !IB_COUPLING_H
@@ -0,0 +1,52 @@
+#include"ib_markers.h"
+
+
+int IBMarkers::AddBody(int const nodes_number)
+{
+	const int begin = GetNodesNumber();
+	const std::size_t size = static_cast<std::size_t>(begin + nodes_number);
+
+	for (auto values : { &x_, &y_, &ref_x_, &ref_y_, &vx_, &vy_, &Fx_, &Fy_ })
+		values->resize(size, 0.0);
+	type_.resize(size, static_cast<unsigned char>(IBNodeType::STATIC));
+
+	body_offset_.push_back(begin + nodes_number);
+
+	return begin;
+}
+
+int IBMarkers::AddBody(IBMarkers const & other, int const begin, int const end)
+{
+	const int first = GetNodesNumber();
+
+	x_.insert(x_.end(), other.x_.begin() + begin, other.x_.begin() + end);
+	y_.insert(y_.end(), other.y_.begin() + begin, other.y_.begin() + end);
+	ref_x_.insert(ref_x_.end(), other.ref_x_.begin() + begin, other.ref_x_.begin() + end);
+	ref_y_.insert(ref_y_.end(), other.ref_y_.begin() + begin, other.ref_y_.begin() + end);
+	vx_.insert(vx_.end(), other.vx_.begin() + begin, other.vx_.begin() + end);
+	vy_.insert(vy_.end(), other.vy_.begin() + begin, other.vy_.begin() + end);
+	Fx_.insert(Fx_.end(), other.Fx_.begin() + begin, other.Fx_.begin() + end);
+	Fy_.insert(Fy_.end(), other.Fy_.begin() + begin, other.Fy_.begin() + end);
+	type_.insert(type_.end(), other.type_.begin() + begin, other.type_.begin() + end);
+
+	body_offset_.push_back(GetNodesNumber());
+
+	return first;
+}
+
+void IBMarkers::UpdatePosition()
+{
+	const int nodes_number = GetNodesNumber();
+
+	double * x = x_.data();
+	double * y = y_.data();
+	const double * vx = vx_.data();
+	const double * vy = vy_.data();
+
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < nodes_number; ++i)
+	{
+		x[i] += vx[i];
+		y[i] += vy[i];
+	}
+}
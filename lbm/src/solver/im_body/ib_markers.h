@@ -0,0 +1,75 @@
+#pragma once
+
+#ifndef IB_MARKERS_H
+#define IB_MARKERS_H
+
+#include<vector>
+
+//! Type of immersed body node
+enum class IBNodeType
+{
+	STATIC = 0,	// fixed position in space
+	MOVING = 1,	// position could change
+};
+
+//! Nodes (markers) of immersed bodies, stored as structure of arrays.
+//
+// Each value of nodes is stored in its own array, so loops over nodes read only values they use and could be vectorized.
+// Nodes of all bodies of a solver are stored in one set one after another: nodes of body 'b' are in range
+// [GetBegin(b), GetEnd(b)). Body creates its nodes in its own set and is moved to the common set of solver by
+// ImmersedBody::AttachTo().
+class IBMarkers
+{
+public:
+	IBMarkers() : body_offset_(1, 0) {}
+	~IBMarkers() {}
+
+	//! Returns number of nodes of all bodies
+	int GetNodesNumber() const { return static_cast<int>(x_.size()); }
+	//! Returns number of bodies
+	int GetBodiesNumber() const { return static_cast<int>(body_offset_.size()) - 1; }
+	//! Returns the first node of 'body'
+	int GetBegin(int const body) const { return body_offset_[body]; }
+	//! Returns the node after the last node of 'body'
+	int GetEnd(int const body) const { return body_offset_[body + 1]; }
+
+	//! Adds body with 'nodes_number' static nodes at origin, returns its first node
+	int AddBody(int const nodes_number);
+	//! Adds body with copies of nodes ['begin', 'end') of 'other', returns its first node
+	int AddBody(IBMarkers const & other, int const begin, int const end);
+
+	//! Returns true if node 'i' is moving
+	bool IsMoving(int const i) const { return (type_[i] & kMovingMask) != 0; }
+	//! Sets type of node 'i'
+	void SetType(int const i, IBNodeType const type) { type_[i] = static_cast<unsigned char>(type); }
+	//! Returns type of node 'i'
+	IBNodeType GetType(int const i) const { return static_cast<IBNodeType>(type_[i]); }
+
+	//! Moves all nodes with their velocities during one time step
+	void UpdatePosition();
+
+public:
+	//! Bit of type mask, which is set for moving nodes
+	static const unsigned char kMovingMask = static_cast<unsigned char>(IBNodeType::MOVING);
+
+	//! Current position of nodes
+	std::vector<double> x_;
+	std::vector<double> y_;
+	//! Reference position of nodes
+	std::vector<double> ref_x_;
+	std::vector<double> ref_y_;
+	//! Velocity of nodes
+	std::vector<double> vx_;
+	std::vector<double> vy_;
+	//! Elastic force, acting on nodes
+	std::vector<double> Fx_;
+	std::vector<double> Fy_;
+	//! Type of nodes as bit mask (see kMovingMask)
+	std::vector<unsigned char> type_;
+
+private:
+	//! First node of each body ('bodies' + 1 elements)
+	std::vector<int> body_offset_;
+};
+
+#endif // !IB_MARKERS_H
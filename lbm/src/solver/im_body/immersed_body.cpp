@@ -4,37 +4,87 @@
 #define SQ(x) ((x) * (x)) // square function; replaces SQ(x) by ((x) * (x)) in the code
 
 
-ImmersedBody::ImmersedBody() : domain_x_(0), domain_y_(0), nodes_num(0)
+IBStencil::IBStencil(Point const & pos, int const domain_x)
 {
-	body_.resize(nodes_num, IBNode());
-}
+	// Identify the lowest fluid lattice node in interpolation range
+	const int x_int = (int)(pos.x_ - 0.5 + domain_x) - domain_x;
+	const int y_int = (int)(pos.y_ + 0.5);
 
-ImmersedBody::ImmersedBody(int domainX, int domainY, int nodesNumber) : domain_x_(domainX), domain_y_(domainY), nodes_num(nodesNumber)
-{
-	body_.resize(nodes_num, IBNode());
+	for (int i = 0; i < 2; ++i)
+	{
+		x_[i] = (x_int + i + domain_x) % domain_x;
+		y_[i] = y_int + i;
+
+		// Compute interpolation weights for x- and y-direction based on the distance between object node and fluid lattice node
+		weight_x_[i] = 1 - abs(pos.x_ - 0.5 - (x_int + i));
+		weight_y_[i] = 1 - abs(pos.y_ + 0.5 - (y_int + i));
+	}
 }
 
-void ImmersedBody::CalculateForces()
+
+ImmersedBody::ImmersedBody() : ImmersedBody(0, 0, 0) {}
+
+ImmersedBody::ImmersedBody(int domainX, int domainY, int nodesNumber) : domain_x_(domainX), domain_y_(domainY), nodes_num(nodesNumber),
+	markers_(std::make_shared<IBMarkers>()), begin_(0)
 {
-	// Set initial values of force equal to zero
-	for (auto & node : body_)
+	begin_ = markers_->AddBody(nodes_num);
+
+	strain_x_.resize(nodes_num);
+	strain_y_.resize(nodes_num);
+	for (int k = 0; k < 3; ++k)
 	{
-		node.Fx_ = 0.0;
-		node.Fy_ = 0.0;
+		bending_x_[k].resize(nodes_num);
+		bending_y_[k].resize(nodes_num);
 	}
+}
+
+void ImmersedBody::AttachTo(std::shared_ptr<IBMarkers> const & markers)
+{
+	if (markers == markers_)
+		return;
+
+	const int begin = markers->AddBody(*markers_, begin_, begin_ + nodes_num);
 
+	markers_ = markers;
+	begin_ = begin;
+}
+
+void ImmersedBody::SetNode(int const id, Point const & pos, IBNodeType const type)
+{
+	IBMarkers & markers = *markers_;
+	const int i = begin_ + id;
+
+	markers.x_.at(i) = pos.x_;
+	markers.y_.at(i) = pos.y_;
+	markers.ref_x_.at(i) = pos.x_;
+	markers.ref_y_.at(i) = pos.y_;
+	markers.SetType(i, type);
+}
+
+void ImmersedBody::CalculateForces()
+{
 	const double arcLen = GetArcLen(); // 2.0 * M_PI * radius_ / nodes_num;
 
+	// Strain forces set initial values of forces, bending forces are added to them
 	CalculateStrainForces();
 	CalculateBendingForces();
 
+	IBMarkers & markers = *markers_;
+	const double * x = markers.x_.data() + begin_;
+	const double * y = markers.y_.data() + begin_;
+	const double * ref_x = markers.ref_x_.data() + begin_;
+	const double * ref_y = markers.ref_y_.data() + begin_;
+	const unsigned char * type = markers.type_.data() + begin_;
+	double * Fx = markers.Fx_.data() + begin_;
+	double * Fy = markers.Fy_.data() + begin_;
+
+	// Static nodes are pulled back to their reference positions
 	for (int i = 0; i < nodes_num; ++i)
 	{
-		if (body_.at(i).type_ == IBNodeType::STATIC)
-		{
-			body_.at(i).Fx_ = -stiffness_ * (body_.at(i).cur_pos_.x_ - body_.at(i).ref_pos_.x_) * arcLen;
-			body_.at(i).Fy_ = -stiffness_ * (body_.at(i).cur_pos_.y_ - body_.at(i).ref_pos_.y_) * arcLen;
-		}
+		const bool is_moving = (type[i] & IBMarkers::kMovingMask) != 0;
+
+		Fx[i] = is_moving ? Fx[i] : -stiffness_ * (x[i] - ref_x[i]) * arcLen;
+		Fy[i] = is_moving ? Fy[i] : -stiffness_ * (y[i] - ref_y[i]) * arcLen;
 	}
 }
 
@@ -43,28 +93,19 @@ void ImmersedBody::SpreadForces(Matrix2D<double>& fx, Matrix2D<double>& fy)
 	//fx.FillWith(0.0);
 	//fy.FillWith(0.0);
 
-	for (int i = 0; i < nodes_num; ++i)
-	{
-		int x_int = (int)(body_.at(i).cur_pos_.x_ - 0.5 + domain_x_) - domain_x_;
-		int y_int = (int)(body_.at(i).cur_pos_.y_ + 0.5);
-
-		for (int X = x_int; X <= x_int + 1; ++X) {
-			for (int Y = y_int; Y <= y_int + 1; ++Y) {
-
-				// Compute distance between object node and fluid lattice node.
-
-				const double dist_x = body_.at(i).cur_pos_.x_ - 0.5 - X;
-				const double dist_y = body_.at(i).cur_pos_.y_ + 0.5 - Y;
+	IBMarkers const & markers = *markers_;
 
-				// Compute interpolation weights for x- and y-direction based on the distance.
+	for (int i = begin_; i < begin_ + nodes_num; ++i)
+	{
+		const IBStencil stencil(Point(markers.y_[i], markers.x_[i]), domain_x_);
 
-				const double weight_x = 1 - abs(dist_x);
-				const double weight_y = 1 - abs(dist_y);
+		for (int X = 0; X < 2; ++X) {
+			for (int Y = 0; Y < 2; ++Y) {
 
 				// Compute lattice force.
 
-				fx(Y, (X + domain_x_) % domain_x_) += body_.at(i).Fx_ * weight_x * weight_y;
-				fy(Y, (X + domain_x_) % domain_x_) += body_.at(i).Fy_ * weight_x * weight_y;
+				fx(stencil.y_[Y], stencil.x_[X]) += markers.Fx_[i] * stencil.weight_x_[X] * stencil.weight_y_[Y];
+				fy(stencil.y_[Y], stencil.x_[X]) += markers.Fy_[i] * stencil.weight_x_[X] * stencil.weight_y_[Y];
 			}
 		}
 
@@ -73,37 +114,26 @@ void ImmersedBody::SpreadForces(Matrix2D<double>& fx, Matrix2D<double>& fy)
 
 void ImmersedBody::SpreadVelocity(Fluid & fluid)
 {
-	for (int i = 0; i < nodes_num; ++i)
+	IBMarkers & markers = *markers_;
+
+	for (int i = begin_; i < begin_ + nodes_num; ++i)
 	{
 		// Reset node velocity first since '+=' is used.
-		body_.at(i).vx_ = 0.0;
-		body_.at(i).vy_ = 0.0;
-
-		// Identify the lowest fluid lattice node in interpolation range (see spreading).
-
-		int x_int = (int)(body_.at(i).cur_pos_.x_ - 0.5 + domain_x_) - domain_x_;
-		int y_int = (int)(body_.at(i).cur_pos_.y_ + 0.5);
+		markers.vx_[i] = 0.0;
+		markers.vy_[i] = 0.0;
 
 		// Run over all neighboring fluid nodes.
 		// In the case of the two-point interpolation, it is 2x2 fluid nodes.
 
-		for (int X = x_int; X <= x_int + 1; ++X) {
-			for (int Y = y_int; Y <= y_int + 1; ++Y) {
-
-				// Compute distance between object node and fluid lattice node.
+		const IBStencil stencil(Point(markers.y_[i], markers.x_[i]), domain_x_);
 
-				const double dist_x = body_.at(i).cur_pos_.x_ - 0.5 - X;
-				const double dist_y = body_.at(i).cur_pos_.y_ + 0.5 - Y;
-
-				// Compute interpolation weights for x- and y-direction based on the distance.
-
-				const double weight_x = 1 - abs(dist_x);
-				const double weight_y = 1 - abs(dist_y);
+		for (int X = 0; X < 2; ++X) {
+			for (int Y = 0; Y < 2; ++Y) {
 
 				// Compute node velocities.
 
-				body_.at(i).vx_ += (fluid.vx_(Y, (X + domain_x_) % domain_x_) * weight_x * weight_y);
-				body_.at(i).vy_ += (fluid.vy_(Y, (X + domain_x_) % domain_x_) * weight_x * weight_y);
+				markers.vx_[i] += (fluid.vx_(stencil.y_[Y], stencil.x_[X]) * stencil.weight_x_[X] * stencil.weight_y_[Y]);
+				markers.vy_[i] += (fluid.vy_(stencil.y_[Y], stencil.x_[X]) * stencil.weight_x_[X] * stencil.weight_y_[Y]);
 			}
 		}
 	}
@@ -117,13 +147,18 @@ void ImmersedBody::UpdatePosition()
 
 	// Update node and center positions
 
+	double * x = markers_->x_.data() + begin_;
+	double * y = markers_->y_.data() + begin_;
+	const double * vx = markers_->vx_.data() + begin_;
+	const double * vy = markers_->vy_.data() + begin_;
+
 	for (int i = 0; i < nodes_num; ++i)
 	{
-		body_.at(i).cur_pos_.x_ += body_.at(i).vx_;
-		body_.at(i).cur_pos_.y_ += body_.at(i).vy_;
+		x[i] += vx[i];
+		y[i] += vy[i];
 
-		//center_.x_ += body_.at(i).cur_pos_.x_ / nodes_num;
-		//center_.y_ += body_.at(i).cur_pos_.y_ / nodes_num;
+		//center_.x_ += x[i] / nodes_num;
+		//center_.y_ += y[i] / nodes_num;
 	}
 
 	/// Check for periodicity along the x-axis
@@ -134,7 +169,7 @@ void ImmersedBody::UpdatePosition()
 
 	for (int n = 0; n < nodes_num; ++n)
 	{
-	body_.at(n).cur_pos_.x_ += domain_x_;
+	x[n] += domain_x_;
 	}
 	}
 	else if (center_.x_ >= domain_x_)
@@ -143,7 +178,7 @@ void ImmersedBody::UpdatePosition()
 
 	for (int n = 0; n < nodes_num; ++n)
 	{
-	body_.at(n).cur_pos_.x_ -= domain_x_;
+	x[n] -= domain_x_;
 	}
 	}*/
 
@@ -159,13 +194,15 @@ void ImmersedBody::WriteBodyFormToTxt(const int time, const int body_id)
 
 	if (output_file.is_open())
 	{
-		for (auto node : body_)
+		IBMarkers const & markers = *markers_;
+
+		for (int i = begin_; i < begin_ + nodes_num; ++i)
 		{
-			output_file << node.cur_pos_.x_ << " " << node.cur_pos_.y_ << std::endl;
+			output_file << markers.x_[i] << " " << markers.y_[i] << std::endl;
 		}
 
 		// Add first point to data in file to display closed boundary
-		output_file << body_.begin()->cur_pos_.x_ << " " << body_.begin()->cur_pos_.y_;
+		output_file << markers.x_[begin_] << " " << markers.y_[begin_];
 
 	}
 	else
@@ -174,90 +211,155 @@ void ImmersedBody::WriteBodyFormToTxt(const int time, const int body_id)
 	output_file.close();
 }
 
-void ImmersedBody::WriteBodyFormToVtk(std::string file_path, const int body_id, const int time)
+std::string ImmersedBody::WriteBodyFormToVtk(std::string file_path, const int body_id, const int time, VtkFormat const format, VtkPrecision const precision)
 {
-	std::string file_name = file_path + "\\body_form" + std::to_string(body_id) + "_t" + std::to_string(time) + ".vtk";
+	std::string file_name = file_path + "\\body_form" + std::to_string(body_id) + "_t" + std::to_string(time);
 
-	std::ofstream output_file;
-	output_file.open(file_name);
+	const std::vector<double> x(markers_->x_.begin() + begin_, markers_->x_.begin() + begin_ + nodes_num);
+	const std::vector<double> y(markers_->y_.begin() + begin_, markers_->y_.begin() + begin_ + nodes_num);
 
-	if (output_file.is_open())
+	return WriteVtkPolyline(file_name, x, y, format, precision);
+}
+
+void ImmersedBody::SaveState(CheckpointWriter & writer, const int body_id) const
+{
+	const std::string name = "body" + std::to_string(body_id);
+	IBMarkers const & markers = *markers_;
+
+	// Values of each node are stored together, so file does not depend on layout of IBMarkers
+	std::vector<double> values;
+	std::vector<int> types;
+	values.reserve(8 * nodes_num);
+	types.reserve(nodes_num);
+
+	for (int i = begin_; i < begin_ + nodes_num; ++i)
 	{
-		// Write VTK header
-		output_file << "# vtk DataFile Version 3.0\n";
-		output_file << "particle_state\n";
-		output_file << "ASCII\n";
-		output_file << "DATASET POLYDATA\n";
+		const double node_values[8]{ markers.y_[i], markers.x_[i], markers.ref_y_[i], markers.ref_x_[i],
+			markers.vx_[i], markers.vy_[i], markers.Fx_[i], markers.Fy_[i] };
+		values.insert(values.end(), node_values, node_values + 8);
+		types.push_back(static_cast<int>(markers.GetType(i)));
+	}
 
-		// Write node positions
-		output_file << "POINTS " << nodes_num << " float\n";
+	writer.Write(name + ".nodes_num", nodes_num);
+	writer.Write(name + ".values", values.data(), values.size());
+	writer.Write(name + ".types", types.data(), types.size());
+}
 
-		for (auto node : body_)
-			output_file << node.cur_pos_.x_ << " " << node.cur_pos_.y_ << " 0\n";
+bool ImmersedBody::LoadState(CheckpointReader const & reader, const int body_id)
+{
+	const std::string name = "body" + std::to_string(body_id);
+	int nodes_count = 0;
 
-		// Write lines between neighboring nodes
-		output_file << "LINES " << nodes_num << " " << 3 * nodes_num << "\n";
+	if (!reader.Read(name + ".nodes_num", nodes_count) || nodes_count != nodes_num)
+	{
+		std::cout << "Error! Checkpoint body " << body_id << " has " << nodes_count << " nodes instead of " << nodes_num << ".\n";
+		return false;
+	}
 
-		for (int i = 0; i < nodes_num; ++i)
-			output_file << "2 " << i << " " << (i + 1) % nodes_num << "\n";
+	std::vector<double> values(8 * nodes_num);
+	std::vector<int> types(nodes_num);
 
-		// Write vertices
-		output_file << "VERTICES 1 " << nodes_num + 1 << "\n";
-		output_file << nodes_num << " ";
+	if (!reader.Read(name + ".values", values.data(), values.size()) || !reader.Read(name + ".types", types.data(), types.size()))
+		return false;
 
-		for (int i = 0; i < nodes_num; ++i)
-			output_file << i << " ";
+	IBMarkers & markers = *markers_;
+
+	for (int id = 0; id < nodes_num; ++id)
+	{
+		const double * node_values = values.data() + 8 * id;
+		const int i = begin_ + id;
+
+		markers.y_[i] = node_values[0];
+		markers.x_[i] = node_values[1];
+		markers.ref_y_[i] = node_values[2];
+		markers.ref_x_[i] = node_values[3];
+		markers.vx_[i] = node_values[4];
+		markers.vy_[i] = node_values[5];
+		markers.Fx_[i] = node_values[6];
+		markers.Fy_[i] = node_values[7];
+		markers.SetType(i, static_cast<IBNodeType>(types[id]));
 	}
-	else
-		std::cout << "Error! Could not open file " << file_name << " to write form of immersed body. \n";
 
-	output_file.close();
+	return true;
 }
 
 void ImmersedBody::CalculateStrainForces()
 {
+	IBMarkers & markers = *markers_;
+	const double * x = markers.x_.data() + begin_;
+	const double * y = markers.y_.data() + begin_;
+	const double * ref_x = markers.ref_x_.data() + begin_;
+	const double * ref_y = markers.ref_y_.data() + begin_;
+	const unsigned char * type = markers.type_.data() + begin_;
+	double * Fx = markers.Fx_.data() + begin_;
+	double * Fy = markers.Fy_.data() + begin_;
+
+	double * strain_x = strain_x_.data();
+	double * strain_y = strain_y_.data();
+
+	// Forces of segments (i, i + 1), which start at moving nodes
 	for (int i = 0; i < nodes_num; ++i)
 	{
-		if (body_.at(i).type_ == IBNodeType::MOVING)
-		{
-			const double distance = SQ(body_.at(i).cur_pos_.x_ - body_.at((i + 1) % nodes_num).cur_pos_.x_) + SQ(body_.at(i).cur_pos_.y_ - body_.at((i + 1) % nodes_num).cur_pos_.y_);
-			const double distance_ref = SQ(body_.at(i).ref_pos_.x_ - body_.at((i + 1) % nodes_num).ref_pos_.x_) + SQ(body_.at(i).ref_pos_.y_ - body_.at((i + 1) % nodes_num).ref_pos_.y_);
+		const int next = (i + 1 < nodes_num) ? i + 1 : 0;
 
-			const double fx = stiffness_ * (distance - distance_ref) * (body_.at(i).cur_pos_.x_ - body_.at((i + 1) % nodes_num).cur_pos_.x_);
-			const double fy = stiffness_ * (distance - distance_ref) * (body_.at(i).cur_pos_.y_ - body_.at((i + 1) % nodes_num).cur_pos_.y_);
+		const double distance = SQ(x[i] - x[next]) + SQ(y[i] - y[next]);
+		const double distance_ref = SQ(ref_x[i] - ref_x[next]) + SQ(ref_y[i] - ref_y[next]);
 
-			// Signs of forces are chosen to satisfy third Newton law
-			body_.at(i).Fx_ += -fx;
-			body_.at(i).Fy_ += -fy;
+		const double factor = (type[i] & IBMarkers::kMovingMask) ? stiffness_ * (distance - distance_ref) : 0.0;
 
-			body_.at((i + 1) % nodes_num).Fx_ += fx;
-			body_.at((i + 1) % nodes_num).Fy_ += fy;
-		}
+		strain_x[i] = factor * (x[i] - x[next]);
+		strain_y[i] = factor * (y[i] - y[next]);
+	}
+
+	// Signs of forces are chosen to satisfy third Newton law: segment pulls its first node with '-f' and the second one with 'f'
+	for (int i = 0; i < nodes_num; ++i)
+	{
+		const int prev = (i > 0) ? i - 1 : nodes_num - 1;
+
+		Fx[i] = strain_x[prev] - strain_x[i];
+		Fy[i] = strain_y[prev] - strain_y[i];
 	}
 }
 
 void ImmersedBody::CalculateBendingForces()
 {
+	IBMarkers & markers = *markers_;
+	const double * x = markers.x_.data() + begin_;
+	const double * y = markers.y_.data() + begin_;
+	const double * ref_x = markers.ref_x_.data() + begin_;
+	const double * ref_y = markers.ref_y_.data() + begin_;
+	const unsigned char * type = markers.type_.data() + begin_;
+	double * Fx = markers.Fx_.data() + begin_;
+	double * Fy = markers.Fy_.data() + begin_;
+
+	// Forces of each moving node (hinge), acting on previous node, the node and next node
+	double * to_prev_x = bending_x_[0].data();
+	double * to_prev_y = bending_y_[0].data();
+	double * to_node_x = bending_x_[1].data();
+	double * to_node_y = bending_y_[1].data();
+	double * to_next_x = bending_x_[2].data();
+	double * to_next_y = bending_y_[2].data();
+
 	for (int i = 0; i < nodes_num; ++i)
 	{
-		if (body_.at(i).type_ == IBNodeType::MOVING)
+		if (type[i] & IBMarkers::kMovingMask)
 		{
-			int prevId = (i - 1 + nodes_num) % nodes_num;
-			int nextId = (i + 1) % nodes_num;
+			const int prevId = (i > 0) ? i - 1 : nodes_num - 1;
+			const int nextId = (i + 1 < nodes_num) ? i + 1 : 0;
 
-			const double x_l = body_.at(prevId).cur_pos_.x_;
-			const double y_l = body_.at(prevId).cur_pos_.y_;
-			const double x_m = body_.at(i).cur_pos_.x_;
-			const double y_m = body_.at(i).cur_pos_.y_;
-			const double x_r = body_.at(nextId).cur_pos_.x_;
-			const double y_r = body_.at(nextId).cur_pos_.y_;
+			const double x_l = x[prevId];
+			const double y_l = y[prevId];
+			const double x_m = x[i];
+			const double y_m = y[i];
+			const double x_r = x[nextId];
+			const double y_r = y[nextId];
 
-			const double x_l_ref = body_.at(prevId).ref_pos_.x_;
-			const double y_l_ref = body_.at(prevId).ref_pos_.y_;
-			const double x_m_ref = body_.at(i).ref_pos_.x_;
-			const double y_m_ref = body_.at(i).ref_pos_.y_;
-			const double x_r_ref = body_.at(nextId).ref_pos_.x_;
-			const double y_r_ref = body_.at(nextId).ref_pos_.y_;
+			const double x_l_ref = ref_x[prevId];
+			const double y_l_ref = ref_y[prevId];
+			const double x_m_ref = ref_x[i];
+			const double y_m_ref = ref_y[i];
+			const double x_r_ref = ref_x[nextId];
+			const double y_r_ref = ref_y[nextId];
 
 
 			// x- ,  l  r
@@ -357,15 +459,39 @@ void ImmersedBody::CalculateBendingForces()
 			const double length_l = abs(tang_x * (x_m - x_l) + tang_y * (y_m - y_l));
 			const double length_r = abs(tang_x * (x_m - x_r) + tang_y * (y_m - y_r));
 
-			body_.at(prevId).Fx_ += normal_x * force_mag * length_l / (length_l + length_r);
-			body_.at(prevId).Fy_ += normal_y * force_mag * length_l / (length_l + length_r);
+			to_prev_x[i] = normal_x * force_mag * length_l / (length_l + length_r);
+			to_prev_y[i] = normal_y * force_mag * length_l / (length_l + length_r);
 
-			body_.at(i).Fx_ += -normal_x * force_mag;
-			body_.at(i).Fy_ += -normal_y * force_mag;
+			to_node_x[i] = -normal_x * force_mag;
+			to_node_y[i] = -normal_y * force_mag;
 
-			body_.at(nextId).Fx_ += normal_x * force_mag * length_r / (length_l + length_r);
-			body_.at(nextId).Fy_ += normal_y * force_mag * length_r / (length_l + length_r);
+			to_next_x[i] = normal_x * force_mag * length_r / (length_l + length_r);
+			to_next_y[i] = normal_y * force_mag * length_r / (length_l + length_r);
 		}
+		else
+		{
+			to_prev_x[i] = to_node_x[i] = to_next_x[i] = 0.0;
+			to_prev_y[i] = to_node_y[i] = to_next_y[i] = 0.0;
+		}
+	}
+
+	// Node gets forces of previous hinge, of its own hinge and of next hinge in the same order, as if hinges added forces
+	// to their nodes one after another (the first and the last nodes get forces of hinges at the other end first)
+	for (int i = 1; i < nodes_num - 1; ++i)
+	{
+		Fx[i] = Fx[i] + to_next_x[i - 1] + to_node_x[i] + to_prev_x[i + 1];
+		Fy[i] = Fy[i] + to_next_y[i - 1] + to_node_y[i] + to_prev_y[i + 1];
+	}
+
+	if (nodes_num > 1)
+	{
+		const int last = nodes_num - 1;
+
+		Fx[0] = Fx[0] + to_node_x[0] + to_prev_x[1] + to_next_x[last];
+		Fy[0] = Fy[0] + to_node_y[0] + to_prev_y[1] + to_next_y[last];
+
+		Fx[last] = Fx[last] + to_prev_x[0] + to_next_x[last - 1] + to_node_x[last];
+		Fy[last] = Fy[last] + to_prev_y[0] + to_next_y[last - 1] + to_node_y[last];
 	}
 }
 
@@ -376,23 +502,14 @@ ImmersedRBC::ImmersedRBC(int domainX, int domainY, int nodesNumber, Point center
 {
 	for (int id = 0; id < nodes_num; ++id)
 	{
-		body_.at(id).type_ = IBNodeType::MOVING;
-
 		// Parametrization of the RBC shape in 2D
-		body_.at(id).cur_pos_.y_ = center.y_ + radius * sin(2. * M_PI * (double)id / nodes_num);
-		body_.at(id).ref_pos_.y_ = center.y_ + radius * sin(2. * M_PI * (double)id / nodes_num);
-		body_.at(id).cur_pos_.x_ = radius * cos(2. * M_PI * (double)id / nodes_num);
+		const double y = center.y_ + radius * sin(2. * M_PI * (double)id / nodes_num);
+		const double half_width = sqrt(1 - SQ((center.y_ - y) / radius)) * (0.207 + 2.00 * SQ((center.y_ - y) / radius) - 1.12 * SQ(SQ((center.y_ - y) / radius))) * radius / 2;
 
-		if (body_.at(id).cur_pos_.x_ > 0)
-		{
-			body_.at(id).cur_pos_.x_ = center.x_ + sqrt(1 - SQ((center.y_ - body_.at(id).cur_pos_.y_) / radius)) * (0.207 + 2.00 * SQ((center.y_ - body_.at(id).cur_pos_.y_) / radius) - 1.12 * SQ(SQ((center.y_ - body_.at(id).cur_pos_.y_) / radius))) * radius / 2;
-			body_.at(id).ref_pos_.x_ = center.x_ + sqrt(1 - SQ((center.y_ - body_.at(id).cur_pos_.y_) / radius)) * (0.207 + 2.00 * SQ((center.y_ - body_.at(id).cur_pos_.y_) / radius) - 1.12 * SQ(SQ((center.y_ - body_.at(id).cur_pos_.y_) / radius))) * radius / 2;
-		}
-		else 
-		{
-			body_.at(id).cur_pos_.x_ = center.x_ - sqrt(1 - SQ((center.y_ - body_.at(id).cur_pos_.y_) / radius)) * (0.207 + 2.00 * SQ((center.y_ - body_.at(id).cur_pos_.y_) / radius) - 1.12 * SQ(SQ((center.y_ - body_.at(id).cur_pos_.y_) / radius))) * radius / 2;
-			body_.at(id).ref_pos_.x_ = center.x_ - sqrt(1 - SQ((center.y_ - body_.at(id).cur_pos_.y_) / radius)) * (0.207 + 2.00 * SQ((center.y_ - body_.at(id).cur_pos_.y_) / radius) - 1.12 * SQ(SQ((center.y_ - body_.at(id).cur_pos_.y_) / radius))) * radius / 2;
-		}
+		if (radius * cos(2. * M_PI * (double)id / nodes_num) > 0)
+			SetNode(id, Point(y, center.x_ + half_width), IBNodeType::MOVING);
+		else
+			SetNode(id, Point(y, center.x_ - half_width), IBNodeType::MOVING);
 	}
 }
 
@@ -411,27 +528,14 @@ ImmersedCircle::ImmersedCircle(int domainX, int domainY, int nodesNumber, Point
 	// Fill circle
 	for (int id = 0; id < circleNumb; ++id)
 	{
-		body_.at(id).type_ = IBNodeType::STATIC;
-
 		// Parametrization of the circle shape in 2D
-		body_.at(id).cur_pos_.x_ = center_.x_ + radius_ * cos(startAngle + (double)id * angleStep);
-		body_.at(id).ref_pos_.x_ = body_.at(id).cur_pos_.x_;
-
-		body_.at(id).cur_pos_.y_ = center_.y_ + radius_ * sin(startAngle + (double)id * angleStep);
-		body_.at(id).ref_pos_.y_ = body_.at(id).cur_pos_.y_;
+		SetNode(id, Point(center_.y_ + radius_ * sin(startAngle + (double)id * angleStep), center_.x_ + radius_ * cos(startAngle + (double)id * angleStep)),
+			IBNodeType::STATIC);
 	}
 
 	// Add additional center node if user input not full circle
 	if (!isFullCircle)
-	{
-		body_.at(nodesNumber - 1).type_ = IBNodeType::STATIC;
-
-		body_.at(nodesNumber - 1).cur_pos_.x_ = center.x_;
-		body_.at(nodesNumber - 1).ref_pos_.x_ = center.x_;
-
-		body_.at(nodesNumber - 1).cur_pos_.y_ = center.y_;
-		body_.at(nodesNumber - 1).ref_pos_.y_ = center.y_;
-	}
+		SetNode(nodesNumber - 1, center, IBNodeType::STATIC);
 }
 
 
@@ -442,43 +546,18 @@ ImmersedRectangle::ImmersedRectangle(int domainX, int domainY, int nodesNumber,
 	const double yStep = height_ / pointToSide;
 
 	for (int y = 0; y < pointToSide; ++y)
-	{
-		body_.at(y).cur_pos_.x_ = rigth_top_.x_;
-		body_.at(y).cur_pos_.y_ = rigth_top_.y_ - y * yStep;
-
-		body_.at(y).ref_pos_.x_ = rigth_top_.x_;
-		body_.at(y).ref_pos_.y_ = rigth_top_.y_ - y * yStep;
-	}
+		SetNode(y, Point(rigth_top_.y_ - y * yStep, rigth_top_.x_), IBNodeType::STATIC);
 
 	for (int x = 0; x < pointToSide; ++x)
-	{
-		body_.at(pointToSide + x).cur_pos_.x_ = rigth_top_.x_ + x * xStep;
-		body_.at(pointToSide + x).cur_pos_.y_ = rigth_top_.y_ - height_;
-
-		body_.at(pointToSide + x).ref_pos_.x_ = rigth_top_.x_ + x * xStep;
-		body_.at(pointToSide + x).ref_pos_.y_ = rigth_top_.y_ - height_;
-	}
+		SetNode(pointToSide + x, Point(rigth_top_.y_ - height_, rigth_top_.x_ + x * xStep), IBNodeType::STATIC);
 
 	for (int y = 0; y < pointToSide; ++y)
-	{
-		body_.at(2 * pointToSide + y).cur_pos_.x_ = rigth_top_.x_ + width_;
-		body_.at(2 * pointToSide + y).cur_pos_.y_ = rigth_top_.y_ - height_ + y * yStep;
-
-		body_.at(2 * pointToSide + y).ref_pos_.x_ = rigth_top_.x_ + width_;
-		body_.at(2 * pointToSide + y).ref_pos_.y_ = rigth_top_.y_ - height_ + y * yStep;
-	}
+		SetNode(2 * pointToSide + y, Point(rigth_top_.y_ - height_ + y * yStep, rigth_top_.x_ + width_), IBNodeType::STATIC);
 
 	for (int x = 0; x < pointToSide; ++x)
-	{
-		body_.at(3 * pointToSide + x).cur_pos_.x_ = rigth_top_.x_ + width_ - x * xStep;
-		body_.at(3 * pointToSide + x).cur_pos_.y_ = rigth_top_.y_;
-
-		body_.at(3 * pointToSide + x).ref_pos_.x_ = rigth_top_.x_ + width_ - x * xStep;
-		body_.at(3 * pointToSide + x).ref_pos_.y_ = rigth_top_.y_;
-	}
+		SetNode(3 * pointToSide + x, Point(rigth_top_.y_, rigth_top_.x_ + width_ - x * xStep), IBNodeType::STATIC);
 
-	for (auto & node : body_)
-		node.type_ = IBNodeType::STATIC;
+	// Remaining nodes (if number of nodes is not divisible by 4) stay static at origin
 }
 
 //ImmersedBottomTromb::ImmersedBottomTromb(int domainX, int domainY, int nodesNumber, Point center, double radius) : ImmersedBody(domainX, domainY, nodesNumber, center, radius)
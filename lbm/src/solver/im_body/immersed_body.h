@@ -12,6 +12,7 @@
 
 #include"..\..\modeling_area\fluid.h"
 #include"..\..\modeling_area\medium.h"
+#include"ib_markers.h"
 
 # define M_PI 3.14159265358979323846  /* pi */
 #define SQ(x) ((x) * (x)) // square function; replaces SQ(x) by ((x) * (x)) in the code
@@ -26,33 +27,18 @@ struct Point
 	Point(double y, double x) : y_(y), x_(x) {}
 };
 
-//! Type of immersed body node
-enum class IBNodeType
+//! Two-point interpolation stencil of immersed body node: 2x2 fluid nodes around the node and their weights
+struct IBStencil
 {
-	STATIC = 0,	// fixed position in space
-	MOVING = 1,	// position could change
-};
-
-//! Single node of immersed in fluid body
-struct IBNode
-{
-	//! Current node position
-	Point cur_pos_;
-	//! Reference node position
-	Point ref_pos_;
-
-	//! Node velocity along x-axis
-	double vx_;
-	//! Node velocity along y-axis
-	double vy_;
-	//! Elastic force, acting on the node along x-axis
-	double Fx_;
-	//! Elastic force, acting on the node along y-axis
-	double Fy_;
-	//! Type of node (static/moving)
-	IBNodeType type_;
-
-	IBNode() : cur_pos_(), ref_pos_(), vx_(0.0), vy_(0.0), Fx_(0.0), Fy_(0.0), type_(IBNodeType::STATIC) {}
+	//! Columns of fluid nodes (modeling area is periodic along x-axis)
+	int x_[2];
+	//! Rows of fluid nodes
+	int y_[2];
+	//! Interpolation weights of columns and rows
+	double weight_x_[2];
+	double weight_y_[2];
+
+	IBStencil(Point const & pos, int const domain_x);
 };
 
 //! Abstract class of immersed in fluid body
@@ -74,55 +60,19 @@ public:
 	//! Update immersed body current position
 	void UpdatePosition();
 
+	//! Moves nodes to common set of nodes 'markers' of all bodies of solver
+	void AttachTo(std::shared_ptr<IBMarkers> const & markers);
 
 	//! Writes data about boundary of immersed body to *.txt file
 	void WriteBodyFormToTxt(const int time, const int body_id);
-	//! Writes data about boundary of immersed body to *.vtk file
-	void WriteBodyFormToVtk(std::string file_path, const int body_id, const int time);
-
-	//! First bad version of RBC-Wall interaction
-	friend void Interaction(ImmersedBody* moving_body, ImmersedBody* static_body)
-	{
-		double rc = 1;
-		double kr = 0.005;
-
-		for (int i = 0; i < moving_body->body_.size(); ++i)
-		{
-			double move_pos_x = moving_body->body_.at(i).cur_pos_.x_;
-			double move_pos_y = moving_body->body_.at(i).cur_pos_.y_;
-
-			double static_pos_x = static_body->body_.at(0).cur_pos_.x_;
-			double static_pos_y = static_body->body_.at(0).cur_pos_.y_;
-
-			double min_distance = SQ(move_pos_x - static_pos_x) + SQ(move_pos_y - static_pos_y);
-
-			for (int j = 1; j < static_body->body_.size(); ++j)
-			{
-				double static_pos_x = static_body->body_.at(j).cur_pos_.x_;
-				double static_pos_y = static_body->body_.at(j).cur_pos_.y_;
-
-				double cur_distance = SQ(move_pos_x - static_pos_x) + SQ(move_pos_y - static_pos_y);
-
-				if (cur_distance < min_distance)
-					min_distance = cur_distance;
-			}
-			
-			min_distance = sqrt(min_distance);
-
-			for (int j = 0; j < static_body->body_.size(); ++j)
-			{
-				double x = move_pos_x - static_body->body_.at(j).cur_pos_.x_;
-				double y = move_pos_y - static_body->body_.at(j).cur_pos_.y_;
+	//! Writes data about boundary of immersed body to binary VTK file (*.vtk or *.vtp), returns full name of written file
+	std::string WriteBodyFormToVtk(std::string file_path, const int body_id, const int time, VtkFormat const format = VtkFormat::XML_APPENDED,
+		VtkPrecision const precision = VtkPrecision::FLOAT32);
 
-				if (SQ(x) + SQ(y) < rc)
-				{
-					moving_body->body_.at(i).Fx_ += kr * x / abs(pow(min_distance, 3));
-					moving_body->body_.at(i).Fy_ += kr * y / abs(pow(min_distance, 3));
-				}
-			}
-
-		}
-	}
+	//! Writes state of all nodes to checkpoint sections "body'body_id'.*"
+	void SaveState(CheckpointWriter & writer, const int body_id) const;
+	//! Reads state of nodes, written by SaveState(). Returns false if checkpoint body has other number of nodes
+	bool LoadState(CheckpointReader const & reader, const int body_id);
 
 protected:
 
@@ -133,6 +83,9 @@ protected:
 	//! Performs calculation of bending forces for all nodes of immersed body
 	void CalculateBendingForces();
 
+	//! Sets current and reference position 'pos' and type 'type' of node 'id'
+	void SetNode(int const id, Point const & pos, IBNodeType const type);
+
 protected:
 
 	int domain_x_;
@@ -149,9 +102,17 @@ protected:
 	//! Center position of body
 	Point center_;
 
-	//! Nodes of Lagragian greed
-	std::vector<IBNode> body_;
-
+	//! Set of nodes, which contains nodes of this body (could be shared with other bodies)
+	std::shared_ptr<IBMarkers> markers_;
+	//! The first node of this body in 'markers_'
+	int begin_;
+
+	//! Strain forces of segments between nodes i and i + 1
+	std::vector<double> strain_x_;
+	std::vector<double> strain_y_;
+	//! Bending forces of each node, acting on previous node, the node and next node
+	std::vector<double> bending_x_[3];
+	std::vector<double> bending_y_[3];
 };
 
 
@@ -277,12 +238,14 @@ public:
 			{
 				double totalValue = 0.0;
 
-				for (auto node : imBody->body_)
+				IBMarkers const & markers = *imBody->markers_;
+
+				for (int i = imBody->begin_; i < imBody->begin_ + imBody->nodes_num; ++i)
 				{
 					std::vector<std::pair<int, int>> ids;
 
-					double curX = node.cur_pos_.x_;
-					double curY = node.cur_pos_.y_;
+					double curX = markers.x_[i];
+					double curY = markers.y_[i];
 
 					// Check if position is integer values (in this case it match with eulerian grid node)
 					bool isYinteger = (curY == ceil(curY)) ? true : false;
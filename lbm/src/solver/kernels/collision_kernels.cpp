@@ -0,0 +1,544 @@
+#include"collision_kernels.h"
+
+#include<string>
+
+#if defined(_M_X64) || defined(__x86_64__)
+	#define LBM_SIMD_X86
+	#include<immintrin.h>
+	#if defined(_MSC_VER)
+		#include<intrin.h>
+	#endif
+#endif
+
+// Results of vectorized and scalar kernels must be bit-identical, so multiplication and addition must not be fused (FMA)
+#if defined(__GNUC__) && !defined(__clang__)
+	#pragma GCC optimize("fp-contract=off")
+#endif
+
+// MSVC allows intrinsics of any instruction set in any function, GCC and Clang need target attribute
+#if defined(LBM_SIMD_X86) && !defined(_MSC_VER)
+	#define LBM_TARGET_AVX2 __attribute__((target("avx2")))
+	#define LBM_TARGET_AVX512 __attribute__((target("avx512f")))
+#else
+	#define LBM_TARGET_AVX2
+	#define LBM_TARGET_AVX512
+#endif
+
+
+#pragma region Instruction set
+
+SimdLevel DetectSimdLevel()
+{
+#if defined(LBM_SIMD_X86) && defined(_MSC_VER)
+	int info[4];
+
+	__cpuid(info, 0);
+	if (info[0] < 7)
+		return SimdLevel::SCALAR;
+
+	// Processor supports AVX and operating system saves its registers (OSXSAVE)
+	__cpuid(info, 1);
+	if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0)
+		return SimdLevel::SCALAR;
+
+	const unsigned long long xcr0 = _xgetbv(0);
+	const bool is_ymm_saved = (xcr0 & 0x6) == 0x6;
+	const bool is_zmm_saved = (xcr0 & 0xe6) == 0xe6;
+
+	__cpuidex(info, 7, 0);
+	const bool is_avx2 = (info[1] & (1 << 5)) != 0;
+	const bool is_avx512 = (info[1] & (1 << 16)) != 0;
+
+	if (is_avx512 && is_zmm_saved)
+		return SimdLevel::AVX512;
+	if (is_avx2 && is_ymm_saved)
+		return SimdLevel::AVX2;
+
+	return SimdLevel::SCALAR;
+#elif defined(LBM_SIMD_X86)
+	__builtin_cpu_init();
+
+	if (__builtin_cpu_supports("avx512f"))
+		return SimdLevel::AVX512;
+	if (__builtin_cpu_supports("avx2"))
+		return SimdLevel::AVX2;
+
+	return SimdLevel::SCALAR;
+#else
+	return SimdLevel::SCALAR;
+#endif
+}
+
+//! Instruction set, used by collision kernels
+static SimdLevel & CurrentSimdLevel()
+{
+	static SimdLevel level = DetectSimdLevel();
+	return level;
+}
+
+SimdLevel GetSimdLevel()
+{
+	return CurrentSimdLevel();
+}
+
+void SetSimdLevel(SimdLevel const level)
+{
+	const SimdLevel supported = DetectSimdLevel();
+	CurrentSimdLevel() = (static_cast<int>(level) <= static_cast<int>(supported)) ? level : supported;
+}
+
+std::string ToString(SimdLevel const level)
+{
+	switch (level)
+	{
+	case SimdLevel::AVX2:
+		return "AVX2";
+	case SimdLevel::AVX512:
+		return "AVX-512";
+	default:
+		return "scalar";
+	}
+}
+
+#pragma endregion
+
+
+#pragma region SRT
+
+//! Scalar reference implementation of SRT collision
+static void CollideSRTScalar(double * const f[kQ], double * rho, double * vx, double * vy, int const begin, int const end, double const tau)
+{
+	for (int i = begin; i < end; ++i)
+	{
+		double f_node[kQ];
+		for (int q = 0; q < kQ; ++q)
+			f_node[q] = f[q][i];
+
+		double cur_rho, cur_vx, cur_vy;
+		NodeMacroscopic(f_node, cur_rho, cur_vx, cur_vy);
+
+		rho[i] = cur_rho;
+		vx[i] = cur_vx;
+		vy[i] = cur_vy;
+
+		for (int q = 0; q < kQ; ++q)
+			f[q][i] = f_node[q] + (Equilibrium(q, cur_rho, cur_vx, cur_vy) - f_node[q]) / tau;
+	}
+}
+
+#ifdef LBM_SIMD_X86
+
+//! AVX2 implementation of SRT collision: 4 nodes at once, the rest nodes are processed by scalar implementation
+LBM_TARGET_AVX2 static void CollideSRTAvx2(double * const f[kQ], double * rho, double * vx, double * vy, int const begin, int const end, double const tau)
+{
+	const __m256d zero = _mm256_setzero_pd();
+	const __m256d one = _mm256_set1_pd(1.0);
+	const __m256d c3 = _mm256_set1_pd(3.0);
+	const __m256d c4_5 = _mm256_set1_pd(4.5);
+	const __m256d c1_5 = _mm256_set1_pd(1.5);
+	const __m256d tau_v = _mm256_set1_pd(tau);
+
+	int i = begin;
+	for (; i + 4 <= end; i += 4)
+	{
+		__m256d f_node[kQ];
+		for (int q = 0; q < kQ; ++q)
+			f_node[q] = _mm256_loadu_pd(f[q] + i);
+
+		// Same order of operations as in NodeMacroscopic()
+		__m256d cur_rho = zero;
+		__m256d cur_vx = zero;
+		__m256d cur_vy = zero;
+
+		for (int q = 0; q < kQ; ++q)
+			cur_rho = _mm256_add_pd(cur_rho, f_node[q]);
+		for (int q = 0; q < kQ; ++q)
+			cur_vx = _mm256_add_pd(cur_vx, _mm256_mul_pd(f_node[q], _mm256_set1_pd(kEx[q])));
+		for (int q = 0; q < kQ; ++q)
+			cur_vy = _mm256_add_pd(cur_vy, _mm256_mul_pd(f_node[q], _mm256_set1_pd(kEy[q])));
+
+		const __m256d is_rho_zero = _mm256_cmp_pd(cur_rho, zero, _CMP_EQ_OQ);
+		const __m256d is_vx_zero = _mm256_and_pd(is_rho_zero, _mm256_cmp_pd(cur_vx, zero, _CMP_EQ_OQ));
+		const __m256d is_vy_zero = _mm256_and_pd(is_rho_zero, _mm256_cmp_pd(cur_vy, zero, _CMP_EQ_OQ));
+		cur_vx = _mm256_blendv_pd(_mm256_div_pd(cur_vx, cur_rho), zero, is_vx_zero);
+		cur_vy = _mm256_blendv_pd(_mm256_div_pd(cur_vy, cur_rho), zero, is_vy_zero);
+
+		_mm256_storeu_pd(rho + i, cur_rho);
+		_mm256_storeu_pd(vx + i, cur_vx);
+		_mm256_storeu_pd(vy + i, cur_vy);
+
+		// Same order of operations as in Equilibrium()
+		const __m256d v_sq = _mm256_add_pd(_mm256_mul_pd(cur_vx, cur_vx), _mm256_mul_pd(cur_vy, cur_vy));
+
+		for (int q = 0; q < kQ; ++q)
+		{
+			const __m256d v = _mm256_add_pd(_mm256_mul_pd(cur_vx, _mm256_set1_pd(kEx[q])), _mm256_mul_pd(cur_vy, _mm256_set1_pd(kEy[q])));
+
+			__m256d feq = _mm256_add_pd(one, _mm256_mul_pd(c3, v));
+			feq = _mm256_add_pd(feq, _mm256_mul_pd(c4_5, _mm256_mul_pd(v, v)));
+			feq = _mm256_sub_pd(feq, _mm256_mul_pd(c1_5, v_sq));
+			feq = _mm256_mul_pd(_mm256_set1_pd(kW[q]), _mm256_mul_pd(cur_rho, feq));
+
+			const __m256d f_post = _mm256_add_pd(f_node[q], _mm256_div_pd(_mm256_sub_pd(feq, f_node[q]), tau_v));
+			_mm256_storeu_pd(f[q] + i, f_post);
+		}
+	}
+
+	CollideSRTScalar(f, rho, vx, vy, i, end, tau);
+}
+
+//! AVX-512 implementation of SRT collision: 8 nodes at once, the rest nodes are processed by scalar implementation
+LBM_TARGET_AVX512 static void CollideSRTAvx512(double * const f[kQ], double * rho, double * vx, double * vy, int const begin, int const end, double const tau)
+{
+	const __m512d zero = _mm512_setzero_pd();
+	const __m512d one = _mm512_set1_pd(1.0);
+	const __m512d c3 = _mm512_set1_pd(3.0);
+	const __m512d c4_5 = _mm512_set1_pd(4.5);
+	const __m512d c1_5 = _mm512_set1_pd(1.5);
+	const __m512d tau_v = _mm512_set1_pd(tau);
+
+	int i = begin;
+	for (; i + 8 <= end; i += 8)
+	{
+		__m512d f_node[kQ];
+		for (int q = 0; q < kQ; ++q)
+			f_node[q] = _mm512_loadu_pd(f[q] + i);
+
+		// Same order of operations as in NodeMacroscopic()
+		__m512d cur_rho = zero;
+		__m512d cur_vx = zero;
+		__m512d cur_vy = zero;
+
+		for (int q = 0; q < kQ; ++q)
+			cur_rho = _mm512_add_pd(cur_rho, f_node[q]);
+		for (int q = 0; q < kQ; ++q)
+			cur_vx = _mm512_add_pd(cur_vx, _mm512_mul_pd(f_node[q], _mm512_set1_pd(kEx[q])));
+		for (int q = 0; q < kQ; ++q)
+			cur_vy = _mm512_add_pd(cur_vy, _mm512_mul_pd(f_node[q], _mm512_set1_pd(kEy[q])));
+
+		const __mmask8 is_rho_zero = _mm512_cmp_pd_mask(cur_rho, zero, _CMP_EQ_OQ);
+		const __mmask8 is_vx_zero = is_rho_zero & _mm512_cmp_pd_mask(cur_vx, zero, _CMP_EQ_OQ);
+		const __mmask8 is_vy_zero = is_rho_zero & _mm512_cmp_pd_mask(cur_vy, zero, _CMP_EQ_OQ);
+		cur_vx = _mm512_mask_blend_pd(is_vx_zero, _mm512_div_pd(cur_vx, cur_rho), zero);
+		cur_vy = _mm512_mask_blend_pd(is_vy_zero, _mm512_div_pd(cur_vy, cur_rho), zero);
+
+		_mm512_storeu_pd(rho + i, cur_rho);
+		_mm512_storeu_pd(vx + i, cur_vx);
+		_mm512_storeu_pd(vy + i, cur_vy);
+
+		// Same order of operations as in Equilibrium()
+		const __m512d v_sq = _mm512_add_pd(_mm512_mul_pd(cur_vx, cur_vx), _mm512_mul_pd(cur_vy, cur_vy));
+
+		for (int q = 0; q < kQ; ++q)
+		{
+			const __m512d v = _mm512_add_pd(_mm512_mul_pd(cur_vx, _mm512_set1_pd(kEx[q])), _mm512_mul_pd(cur_vy, _mm512_set1_pd(kEy[q])));
+
+			__m512d feq = _mm512_add_pd(one, _mm512_mul_pd(c3, v));
+			feq = _mm512_add_pd(feq, _mm512_mul_pd(c4_5, _mm512_mul_pd(v, v)));
+			feq = _mm512_sub_pd(feq, _mm512_mul_pd(c1_5, v_sq));
+			feq = _mm512_mul_pd(_mm512_set1_pd(kW[q]), _mm512_mul_pd(cur_rho, feq));
+
+			const __m512d f_post = _mm512_add_pd(f_node[q], _mm512_div_pd(_mm512_sub_pd(feq, f_node[q]), tau_v));
+			_mm512_storeu_pd(f[q] + i, f_post);
+		}
+	}
+
+	CollideSRTScalar(f, rho, vx, vy, i, end, tau);
+}
+
+#endif // LBM_SIMD_X86
+
+void CollideSRT(double * const f[kQ], double * rho, double * vx, double * vy, int const begin, int const end, double const tau)
+{
+	switch (GetSimdLevel())
+	{
+#ifdef LBM_SIMD_X86
+	case SimdLevel::AVX512:
+		CollideSRTAvx512(f, rho, vx, vy, begin, end, tau);
+		break;
+	case SimdLevel::AVX2:
+		CollideSRTAvx2(f, rho, vx, vy, begin, end, tau);
+		break;
+#endif
+	default:
+		CollideSRTScalar(f, rho, vx, vy, begin, end, tau);
+		break;
+	}
+}
+
+#pragma endregion
+
+
+#pragma region MRT
+
+// Moments of D2Q9 model (A.A. Mohammad 2012): m = M * f = (rho, e, eps, jx, qx, jy, qy, pxx, pxy). Each row of M contains
+// only 0, +-1, +-2 and +-4 and each row of M^{-1} contains only multiples of 1/36, so both transforms are written explicitly
+// through partial sums of populations instead of kQ x kQ matrix products. Density and momentum are conserved, so only
+// six other moments are relaxed and transformed back. Macroscopic values are calculated from populations in the same pass.
+
+//! Scalar reference implementation of MRT collision
+static void CollideMRTScalar(double * const f[kQ], double * rho, double * vx, double * vy, int const begin, int const end, const double * S)
+{
+	// Relaxation rates are divided by the common denominator of M^{-1} elements
+	const double s1 = S[1] / 36.0;
+	const double s2 = S[2] / 36.0;
+	const double s4 = S[4] / 36.0;
+	const double s6 = S[6] / 36.0;
+	const double s7 = S[7] / 36.0;
+	const double s8 = S[8] / 36.0;
+
+	for (int i = begin; i < end; ++i)
+	{
+		double f_node[kQ];
+		for (int q = 0; q < kQ; ++q)
+			f_node[q] = f[q][i];
+
+		// Partial sums of populations, which are shared by moments
+		const double axis_sum = (f_node[1] + f_node[3]) + (f_node[2] + f_node[4]);
+		const double diag_sum = (f_node[5] + f_node[7]) + (f_node[6] + f_node[8]);
+		const double x_axis = f_node[1] - f_node[3];
+		const double x_diag = (f_node[5] - f_node[6]) - (f_node[7] - f_node[8]);
+		const double y_axis = f_node[2] - f_node[4];
+		const double y_diag = (f_node[5] + f_node[6]) - (f_node[7] + f_node[8]);
+
+		const double cur_rho = f_node[0] + axis_sum + diag_sum;
+		const double jx = x_axis + x_diag;
+		const double jy = y_axis + y_diag;
+
+		// Boundaries consist from 0, see NodeMacroscopic()
+		const double cur_vx = (cur_rho == 0.0 && jx == 0.0) ? 0.0 : jx / cur_rho;
+		const double cur_vy = (cur_rho == 0.0 && jy == 0.0) ? 0.0 : jy / cur_rho;
+
+		rho[i] = cur_rho;
+		vx[i] = cur_vx;
+		vy[i] = cur_vy;
+
+		const double vxSq = cur_vx * cur_vx;
+		const double vySq = cur_vy * cur_vy;
+		const double vSq = vxSq + vySq;
+
+		// Relaxed differences (m - m_eq) of non-conserved moments, divided by 36
+		const double t1 = s1 * ((2.0 * diag_sum - axis_sum - 4.0 * f_node[0]) - cur_rho * (vSq * 3.0 + -2.0));
+		const double t2 = s2 * ((4.0 * f_node[0] + diag_sum - 2.0 * axis_sum) - cur_rho * (vSq * -3.0 + 1.0));
+		const double t4 = s4 * ((x_diag - 2.0 * x_axis) + cur_rho * cur_vx);
+		const double t6 = s6 * ((y_diag - 2.0 * y_axis) + cur_rho * cur_vy);
+		const double t7 = s7 * (((f_node[1] + f_node[3]) - (f_node[2] + f_node[4])) - cur_rho * (vxSq - vySq));
+		const double t8 = s8 * (((f_node[5] + f_node[7]) - (f_node[6] + f_node[8])) - cur_rho * (cur_vx * cur_vy));
+
+		// Performs f = f - M^{-1} * (S * dm) row by row (rows of the same type of directions share partial sums)
+		const double axis_part = t1 + 2.0 * t2;
+		const double axis_x = axis_part - 9.0 * t7;
+		const double axis_y = axis_part + 9.0 * t7;
+		const double diag_part = 2.0 * t1 + t2;
+		const double diag_px = diag_part + 3.0 * t4;
+		const double diag_mx = diag_part - 3.0 * t4;
+		const double diag_pp = 3.0 * t6 + 9.0 * t8;
+		const double diag_pm = 3.0 * t6 - 9.0 * t8;
+
+		f[0][i] = f_node[0] - 4.0 * (t2 - t1);
+		f[1][i] = f_node[1] + (axis_x + 6.0 * t4);
+		f[2][i] = f_node[2] + (axis_y + 6.0 * t6);
+		f[3][i] = f_node[3] + (axis_x - 6.0 * t4);
+		f[4][i] = f_node[4] + (axis_y - 6.0 * t6);
+		f[5][i] = f_node[5] - (diag_px + diag_pp);
+		f[6][i] = f_node[6] - (diag_mx + diag_pm);
+		f[7][i] = f_node[7] - (diag_mx - diag_pm);
+		f[8][i] = f_node[8] - (diag_px - diag_pp);
+	}
+}
+
+#ifdef LBM_SIMD_X86
+
+//! AVX2 implementation of MRT collision: 4 nodes at once, the rest nodes are processed by scalar implementation
+LBM_TARGET_AVX2 static void CollideMRTAvx2(double * const f[kQ], double * rho, double * vx, double * vy, int const begin, int const end, const double * S)
+{
+	const __m256d zero = _mm256_setzero_pd();
+	const __m256d s1 = _mm256_set1_pd(S[1] / 36.0);
+	const __m256d s2 = _mm256_set1_pd(S[2] / 36.0);
+	const __m256d s4 = _mm256_set1_pd(S[4] / 36.0);
+	const __m256d s6 = _mm256_set1_pd(S[6] / 36.0);
+	const __m256d s7 = _mm256_set1_pd(S[7] / 36.0);
+	const __m256d s8 = _mm256_set1_pd(S[8] / 36.0);
+	const __m256d c2 = _mm256_set1_pd(2.0);
+	const __m256d c3 = _mm256_set1_pd(3.0);
+	const __m256d c4 = _mm256_set1_pd(4.0);
+	const __m256d c6 = _mm256_set1_pd(6.0);
+	const __m256d c9 = _mm256_set1_pd(9.0);
+
+	int i = begin;
+	for (; i + 4 <= end; i += 4)
+	{
+		__m256d f_node[kQ];
+		for (int q = 0; q < kQ; ++q)
+			f_node[q] = _mm256_loadu_pd(f[q] + i);
+
+		// Same order of operations as in scalar implementation
+		const __m256d axis_sum = _mm256_add_pd(_mm256_add_pd(f_node[1], f_node[3]), _mm256_add_pd(f_node[2], f_node[4]));
+		const __m256d diag_sum = _mm256_add_pd(_mm256_add_pd(f_node[5], f_node[7]), _mm256_add_pd(f_node[6], f_node[8]));
+		const __m256d x_axis = _mm256_sub_pd(f_node[1], f_node[3]);
+		const __m256d x_diag = _mm256_sub_pd(_mm256_sub_pd(f_node[5], f_node[6]), _mm256_sub_pd(f_node[7], f_node[8]));
+		const __m256d y_axis = _mm256_sub_pd(f_node[2], f_node[4]);
+		const __m256d y_diag = _mm256_sub_pd(_mm256_add_pd(f_node[5], f_node[6]), _mm256_add_pd(f_node[7], f_node[8]));
+
+		const __m256d cur_rho = _mm256_add_pd(_mm256_add_pd(f_node[0], axis_sum), diag_sum);
+		const __m256d jx = _mm256_add_pd(x_axis, x_diag);
+		const __m256d jy = _mm256_add_pd(y_axis, y_diag);
+
+		const __m256d is_rho_zero = _mm256_cmp_pd(cur_rho, zero, _CMP_EQ_OQ);
+		const __m256d is_vx_zero = _mm256_and_pd(is_rho_zero, _mm256_cmp_pd(jx, zero, _CMP_EQ_OQ));
+		const __m256d is_vy_zero = _mm256_and_pd(is_rho_zero, _mm256_cmp_pd(jy, zero, _CMP_EQ_OQ));
+		const __m256d cur_vx = _mm256_blendv_pd(_mm256_div_pd(jx, cur_rho), zero, is_vx_zero);
+		const __m256d cur_vy = _mm256_blendv_pd(_mm256_div_pd(jy, cur_rho), zero, is_vy_zero);
+
+		_mm256_storeu_pd(rho + i, cur_rho);
+		_mm256_storeu_pd(vx + i, cur_vx);
+		_mm256_storeu_pd(vy + i, cur_vy);
+
+		const __m256d vxSq = _mm256_mul_pd(cur_vx, cur_vx);
+		const __m256d vySq = _mm256_mul_pd(cur_vy, cur_vy);
+		const __m256d vSq = _mm256_add_pd(vxSq, vySq);
+
+		const __m256d m1 = _mm256_sub_pd(_mm256_sub_pd(_mm256_mul_pd(c2, diag_sum), axis_sum), _mm256_mul_pd(c4, f_node[0]));
+		const __m256d m2 = _mm256_sub_pd(_mm256_add_pd(_mm256_mul_pd(c4, f_node[0]), diag_sum), _mm256_mul_pd(c2, axis_sum));
+		const __m256d m4 = _mm256_sub_pd(x_diag, _mm256_mul_pd(c2, x_axis));
+		const __m256d m6 = _mm256_sub_pd(y_diag, _mm256_mul_pd(c2, y_axis));
+		const __m256d m7 = _mm256_sub_pd(_mm256_add_pd(f_node[1], f_node[3]), _mm256_add_pd(f_node[2], f_node[4]));
+		const __m256d m8 = _mm256_sub_pd(_mm256_add_pd(f_node[5], f_node[7]), _mm256_add_pd(f_node[6], f_node[8]));
+
+		const __m256d t1 = _mm256_mul_pd(s1, _mm256_sub_pd(m1, _mm256_mul_pd(cur_rho, _mm256_add_pd(_mm256_mul_pd(vSq, c3), _mm256_set1_pd(-2.0)))));
+		const __m256d t2 = _mm256_mul_pd(s2, _mm256_sub_pd(m2, _mm256_mul_pd(cur_rho, _mm256_add_pd(_mm256_mul_pd(vSq, _mm256_set1_pd(-3.0)), _mm256_set1_pd(1.0)))));
+		const __m256d t4 = _mm256_mul_pd(s4, _mm256_add_pd(m4, _mm256_mul_pd(cur_rho, cur_vx)));
+		const __m256d t6 = _mm256_mul_pd(s6, _mm256_add_pd(m6, _mm256_mul_pd(cur_rho, cur_vy)));
+		const __m256d t7 = _mm256_mul_pd(s7, _mm256_sub_pd(m7, _mm256_mul_pd(cur_rho, _mm256_sub_pd(vxSq, vySq))));
+		const __m256d t8 = _mm256_mul_pd(s8, _mm256_sub_pd(m8, _mm256_mul_pd(cur_rho, _mm256_mul_pd(cur_vx, cur_vy))));
+
+		const __m256d axis_part = _mm256_add_pd(t1, _mm256_mul_pd(c2, t2));
+		const __m256d axis_x = _mm256_sub_pd(axis_part, _mm256_mul_pd(c9, t7));
+		const __m256d axis_y = _mm256_add_pd(axis_part, _mm256_mul_pd(c9, t7));
+		const __m256d diag_part = _mm256_add_pd(_mm256_mul_pd(c2, t1), t2);
+		const __m256d diag_px = _mm256_add_pd(diag_part, _mm256_mul_pd(c3, t4));
+		const __m256d diag_mx = _mm256_sub_pd(diag_part, _mm256_mul_pd(c3, t4));
+		const __m256d diag_pp = _mm256_add_pd(_mm256_mul_pd(c3, t6), _mm256_mul_pd(c9, t8));
+		const __m256d diag_pm = _mm256_sub_pd(_mm256_mul_pd(c3, t6), _mm256_mul_pd(c9, t8));
+
+		_mm256_storeu_pd(f[0] + i, _mm256_sub_pd(f_node[0], _mm256_mul_pd(c4, _mm256_sub_pd(t2, t1))));
+		_mm256_storeu_pd(f[1] + i, _mm256_add_pd(f_node[1], _mm256_add_pd(axis_x, _mm256_mul_pd(c6, t4))));
+		_mm256_storeu_pd(f[2] + i, _mm256_add_pd(f_node[2], _mm256_add_pd(axis_y, _mm256_mul_pd(c6, t6))));
+		_mm256_storeu_pd(f[3] + i, _mm256_add_pd(f_node[3], _mm256_sub_pd(axis_x, _mm256_mul_pd(c6, t4))));
+		_mm256_storeu_pd(f[4] + i, _mm256_add_pd(f_node[4], _mm256_sub_pd(axis_y, _mm256_mul_pd(c6, t6))));
+		_mm256_storeu_pd(f[5] + i, _mm256_sub_pd(f_node[5], _mm256_add_pd(diag_px, diag_pp)));
+		_mm256_storeu_pd(f[6] + i, _mm256_sub_pd(f_node[6], _mm256_add_pd(diag_mx, diag_pm)));
+		_mm256_storeu_pd(f[7] + i, _mm256_sub_pd(f_node[7], _mm256_sub_pd(diag_mx, diag_pm)));
+		_mm256_storeu_pd(f[8] + i, _mm256_sub_pd(f_node[8], _mm256_sub_pd(diag_px, diag_pp)));
+	}
+
+	CollideMRTScalar(f, rho, vx, vy, i, end, S);
+}
+
+//! AVX-512 implementation of MRT collision: 8 nodes at once, the rest nodes are processed by scalar implementation
+LBM_TARGET_AVX512 static void CollideMRTAvx512(double * const f[kQ], double * rho, double * vx, double * vy, int const begin, int const end, const double * S)
+{
+	const __m512d zero = _mm512_setzero_pd();
+	const __m512d s1 = _mm512_set1_pd(S[1] / 36.0);
+	const __m512d s2 = _mm512_set1_pd(S[2] / 36.0);
+	const __m512d s4 = _mm512_set1_pd(S[4] / 36.0);
+	const __m512d s6 = _mm512_set1_pd(S[6] / 36.0);
+	const __m512d s7 = _mm512_set1_pd(S[7] / 36.0);
+	const __m512d s8 = _mm512_set1_pd(S[8] / 36.0);
+	const __m512d c2 = _mm512_set1_pd(2.0);
+	const __m512d c3 = _mm512_set1_pd(3.0);
+	const __m512d c4 = _mm512_set1_pd(4.0);
+	const __m512d c6 = _mm512_set1_pd(6.0);
+	const __m512d c9 = _mm512_set1_pd(9.0);
+
+	int i = begin;
+	for (; i + 8 <= end; i += 8)
+	{
+		__m512d f_node[kQ];
+		for (int q = 0; q < kQ; ++q)
+			f_node[q] = _mm512_loadu_pd(f[q] + i);
+
+		// Same order of operations as in scalar implementation
+		const __m512d axis_sum = _mm512_add_pd(_mm512_add_pd(f_node[1], f_node[3]), _mm512_add_pd(f_node[2], f_node[4]));
+		const __m512d diag_sum = _mm512_add_pd(_mm512_add_pd(f_node[5], f_node[7]), _mm512_add_pd(f_node[6], f_node[8]));
+		const __m512d x_axis = _mm512_sub_pd(f_node[1], f_node[3]);
+		const __m512d x_diag = _mm512_sub_pd(_mm512_sub_pd(f_node[5], f_node[6]), _mm512_sub_pd(f_node[7], f_node[8]));
+		const __m512d y_axis = _mm512_sub_pd(f_node[2], f_node[4]);
+		const __m512d y_diag = _mm512_sub_pd(_mm512_add_pd(f_node[5], f_node[6]), _mm512_add_pd(f_node[7], f_node[8]));
+
+		const __m512d cur_rho = _mm512_add_pd(_mm512_add_pd(f_node[0], axis_sum), diag_sum);
+		const __m512d jx = _mm512_add_pd(x_axis, x_diag);
+		const __m512d jy = _mm512_add_pd(y_axis, y_diag);
+
+		const __mmask8 is_rho_zero = _mm512_cmp_pd_mask(cur_rho, zero, _CMP_EQ_OQ);
+		const __mmask8 is_vx_zero = is_rho_zero & _mm512_cmp_pd_mask(jx, zero, _CMP_EQ_OQ);
+		const __mmask8 is_vy_zero = is_rho_zero & _mm512_cmp_pd_mask(jy, zero, _CMP_EQ_OQ);
+		const __m512d cur_vx = _mm512_mask_blend_pd(is_vx_zero, _mm512_div_pd(jx, cur_rho), zero);
+		const __m512d cur_vy = _mm512_mask_blend_pd(is_vy_zero, _mm512_div_pd(jy, cur_rho), zero);
+
+		_mm512_storeu_pd(rho + i, cur_rho);
+		_mm512_storeu_pd(vx + i, cur_vx);
+		_mm512_storeu_pd(vy + i, cur_vy);
+
+		const __m512d vxSq = _mm512_mul_pd(cur_vx, cur_vx);
+		const __m512d vySq = _mm512_mul_pd(cur_vy, cur_vy);
+		const __m512d vSq = _mm512_add_pd(vxSq, vySq);
+
+		const __m512d m1 = _mm512_sub_pd(_mm512_sub_pd(_mm512_mul_pd(c2, diag_sum), axis_sum), _mm512_mul_pd(c4, f_node[0]));
+		const __m512d m2 = _mm512_sub_pd(_mm512_add_pd(_mm512_mul_pd(c4, f_node[0]), diag_sum), _mm512_mul_pd(c2, axis_sum));
+		const __m512d m4 = _mm512_sub_pd(x_diag, _mm512_mul_pd(c2, x_axis));
+		const __m512d m6 = _mm512_sub_pd(y_diag, _mm512_mul_pd(c2, y_axis));
+		const __m512d m7 = _mm512_sub_pd(_mm512_add_pd(f_node[1], f_node[3]), _mm512_add_pd(f_node[2], f_node[4]));
+		const __m512d m8 = _mm512_sub_pd(_mm512_add_pd(f_node[5], f_node[7]), _mm512_add_pd(f_node[6], f_node[8]));
+
+		const __m512d t1 = _mm512_mul_pd(s1, _mm512_sub_pd(m1, _mm512_mul_pd(cur_rho, _mm512_add_pd(_mm512_mul_pd(vSq, c3), _mm512_set1_pd(-2.0)))));
+		const __m512d t2 = _mm512_mul_pd(s2, _mm512_sub_pd(m2, _mm512_mul_pd(cur_rho, _mm512_add_pd(_mm512_mul_pd(vSq, _mm512_set1_pd(-3.0)), _mm512_set1_pd(1.0)))));
+		const __m512d t4 = _mm512_mul_pd(s4, _mm512_add_pd(m4, _mm512_mul_pd(cur_rho, cur_vx)));
+		const __m512d t6 = _mm512_mul_pd(s6, _mm512_add_pd(m6, _mm512_mul_pd(cur_rho, cur_vy)));
+		const __m512d t7 = _mm512_mul_pd(s7, _mm512_sub_pd(m7, _mm512_mul_pd(cur_rho, _mm512_sub_pd(vxSq, vySq))));
+		const __m512d t8 = _mm512_mul_pd(s8, _mm512_sub_pd(m8, _mm512_mul_pd(cur_rho, _mm512_mul_pd(cur_vx, cur_vy))));
+
+		const __m512d axis_part = _mm512_add_pd(t1, _mm512_mul_pd(c2, t2));
+		const __m512d axis_x = _mm512_sub_pd(axis_part, _mm512_mul_pd(c9, t7));
+		const __m512d axis_y = _mm512_add_pd(axis_part, _mm512_mul_pd(c9, t7));
+		const __m512d diag_part = _mm512_add_pd(_mm512_mul_pd(c2, t1), t2);
+		const __m512d diag_px = _mm512_add_pd(diag_part, _mm512_mul_pd(c3, t4));
+		const __m512d diag_mx = _mm512_sub_pd(diag_part, _mm512_mul_pd(c3, t4));
+		const __m512d diag_pp = _mm512_add_pd(_mm512_mul_pd(c3, t6), _mm512_mul_pd(c9, t8));
+		const __m512d diag_pm = _mm512_sub_pd(_mm512_mul_pd(c3, t6), _mm512_mul_pd(c9, t8));
+
+		_mm512_storeu_pd(f[0] + i, _mm512_sub_pd(f_node[0], _mm512_mul_pd(c4, _mm512_sub_pd(t2, t1))));
+		_mm512_storeu_pd(f[1] + i, _mm512_add_pd(f_node[1], _mm512_add_pd(axis_x, _mm512_mul_pd(c6, t4))));
+		_mm512_storeu_pd(f[2] + i, _mm512_add_pd(f_node[2], _mm512_add_pd(axis_y, _mm512_mul_pd(c6, t6))));
+		_mm512_storeu_pd(f[3] + i, _mm512_add_pd(f_node[3], _mm512_sub_pd(axis_x, _mm512_mul_pd(c6, t4))));
+		_mm512_storeu_pd(f[4] + i, _mm512_add_pd(f_node[4], _mm512_sub_pd(axis_y, _mm512_mul_pd(c6, t6))));
+		_mm512_storeu_pd(f[5] + i, _mm512_sub_pd(f_node[5], _mm512_add_pd(diag_px, diag_pp)));
+		_mm512_storeu_pd(f[6] + i, _mm512_sub_pd(f_node[6], _mm512_add_pd(diag_mx, diag_pm)));
+		_mm512_storeu_pd(f[7] + i, _mm512_sub_pd(f_node[7], _mm512_sub_pd(diag_mx, diag_pm)));
+		_mm512_storeu_pd(f[8] + i, _mm512_sub_pd(f_node[8], _mm512_sub_pd(diag_px, diag_pp)));
+	}
+
+	CollideMRTScalar(f, rho, vx, vy, i, end, S);
+}
+
+#endif // LBM_SIMD_X86
+
+void CollideMRT(double * const f[kQ], double * rho, double * vx, double * vy, int const begin, int const end, const double * S)
+{
+	switch (GetSimdLevel())
+	{
+#ifdef LBM_SIMD_X86
+	case SimdLevel::AVX512:
+		CollideMRTAvx512(f, rho, vx, vy, begin, end, S);
+		break;
+	case SimdLevel::AVX2:
+		CollideMRTAvx2(f, rho, vx, vy, begin, end, S);
+		break;
+#endif
+	default:
+		CollideMRTScalar(f, rho, vx, vy, begin, end, S);
+		break;
+	}
+}
+
+#pragma endregion
@@ -0,0 +1,43 @@
+#pragma once
+
+#ifndef COLLISION_KERNELS_H
+#define COLLISION_KERNELS_H
+
+#include"..\solver.h"
+
+// Collision kernels for D2Q9 model, which work directly with components of distribution function
+// stored as separate arrays (structure of arrays): f[q][i] is 'q' component in 'i' node.
+//
+// Each kernel has scalar reference implementation and vectorized implementations (AVX2, AVX-512),
+// which perform the same arithmetic operations in the same order, so results are bit-identical.
+// Implementation is chosen at runtime in accordance with processor features.
+
+//! Instruction sets, which could be used by collision kernels
+enum class SimdLevel
+{
+	SCALAR = 0,	// scalar reference implementation
+	AVX2 = 1,	// 4 nodes are processed at once
+	AVX512 = 2,	// 8 nodes are processed at once
+};
+
+//! Returns the best instruction set, supported by the processor and operating system
+SimdLevel DetectSimdLevel();
+
+//! Returns instruction set, used by collision kernels (the best supported one by default)
+SimdLevel GetSimdLevel();
+
+//! Forces collision kernels to use 'level' instruction set (if it is not supported the best supported one is used)
+void SetSimdLevel(SimdLevel const level);
+
+//! Returns name of instruction set
+std::string ToString(SimdLevel const level);
+
+/// SRT collision of nodes in range [begin, end): calculates macroscopic values 'rho', 'vx', 'vy' from 'f',
+/// equilibrium distribution function and relaxes 'f' to it with 'tau' relaxation time (the same as SRTsolver::CollideNode()).
+void CollideSRT(double * const f[kQ], double * rho, double * vx, double * vy, int const begin, int const end, double const tau);
+
+/// MRT collision of nodes in range [begin, end) (A.A. Mohammad 2012): calculates macroscopic values 'rho', 'vx', 'vy' from 'f',
+/// transforms 'f' to the moments space, relaxes moments with 'S' rates (kQ diagonal elements of S matrix) and transforms them back.
+void CollideMRT(double * const f[kQ], double * rho, double * vx, double * vy, int const begin, int const end, const double * S);
+
+#endif // !COLLISION_KERNELS_H
@@ -0,0 +1,201 @@
+#pragma once
+
+#ifndef LATTICE_H
+#define LATTICE_H
+
+#include<vector>
+
+// Compile-time descriptors of velocity models (lattices).
+//
+// Descriptor contains number of dimensions and directions, velocity components, weights and indexes of opposite
+// directions as constexpr members. Kernels are templates on descriptor, so all constants and the number of
+// iterations of loops over directions are known at compile time (loops could be unrolled), and the other model could be
+// added as the new descriptor. Descriptors are class templates only to define static constexpr arrays in header,
+// they are used through typedefs D2Q9, D3Q19 and D3Q27.
+//
+// Velocity components are stored as double, because they are mostly multiplied by velocities; components are integer
+// numbers, so offsets of neighbour nodes are obtained with static_cast<int>().
+
+//! Axis of coordinate system
+enum class Axis
+{
+	X = 0,
+	Y = 1,
+	Z = 2,
+};
+
+
+#pragma region 2d
+
+/* Model of velocity directions in D2Q9 model
+    6 2 5  ^ y
+     \|/   |
+    3 0 1  O---> x
+     /|\
+    7 4 8
+*/
+template<typename T = void>
+struct D2Q9Descriptor
+{
+	static constexpr int kDimensions = 2;
+	static constexpr int kQ = 9;
+
+	//! Weights of directions in equilibrium distribution function
+	static constexpr double kW[kQ]{ 4.0 / 9.0, 1.0 / 9.0, 1.0 / 9.0, 1.0 / 9.0, 1.0 / 9.0, 1.0 / 36.0, 1.0 / 36.0, 1.0 / 36.0, 1.0 / 36.0 };
+
+	//! Velocity components of directions
+	static constexpr double kEx[kQ]{ 0.0, 1.0, 0.0, -1.0, 0.0, 1.0, -1.0, -1.0, 1.0 };
+	static constexpr double kEy[kQ]{ 0.0, 0.0, 1.0, 0.0, -1.0, 1.0, 1.0, -1.0, -1.0 };
+	static constexpr double kEz[kQ]{ 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+
+	//! Indexes of opposite directions
+	static constexpr int kOpposite[kQ]{ 0, 3, 4, 1, 2, 7, 8, 5, 6 };
+};
+
+template<typename T> constexpr double D2Q9Descriptor<T>::kW[];
+template<typename T> constexpr double D2Q9Descriptor<T>::kEx[];
+template<typename T> constexpr double D2Q9Descriptor<T>::kEy[];
+template<typename T> constexpr double D2Q9Descriptor<T>::kEz[];
+template<typename T> constexpr int D2Q9Descriptor<T>::kOpposite[];
+
+typedef D2Q9Descriptor<> D2Q9;
+
+#pragma endregion
+
+
+#pragma region 3d
+
+// Model of velocity directions in D3Q19 model (in accordance with Dmitry Biculov article):
+// 0 - rest, 1-8 - directions in Oxy plane (the same as D2Q9 with inverted Y-axis), 9-13 - directions with ez = -1,
+// 14-18 - directions with ez = 1
+template<typename T = void>
+struct D3Q19Descriptor
+{
+	static constexpr int kDimensions = 3;
+	static constexpr int kQ = 19;
+
+	//! Weights of directions in equilibrium distribution function
+	static constexpr double kW[kQ]{ 12.0 / 36.0,
+		2.0 / 36.0, 2.0 / 36.0, 2.0 / 36.0, 2.0 / 36.0, 1.0 / 36.0, 1.0 / 36.0, 1.0 / 36.0, 1.0 / 36.0,
+		2.0 / 36.0, 1.0 / 36.0, 1.0 / 36.0, 1.0 / 36.0, 1.0 / 36.0,
+		2.0 / 36.0, 1.0 / 36.0, 1.0 / 36.0, 1.0 / 36.0, 1.0 / 36.0 };
+
+	//! Velocity components of directions
+	static constexpr double kEx[kQ]{ 0,  1,  0, -1,  0,  1, -1, -1,  1,   0,  1,  0, -1,  0,   0,  1,  0, -1,  0 };
+	static constexpr double kEy[kQ]{ 0,  0, -1,  0,  1, -1, -1,  1,  1,   0,  0, -1,  0,  1,   0,  0, -1,  0,  1 };
+	static constexpr double kEz[kQ]{ 0,  0,  0,  0,  0,  0,  0,  0,  0,  -1, -1, -1, -1, -1,   1,  1,  1,  1,  1 };
+
+	//! Indexes of opposite directions
+	static constexpr int kOpposite[kQ]{ 0, 3, 4, 1, 2, 7, 8, 5, 6, 14, 17, 18, 15, 16, 9, 12, 13, 10, 11 };
+};
+
+template<typename T> constexpr double D3Q19Descriptor<T>::kW[];
+template<typename T> constexpr double D3Q19Descriptor<T>::kEx[];
+template<typename T> constexpr double D3Q19Descriptor<T>::kEy[];
+template<typename T> constexpr double D3Q19Descriptor<T>::kEz[];
+template<typename T> constexpr int D3Q19Descriptor<T>::kOpposite[];
+
+typedef D3Q19Descriptor<> D3Q19;
+
+
+// Model of velocity directions in D3Q27 model: the first 19 directions are the same as in D3Q19 model,
+// 19-26 - diagonal directions to corners of cube
+template<typename T = void>
+struct D3Q27Descriptor
+{
+	static constexpr int kDimensions = 3;
+	static constexpr int kQ = 27;
+
+	//! Weights of directions in equilibrium distribution function
+	static constexpr double kW[kQ]{ 8.0 / 27.0,
+		2.0 / 27.0, 2.0 / 27.0, 2.0 / 27.0, 2.0 / 27.0, 1.0 / 54.0, 1.0 / 54.0, 1.0 / 54.0, 1.0 / 54.0,
+		2.0 / 27.0, 1.0 / 54.0, 1.0 / 54.0, 1.0 / 54.0, 1.0 / 54.0,
+		2.0 / 27.0, 1.0 / 54.0, 1.0 / 54.0, 1.0 / 54.0, 1.0 / 54.0,
+		1.0 / 216.0, 1.0 / 216.0, 1.0 / 216.0, 1.0 / 216.0, 1.0 / 216.0, 1.0 / 216.0, 1.0 / 216.0, 1.0 / 216.0 };
+
+	//! Velocity components of directions
+	static constexpr double kEx[kQ]{ 0,  1,  0, -1,  0,  1, -1, -1,  1,   0,  1,  0, -1,  0,   0,  1,  0, -1,  0,   1, -1,  1, -1,  1, -1,  1, -1 };
+	static constexpr double kEy[kQ]{ 0,  0, -1,  0,  1, -1, -1,  1,  1,   0,  0, -1,  0,  1,   0,  0, -1,  0,  1,  -1, -1,  1,  1, -1, -1,  1,  1 };
+	static constexpr double kEz[kQ]{ 0,  0,  0,  0,  0,  0,  0,  0,  0,  -1, -1, -1, -1, -1,   1,  1,  1,  1,  1,  -1, -1, -1, -1,  1,  1,  1,  1 };
+
+	//! Indexes of opposite directions
+	static constexpr int kOpposite[kQ]{ 0, 3, 4, 1, 2, 7, 8, 5, 6, 14, 17, 18, 15, 16, 9, 12, 13, 10, 11, 26, 25, 24, 23, 22, 21, 20, 19 };
+};
+
+template<typename T> constexpr double D3Q27Descriptor<T>::kW[];
+template<typename T> constexpr double D3Q27Descriptor<T>::kEx[];
+template<typename T> constexpr double D3Q27Descriptor<T>::kEy[];
+template<typename T> constexpr double D3Q27Descriptor<T>::kEz[];
+template<typename T> constexpr int D3Q27Descriptor<T>::kOpposite[];
+
+typedef D3Q27Descriptor<> D3Q27;
+
+#pragma endregion
+
+
+#pragma region Functions
+
+//! Returns velocity component of 'q' direction of 'Lattice' along 'axis'
+template<typename Lattice>
+constexpr double Velocity(int const q, Axis const axis)
+{
+	return (axis == Axis::X) ? Lattice::kEx[q] : (axis == Axis::Y) ? Lattice::kEy[q] : Lattice::kEz[q];
+}
+
+//! Checks that weights of 'Lattice' give zero and second moments of isotropic lattice (sum of w = 1, sum of w * e_x^2 = 1/3)
+//! and that opposite directions have opposite velocities
+template<typename Lattice>
+constexpr bool IsLatticeConsistent()
+{
+	double w_sum = 0.0;
+	double wx_sum = 0.0;
+
+	for (int q = 0; q < Lattice::kQ; ++q)
+	{
+		const int opp = Lattice::kOpposite[q];
+
+		if (Lattice::kEx[opp] != -Lattice::kEx[q] || Lattice::kEy[opp] != -Lattice::kEy[q] || Lattice::kEz[opp] != -Lattice::kEz[q])
+			return false;
+
+		w_sum += Lattice::kW[q];
+		wx_sum += Lattice::kW[q] * Lattice::kEx[q] * Lattice::kEx[q];
+	}
+
+	return w_sum > 1.0 - 1e-12 && w_sum < 1.0 + 1e-12 && wx_sum > 1.0 / 3.0 - 1e-12 && wx_sum < 1.0 / 3.0 + 1e-12;
+}
+
+//! Returns number of directions of 'Lattice', which velocity component along 'axis' is equal to 'value'
+template<typename Lattice>
+constexpr int CountDirections(Axis const axis, int const value)
+{
+	int count = 0;
+	for (int q = 0; q < Lattice::kQ; ++q)
+		if (Velocity<Lattice>(q, axis) == value)
+			++count;
+
+	return count;
+}
+
+//! Returns directions of 'Lattice' in ascending order, which velocity component along 'axis' is equal to 'value'.
+//! For example, directions with 'value' = 1 come to the boundary with the maximum coordinate along 'axis' and
+//! directions with 'value' = 0 are parallel to this boundary
+template<typename Lattice>
+std::vector<int> LatticeDirections(Axis const axis, int const value)
+{
+	std::vector<int> directions;
+	directions.reserve(CountDirections<Lattice>(axis, value));
+
+	for (int q = 0; q < Lattice::kQ; ++q)
+		if (Velocity<Lattice>(q, axis) == value)
+			directions.push_back(q);
+
+	return directions;
+}
+
+static_assert(IsLatticeConsistent<D2Q9>(), "D2Q9 descriptor is not consistent");
+static_assert(IsLatticeConsistent<D3Q19>(), "D3Q19 descriptor is not consistent");
+static_assert(IsLatticeConsistent<D3Q27>(), "D3Q27 descriptor is not consistent");
+
+#pragma endregion
+
+#endif // !LATTICE_H
@@ -15,24 +15,6 @@ MRTSolver::MRTSolver(double const tau, Medium & medium, Fluid & fluid) : SRTsolv
 
 	// Fill transformation matrix S
 	S_ = { 1.0, 1.2, 1.0, 1.0, 1.2, 1.0, 1.2, 1.0 / tau_, 1.0 / tau_ };
-
-	// Allocate memory for S * M^{-1} matrix
-	MinvS_.Resize(kQ, kQ);
-
-	// S - diagonal matrix
-	Matrix2D<double> S(kQ, kQ);
-	for (int i = 0; i < kQ; ++i)
-		S(i, i) = S_.at(i);
-
-	// Perform multiplication: S * M^{-1}
-	for (int i = 0; i < kQ; ++i)
-		for (int j = 0; j < kQ; ++j)
-		{
-			MinvS_(i, j) = 0.0;
-			for (int k = 0; k < kQ; ++k)
-				MinvS_(i, j) += Minv_[i][k] * S(k, j);
-		}
-
 }
 
 void MRTSolver::Collision()
@@ -41,78 +23,103 @@ void MRTSolver::Collision()
 	const int y_size = medium_->size().first;
 	const int x_size = medium_->size().second;
 
-	// Distribution function in momentum space
-	DistributionFunction<double> dm(y_size, x_size);
+	double * f[kQ];
 	for (int q = 0; q < kQ; ++q)
-		dm[q].FillWith(0.0);
-
-	// Calculate m = M * f
-	for (int k = 0; k < kQ; ++k)
-		for (int m = 0; m < kQ; ++m)
-			dm[k] += M_[k][m] * fluid_->f_[m];
-
-	// Performs calculations of values necessary for meq calculation
-	Matrix2D<double> rvx = fluid_->rho_.ScalarMultiplication(fluid_->vx_);
-	Matrix2D<double> rvy = fluid_->rho_.ScalarMultiplication(fluid_->vy_);
-	Matrix2D<double> vxSq = fluid_->vx_.ScalarMultiplication(fluid_->vx_);
-	Matrix2D<double> vySq = fluid_->vy_.ScalarMultiplication(fluid_->vy_);
-	Matrix2D<double> vSq = vxSq + vySq;
-
-	// Performs dm = m - m_eq : Additional check m_eq = M * f_eq
-	dm[0] -= fluid_->rho_;
-	dm[1] -= fluid_->rho_.ScalarMultiplication((-2.0 + 3.0 * vSq));
-	dm[2] -= fluid_->rho_.ScalarMultiplication((-3.0 * vSq + 1));
-	dm[3] -= rvx;
-	dm[4] += rvx;
-	dm[5] -= rvy;
-	dm[6] += rvy;
-	dm[7] -= fluid_->rho_.ScalarMultiplication(vxSq - vySq);
-	dm[8] -= fluid_->rho_.ScalarMultiplication(fluid_->vx_.ScalarMultiplication(fluid_->vy_));
-
-	// Performs f(x + vdt, t + dt) = f(x, t) - M^{-1}S * dm
-	for (int k = 0; k < kQ; ++k)
-		for (int m = 0; m < kQ; ++m)
-			fluid_->f_[k] -= MinvS_(k, m) * dm[m];
-
+		f[q] = fluid_->f_[q].Data();
+
+	double * rho = fluid_->rho_.Data();
+	double * vx = fluid_->vx_.Data();
+	double * vy = fluid_->vy_.Data();
+	const double * S = S_.data();
+
+	// Calculates rho, v, m = M * f, dm = m - m_eq and f(x + vdt, t + dt) = f(x, t) - M^{-1}S * dm in each node.
+	// Rows are processed in parallel, nodes of each row are processed by vectorized kernel
+#pragma omp parallel for schedule(runtime)
+	for (int y = 0; y < y_size; ++y)
+		CollideMRT(f, rho, vx, vy, y * x_size, (y + 1) * x_size, S);
 }
 
 void MRTSolver::Solve(int iteration_number)
 {
-	feqCalculate();
-	for (int q = 0; q < kQ; ++q)
-		fluid_->f_[q] = fluid_->feq_[q];
+	// After restart distribution function is already restored
+	if (start_iter_ == 0)
+	{
+		feqCalculate();
+		for (int q = 0; q < kQ; ++q)
+			fluid_->f_[q] = fluid_->feq_[q];
+	}
 
 	BCs BC(fluid_->f_);
 
-	for (int iter = 0; iter < iteration_number; ++iter)
+	// Index of all written VTK files, ParaView opens them as one dataset
+	VtkSeries fluid_series("Data\\mrt_lbm_data\\2d\\fluid_vtk\\fluid.pvd");
+
+	// Fields are written by writer thread: one staging buffer is written, while another one could be filled by solver.
+	// Output is destroyed first, so it finishes all jobs before buffers and series are destroyed
+	StagingBuffers<FluidSnapshot> snapshots(2, fluid_->size().first, fluid_->size().second);
+	AsyncOutput output;
+
+	// Collision (f -> f, rho, v) and streaming (f -> f)
+	performance_.SetLattice("mrt", static_cast<long long>(fluid_->size().first) * fluid_->size().second, (4 * kQ + 3) * sizeof(double));
+
+	for (int iter = start_iter_; iter < iteration_number; ++iter)
 	{
-		Collision();
-		BC.PrepareValuesForAllBC(BCType::BOUNCE_BACK, BCType::BOUNCE_BACK, BCType::DIRICHLET, BCType::DIRICHLET);
+		performance_.BeginIteration();
 
-		Streaming();
+		performance_.Measure(Phase::COLLISION, [&]() { Collision(); });
+		performance_.Measure(Phase::BC_PREPARE, [&]()
+		{
+			BC.PrepareValuesForAllBC(BCType::BOUNCE_BACK, BCType::BOUNCE_BACK, BCType::DIRICHLET, BCType::DIRICHLET);
+		});
 
-		BC.BounceBackBC(Boundary::TOP);
-		BC.BounceBackBC(Boundary::BOTTOM);
-		BC.DirichletBC(Boundary::LEFT, *fluid_, 0.99);
-		BC.DirichletBC(Boundary::RIGHT, *fluid_, 1.00);
+		performance_.Measure(Phase::STREAMING, [&]() { Streaming(); });
 
-		BC.RecordValuesForAllBC(BCType::BOUNCE_BACK, BCType::BOUNCE_BACK, BCType::DIRICHLET, BCType::DIRICHLET);
+		performance_.Measure(Phase::BC_RECORD, [&]()
+		{
+			BC.BounceBackBC(Boundary::TOP);
+			BC.BounceBackBC(Boundary::BOTTOM);
+			BC.DirichletBC(Boundary::LEFT, 0.99);
+			BC.DirichletBC(Boundary::RIGHT, 1.00);
 
-		Recalculate();
+			BC.RecordValuesForAllBC(BCType::BOUNCE_BACK, BCType::BOUNCE_BACK, BCType::DIRICHLET, BCType::DIRICHLET);
+		});
 
-		feqCalculate();
+		const bool is_output_step = iter % 50 == 0;
+		const bool is_checkpoint_step = checkpoint_interval_ > 0 && (iter + 1) % checkpoint_interval_ == 0;
 
-		std::cout << iter << " Total rho = " << fluid_->rho_.GetSum() << std::endl;
+		// Collision calculates macroscopic values from populations before collision, so fields are one step behind f_.
+		// They are recalculated from f_ only when they are written
+		if (is_output_step || is_checkpoint_step)
+			performance_.Measure(Phase::RECALCULATE, [&]() { Recalculate(); });
 
-		if (iter % 50 == 0)
+		if (is_checkpoint_step)
+			performance_.Measure(Phase::CHECKPOINT, [&]() { WriteCheckpoint(iter + 1); });
+
+		if (is_output_step)
 		{
-			//Matrix2D<double> v = CalculateModulus(fluid_->vx_, fluid_->vy_);
-			//v.WriteFieldToTxt("Data\\mrt_lbm_data\\2d\\fluid_txt", "v", iter);
-			fluid_->vx_.WriteFieldToTxt("Data\\mrt_lbm_data\\2d\\fluid_txt", "vx", iter);
-			fluid_->vy_.WriteFieldToTxt("Data\\mrt_lbm_data\\2d\\fluid_txt", "vy", iter);
-			fluid_->write_fluid_vtk("Data\\mrt_lbm_data\\2d\\fluid_vtk", iter);
+			performance_.Measure(Phase::OUTPUT, [&]()
+			{
+				std::cout << iter << " " << fluid_->GetDiagnostics() << '\n';
+
+				//Matrix2D<double> v = CalculateModulus(fluid_->vx_, fluid_->vy_);
+				//v.WriteFieldToTxt("Data\\mrt_lbm_data\\2d\\fluid_txt", "v", iter);
+				std::shared_ptr<FluidSnapshot> snapshot = snapshots.Acquire();
+				snapshot->CopyFrom(*fluid_);
+
+				output.Push([snapshot, iter, &fluid_series]()
+				{
+					snapshot->vx_.WriteFieldToTxt("Data\\mrt_lbm_data\\2d\\fluid_txt", "vx", iter);
+					snapshot->vy_.WriteFieldToTxt("Data\\mrt_lbm_data\\2d\\fluid_txt", "vy", iter);
+					fluid_series.Add(iter, snapshot->write_fluid_vtk("Data\\mrt_lbm_data\\2d\\fluid_vtk", iter));
+				});
+			});
 		}
 
+		performance_.EndIteration(iter + 1);
 	}
 
+	// Macroscopic fields correspond to the last step after solution
+	Recalculate();
+
+	performance_.Finish(iteration_number);
 }
\ No newline at end of file
@@ -18,41 +18,15 @@ public:
 	void Collision() override;
 	void Solve(int iteration_number) override;
 
+	using SRTsolver::SetCheckpoint;
+	using SRTsolver::Restart;
+	using SRTsolver::SetPerformanceLog;
+
 private:
 
-	// Matrix, which transforms the distribution function f to the velocity moment m (A.A. Mohammad 2012)
-	const double M_[kQ][kQ] =
-	{
-		{ 1.0,	1.0,	1.0,	1.0,	1.0,	1.0,	1.0,	1.0,	1.0 },
-		{ -4.0,	-1.0,	-1.0,	-1.0,	-1.0,	2.0,	2.0,	2.0,	2.0 },
-		{ 4.0,	-2.0,	-2.0,	-2.0,	-2.0,	1.0,	1.0,	1.0,	1.0 },
-		{ 0.0,	1.0,	0.0,	-1.0,	0.0,	1.0,	-1.0,	-1.0,	1.0 },
-		{ 0.0,	-2.0,	0.0,	2.0,	0.0,	1.0,	-1.0,	-1.0,	1.0 },
-		{ 0.0,	0.0,	1.0,	0.0,	-1.0,	1.0,	1.0,	-1.0,	-1.0 },
-		{ 0.0,	0.0,	-2.0,	0.0,	2.0,	1.0,	1.0,	-1.0,	-1.0 },
-		{ 0.0,	1.0,	-1.0,	1.0,	-1.0,	0.0,	0.0,	0.0,	0.0 },
-		{ 0.0,	0.0,	0.0,	0.0,	0.0,	1.0,	-1.0,	1.0,	-1.0 }
-	};
-
-	// Inverse matrix, which transforms the velocity moment m, back to the distribution function f (A.A. Mohammad 2012)
-	const double Minv_[kQ][kQ] =
-	{
-		{ 4.0 / 36.0,    -4.0 / 36.0,     4.0 / 36.0,     0.0 / 36.0,     0.0 / 36.0,     0.0 / 36.0,     0.0 / 36.0,     0.0 / 36.0,     0.0 / 36.0, },
-		{ 4.0 / 36.0,    -1.0 / 36.0,    -2.0 / 36.0,     6.0 / 36.0,    -6.0 / 36.0,     0.0 / 36.0,     0.0 / 36.0,     9.0 / 36.0,     0.0 / 36.0, },
-		{ 4.0 / 36.0,    -1.0 / 36.0,    -2.0 / 36.0,     0.0 / 36.0,     0.0 / 36.0,     6.0 / 36.0,    -6.0 / 36.0,    -9.0 / 36.0,     0.0 / 36.0, },
-		{ 4.0 / 36.0,    -1.0 / 36.0,    -2.0 / 36.0,    -6.0 / 36.0,     6.0 / 36.0,     0.0 / 36.0,     0.0 / 36.0,     9.0 / 36.0,     0.0 / 36.0, },
-		{ 4.0 / 36.0,    -1.0 / 36.0,    -2.0 / 36.0,     0.0 / 36.0,     0.0 / 36.0,    -6.0 / 36.0,     6.0 / 36.0,    -9.0 / 36.0,     0.0 / 36.0, },
-		{ 4.0 / 36.0,     2.0 / 36.0,     1.0 / 36.0,     6.0 / 36.0,     3.0 / 36.0,     6.0 / 36.0,     3.0 / 36.0,     0.0 / 36.0,     9.0 / 36.0, },
-		{ 4.0 / 36.0,     2.0 / 36.0,     1.0 / 36.0,    -6.0 / 36.0,    -3.0 / 36.0,     6.0 / 36.0,     3.0 / 36.0,     0.0 / 36.0,    -9.0 / 36.0, },
-		{ 4.0 / 36.0,     2.0 / 36.0,     1.0 / 36.0,    -6.0 / 36.0,    -3.0 / 36.0,    -6.0 / 36.0,    -3.0 / 36.0,     0.0 / 36.0,     9.0 / 36.0, },
-		{ 4.0 / 36.0,     2.0 / 36.0,     1.0 / 36.0,     6.0 / 36.0,     3.0 / 36.0,    -6.0 / 36.0,    -3.0 / 36.0,     0.0 / 36.0,    -9.0 / 36.0, }
-	};
-
-	// Transformation matrix S = diag(1.0, 1.2, 1.0, 1.0, 1.2, 1.0, 1.2, 1/tau, 1/tau) (A.A. Mohammad 2012)
+	// Transformation matrix S = diag(1.0, 1.2, 1.0, 1.0, 1.2, 1.0, 1.2, 1/tau, 1/tau) (A.A. Mohammad 2012).
+	// Moments matrix M and its inverse are expanded in CollideMRT()
 	std::vector<double> S_;
-
-	// Matrix, which is the result of multiplication of S transformation matrix with M^{-1} : MinvS_ = M^{-1} * S
-	Matrix2D<double> MinvS_;
 };
 
 
@@ -0,0 +1,42 @@
+#pragma once
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include<iostream>
+#include<omp.h>
+
+// All node loops of solvers are parallelized with "#pragma omp parallel for schedule(runtime)",
+// so number of threads and schedule of these loops are chosen at runtime with functions below.
+
+//! Type of distribution of node loop iterations between threads
+enum class ScheduleType
+{
+	STATIC,		// each thread gets equal contiguous chunks of nodes (best choice if work per node is uniform)
+	DYNAMIC,	// chunks of nodes are given to threads on request (better if work per node is not uniform)
+};
+
+//! Sets number of threads for node loops of all solvers. If 'threads_number' < 1 all available processors are used
+inline void SetThreadsNumber(int const threads_number)
+{
+	omp_set_num_threads((threads_number < 1) ? omp_get_num_procs() : threads_number);
+}
+
+//! Returns number of threads, which is used for node loops
+inline int GetThreadsNumber()
+{
+	return omp_get_max_threads();
+}
+
+//! Sets schedule of node loops of all solvers. If 'chunk_size' < 1 default chunk size is used
+inline void SetSchedule(ScheduleType const type, int const chunk_size = 0)
+{
+#if _OPENMP >= 200805
+	omp_set_schedule((type == ScheduleType::DYNAMIC) ? omp_sched_dynamic : omp_sched_static, chunk_size);
+#else
+	// OpenMP 2.0 has no omp_set_schedule(), in this case schedule is taken from OMP_SCHEDULE environment variable
+	std::cout << "Warning! Schedule of node loops could be set only with OMP_SCHEDULE environment variable.\n";
+#endif
+}
+
+#endif // !PARALLEL_H
@@ -0,0 +1,139 @@
+#include"performance.h"
+
+#include<iostream>
+
+
+std::string ToString(Phase const phase)
+{
+	switch (phase)
+	{
+	case Phase::COLLISION:		return "collision";
+	case Phase::STREAMING:		return "streaming";
+	case Phase::BC_PREPARE:		return "bc_prepare";
+	case Phase::BC_RECORD:		return "bc_record";
+	case Phase::RECALCULATE:	return "recalculate";
+	case Phase::FEQ:			return "feq";
+	case Phase::IB_FORCES:		return "ib_forces";
+	case Phase::OUTPUT:			return "output";
+	case Phase::CHECKPOINT:		return "checkpoint";
+	default:					return "unknown";
+	}
+}
+
+
+PerformanceMonitor::PerformanceMonitor() : interval_(0), format_(PerformanceFormat::JSON), nodes_number_(0), bytes_per_node_(0.0)
+{
+	Reset();
+}
+
+void PerformanceMonitor::Enable(std::string const & file_name, int const interval, PerformanceFormat const format)
+{
+	interval_ = (interval > 0) ? interval : 0;
+	format_ = format;
+
+	if (file_.is_open())
+		file_.close();
+
+	if (!IsEnabled())
+		return;
+
+	file_.open(file_name, std::ios::trunc);
+	if (!file_.is_open())
+		std::cout << "Error! Could not open file " << file_name << " for performance reports.\n";
+
+	if (format_ == PerformanceFormat::CSV)
+	{
+		file_ << "solver,iteration,iterations,nodes,time,mlups,bandwidth_gb_s";
+		for (int phase = 0; phase < kPhasesNumber; ++phase)
+			file_ << ',' << ToString(static_cast<Phase>(phase));
+		file_ << ",other,live_bytes,peak_bytes,cached_bytes,allocations,pool_hits\n";
+	}
+
+	Reset();
+	pool_stats_ = MemoryPool::Instance().GetStats();
+}
+
+void PerformanceMonitor::SetLattice(std::string const & solver_name, long long const nodes_number, double const bytes_per_node)
+{
+	solver_name_ = solver_name;
+	nodes_number_ = nodes_number;
+	bytes_per_node_ = bytes_per_node;
+}
+
+void PerformanceMonitor::BeginIteration()
+{
+	if (IsEnabled())
+		iteration_start_ = Clock::now();
+}
+
+void PerformanceMonitor::EndIteration(int const iter)
+{
+	if (!IsEnabled())
+		return;
+
+	total_time_ += std::chrono::duration<double>(Clock::now() - iteration_start_).count();
+	++iterations_;
+
+	if (iterations_ == interval_)
+		WriteReport(iter);
+}
+
+void PerformanceMonitor::Finish(int const iter)
+{
+	if (IsEnabled() && iterations_ > 0)
+		WriteReport(iter);
+}
+
+void PerformanceMonitor::WriteReport(int const iter)
+{
+	const double updates = static_cast<double>(nodes_number_) * iterations_;
+	const double mlups = (total_time_ > 0.0) ? updates / total_time_ * 1e-6 : 0.0;
+	const double bandwidth = (total_time_ > 0.0) ? updates * bytes_per_node_ / total_time_ * 1e-9 : 0.0;
+
+	// Time, which is not covered by measured phases
+	double other_time = total_time_;
+	for (auto time : phase_time_)
+		other_time -= time;
+
+	// Requests of memory blocks since the previous report
+	const MemoryPoolStats pool = MemoryPool::Instance().GetStats();
+	const long long allocations = pool.allocations_ - pool_stats_.allocations_;
+	const long long pool_hits = pool.pool_hits_ - pool_stats_.pool_hits_;
+	pool_stats_ = pool;
+
+	if (format_ == PerformanceFormat::JSON)
+	{
+		file_ << "{\"solver\":\"" << solver_name_ << "\",\"iteration\":" << iter << ",\"iterations\":" << iterations_
+			<< ",\"nodes\":" << nodes_number_ << ",\"time\":" << total_time_ << ",\"mlups\":" << mlups
+			<< ",\"bandwidth_gb_s\":" << bandwidth << ",\"phases\":{";
+
+		for (int phase = 0; phase < kPhasesNumber; ++phase)
+			file_ << '\"' << ToString(static_cast<Phase>(phase)) << "\":" << phase_time_[phase] << ',';
+
+		file_ << "\"other\":" << other_time << "},\"memory\":{\"live_bytes\":" << pool.live_bytes_ << ",\"peak_bytes\":" << pool.peak_bytes_
+			<< ",\"cached_bytes\":" << pool.cached_bytes_ << ",\"allocations\":" << allocations << ",\"pool_hits\":" << pool_hits << "}}\n";
+	}
+	else
+	{
+		file_ << solver_name_ << ',' << iter << ',' << iterations_ << ',' << nodes_number_ << ',' << total_time_ << ','
+			<< mlups << ',' << bandwidth;
+
+		for (auto time : phase_time_)
+			file_ << ',' << time;
+
+		file_ << ',' << other_time << ',' << pool.live_bytes_ << ',' << pool.peak_bytes_ << ',' << pool.cached_bytes_ << ','
+			<< allocations << ',' << pool_hits << '\n';
+	}
+
+	// Reports are rare, so they are flushed to be available while solution continues
+	file_.flush();
+
+	Reset();
+}
+
+void PerformanceMonitor::Reset()
+{
+	iterations_ = 0;
+	total_time_ = 0.0;
+	phase_time_.fill(0.0);
+}
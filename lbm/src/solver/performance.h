@@ -0,0 +1,112 @@
+#pragma once
+
+#ifndef PERFORMANCE_H
+#define PERFORMANCE_H
+
+#include<string>
+#include<fstream>
+#include<chrono>
+#include<array>
+
+#include"..\math\memory_pool.h"
+
+// Performance instrumentation of solvers.
+//
+// Solver measures wall time of each phase of time step and reports throughput every 'interval' iterations:
+// million lattice updates per second (MLUPS), effective memory bandwidth and time of each phase.
+// Bandwidth is estimated from the minimum number of bytes, which time step implementation has to read and write
+// per node (it is set by solver), so it shows how close solver is to memory bound. Reports also contain counters of
+// memory pool of matrices (see MemoryPool). Reports are written to file as JSON lines (one object per report) or as CSV table.
+
+//! Phase of time step, which time is measured
+enum class Phase : int
+{
+	COLLISION = 0,		// collision (or fused collide-and-stream kernel)
+	STREAMING = 1,		// streaming
+	BC_PREPARE = 2,		// storing of boundary values before streaming
+	BC_RECORD = 3,		// applying of boundary conditions and recording of boundary values after streaming
+	RECALCULATE = 4,	// recalculation of macroscopic values
+	FEQ = 5,			// equilibrium distribution function calculation
+	IB_FORCES = 6,		// immersed boundary forces calculation, spreading and bodies update
+	OUTPUT = 7,			// console and file output (time spent by solver thread only)
+	CHECKPOINT = 8,		// checkpoint writing
+};
+
+//! Number of measured phases
+const int kPhasesNumber = 9;
+
+//! Format of performance reports file
+enum class PerformanceFormat
+{
+	JSON,	// one JSON object per line
+	CSV,	// table with header line
+};
+
+//! Returns name of phase, which is used in reports
+std::string ToString(Phase const phase);
+
+
+//! Collects time of time step phases and writes performance reports
+class PerformanceMonitor
+{
+	typedef std::chrono::steady_clock Clock;
+
+public:
+	PerformanceMonitor();
+	~PerformanceMonitor() {}
+
+	//! Enables reports every 'interval' iterations to 'file_name'. Disables reports if 'interval' <= 0
+	void Enable(std::string const & file_name, int const interval, PerformanceFormat const format);
+	//! Checks if reports are enabled
+	bool IsEnabled() const { return interval_ > 0; }
+
+	//! Sets name of solver in reports, number of updated nodes per time step and number of bytes read and written per node update
+	void SetLattice(std::string const & solver_name, long long const nodes_number, double const bytes_per_node);
+
+	//! Marks beginning of time step
+	void BeginIteration();
+	//! Marks end of 'iter' time step, writes report if 'interval' steps passed since the previous one
+	void EndIteration(int const iter);
+	//! Writes report for steps, which passed since the previous report (at the end of solution)
+	void Finish(int const iter);
+
+	//! Performs 'phase' and adds its time to statistics
+	template<typename Function>
+	void Measure(Phase const phase, Function && function);
+
+private:
+	//! Writes report for accumulated steps and resets statistics
+	void WriteReport(int const iter);
+	//! Resets accumulated statistics
+	void Reset();
+
+private:
+	//! Name of solver in reports
+	std::string solver_name_;
+	//! Number of iterations between reports
+	int interval_;
+	PerformanceFormat format_;
+	std::ofstream file_;
+
+	//! Number of nodes, updated each time step
+	long long nodes_number_;
+	//! Number of bytes, which are read and written per node update
+	double bytes_per_node_;
+
+	//! Number of time steps since the previous report
+	int iterations_;
+	//! Wall time of time steps since the previous report (in seconds)
+	double total_time_;
+	//! Wall time of each phase since the previous report (in seconds)
+	std::array<double, kPhasesNumber> phase_time_;
+
+	//! Beginning of the current time step
+	Clock::time_point iteration_start_;
+
+	//! Counters of memory pool at the previous report (numbers of requests are reported per reporting interval)
+	MemoryPoolStats pool_stats_;
+};
+
+#include"performance_impl.h"
+
+#endif // !PERFORMANCE_H
@@ -0,0 +1,17 @@
+#pragma once
+
+#include"performance.h"
+
+template<typename Function>
+inline void PerformanceMonitor::Measure(Phase const phase, Function && function)
+{
+	if (!IsEnabled())
+	{
+		function();
+		return;
+	}
+
+	const Clock::time_point start = Clock::now();
+	function();
+	phase_time_[static_cast<int>(phase)] += std::chrono::duration<double>(Clock::now() - start).count();
+}
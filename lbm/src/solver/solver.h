@@ -2,27 +2,57 @@
 
 #include"../phys_values/2d/distribution_func_2d.h"
 #include"../phys_values/3d/distribution_func_3d.h"
+#include"lattice.h"
 
 #pragma region 2d
 
+static_assert(D2Q9::kQ == kQ, "Distribution function and D2Q9 descriptor have different number of directions");
 
-
-// Model of velocity directions in D2Q9 model
-//  6 2 5  ^ y
-//   \|/   |
-//  3 0 1  O---> x
-//   /|\
-//  7 4 8
-
+// Constants of D2Q9 model (see D2Q9 descriptor), which is used by 2D solvers and distribution functions
 
 //! Weigth for probability distribution function calculation
-const double kW[kQ]{ 4.0 / 9.0, 1.0 / 9.0, 1.0 / 9.0, 1.0 / 9.0, 1.0 / 9.0, 1.0 / 36.0, 1.0 / 36.0, 1.0 / 36.0, 1.0 / 36.0 };
+static const double (&kW)[kQ] = D2Q9::kW;
 
 //! X-components witch determ particle movement
-const double kEx[kQ]{ 0.0, 1.0, 0.0, -1.0, 0.0, 1.0, -1.0, -1.0, 1.0 };
+static const double (&kEx)[kQ] = D2Q9::kEx;
 
 //! Y-components witch determ particle movement
-const double kEy[kQ]{ 0.0, 0.0, 1.0, 0.0, -1.0, 1.0, 1.0, -1.0, -1.0 };
+static const double (&kEy)[kQ] = D2Q9::kEy;
+
+//! Indexes of opposite directions: kEx[kOpposite[q]] == -kEx[q], kEy[kOpposite[q]] == -kEy[q]
+static const int (&kOpposite)[kQ] = D2Q9::kOpposite;
+
+//! Equilibrium value of 'q' component of distribution function of 2D 'Lattice' in the node with 'rho' density and ('vx', 'vy') velocity
+template<typename Lattice = D2Q9>
+inline double Equilibrium(int const q, double const rho, double const vx, double const vy)
+{
+	static_assert(Lattice::kDimensions == 2, "Equilibrium() is defined for 2D lattice only");
+
+	const double v = vx * Lattice::kEx[q] + vy * Lattice::kEy[q];
+	return Lattice::kW[q] * (rho * (1.0 + 3.0 * v + 4.5 * (v * v) - 1.5 * (vx * vx + vy * vy)));
+}
+
+//! Calculates macroscopic values of the node from its populations 'f_node' (same order of summation as in DistributionFunction)
+template<typename Lattice = D2Q9>
+inline void NodeMacroscopic(const double f_node[Lattice::kQ], double & rho, double & vx, double & vy)
+{
+	static_assert(Lattice::kDimensions == 2, "NodeMacroscopic() is defined for 2D lattice only");
+
+	rho = 0.0;
+	vx = 0.0;
+	vy = 0.0;
+
+	for (int q = 0; q < Lattice::kQ; ++q)
+		rho += f_node[q];
+	for (int q = 0; q < Lattice::kQ; ++q)
+		vx += f_node[q] * Lattice::kEx[q];
+	for (int q = 0; q < Lattice::kQ; ++q)
+		vy += f_node[q] * Lattice::kEy[q];
+
+	// Boundaries consist from 0, see Matrix2D::TimesDivide()
+	vx = (rho == 0.0 && vx == 0.0) ? 0.0 : vx / rho;
+	vy = (rho == 0.0 && vy == 0.0) ? 0.0 : vy / rho;
+}
 
 //! Y-     (  -1  up = 0, boottom = rows)
 //const double kEy[kQ]{ 0.0, 0.0, -1.0, 0.0, 1.0, -1.0, -1.0, 1.0, 1.0 };
@@ -31,27 +61,43 @@ const double kEy[kQ]{ 0.0, 0.0, 1.0, 0.0, -1.0, 1.0, 1.0, -1.0, -1.0 };
 
 #pragma region 3d
 
-#include<vector>
+// Directions of D3Q19 model, which is used by 3D solver, are in accordance with Dmitry Biculov article (see D3Q19 descriptor)
+static_assert(D3Q19::kQ == kQ3d, "Distribution function and D3Q19 descriptor have different number of directions");
 
-//! This is the vector of weights : initilize in feqCalculation() because it is too big
-static void FillWeightsFor3D(std::vector<double> & w)
+//! Equilibrium value of 'q' component of distribution function of 3D 'Lattice' in the node with 'rho' density and ('vx', 'vy', 'vz') velocity
+template<typename Lattice = D3Q19>
+inline double Equilibrium(int const q, double const rho, double const vx, double const vy, double const vz)
 {
-	w.resize(kQ3d, 1.0 / 36.0);
-
-	w.at(0) = 12.0 / 36.0;
-	w.at(9) = 2.0 / 36.0;
-	w.at(14) = 2.0 / 36.0;
+	static_assert(Lattice::kDimensions == 3, "Equilibrium() with three velocity components is defined for 3D lattice only");
 
-	for (int i = 1; i <= 4; ++i)
-		w.at(i) = 2.0 / 36.0;
-	
+	const double v = vx * Lattice::kEx[q] + vy * Lattice::kEy[q] + vz * Lattice::kEz[q];
+	return Lattice::kW[q] * (rho * (1.0 + 3.0 * v + 4.5 * (v * v) - 1.5 * (vx * vx + vy * vy + vz * vz)));
 }
 
-
-//! Directions in assordace with Dmitry Biculov article
-const int ex[kQ3d] { 0, 1,   0, -1,   0,  1,   -1, -1,   1, 0,   1,  0,   -1, 0,    0,  1,   0, -1,  0 };
-const int ey[kQ3d] { 0, 0,  -1,  0,   1, -1,   -1,  1,   1, 0,   0, -1,    0, 1,    0,  0,  -1,  0,  1 };
-const int ez[kQ3d] { 0, 0,   0,  0,   0,  0,    0,  0,   0,-1,  -1, -1,   -1,-1,    1,  1,   1,  1,  1 };
+//! Calculates macroscopic values of the node from its populations 'f_node' of 3D 'Lattice'
+template<typename Lattice = D3Q19>
+inline void NodeMacroscopic(const double f_node[Lattice::kQ], double & rho, double & vx, double & vy, double & vz)
+{
+	static_assert(Lattice::kDimensions == 3, "NodeMacroscopic() with three velocity components is defined for 3D lattice only");
+
+	rho = 0.0;
+	vx = 0.0;
+	vy = 0.0;
+	vz = 0.0;
+
+	for (int q = 0; q < Lattice::kQ; ++q)
+	{
+		rho += f_node[q];
+		vx += f_node[q] * Lattice::kEx[q];
+		vy += f_node[q] * Lattice::kEy[q];
+		vz += f_node[q] * Lattice::kEz[q];
+	}
+
+	// Nodes without populations (boundaries) have zero velocity
+	vx = (rho == 0.0) ? 0.0 : vx / rho;
+	vy = (rho == 0.0) ? 0.0 : vy / rho;
+	vz = (rho == 0.0) ? 0.0 : vz / rho;
+}
 
 #pragma endregion
 
@@ -6,7 +6,8 @@
 
 #pragma region srt
 
-SRTsolver::SRTsolver(double const tau, Medium & medium, Fluid & fluid) : tau_(tau), medium_(&medium), fluid_(&fluid)
+SRTsolver::SRTsolver(double const tau, Medium & medium, Fluid & fluid) : tau_(tau), medium_(&medium), fluid_(&fluid), kernel_mode_(KernelMode::SEPARATE_SWEEPS),
+	is_output_enabled_(true), checkpoint_interval_(0), start_iter_(0)
 {
 	assert(medium_->size().first == fluid_->size().first);
 	assert(medium_->size().second == fluid_->size().second);
@@ -20,31 +21,46 @@ SRTsolver::SRTsolver(double const tau, Medium & medium, Fluid & fluid) : tau_(ta
 
 void SRTsolver::feqCalculate()
 {
-	//   ,     
-	fluid_->feq_.fillWithoutBoundaries(0.0);
+	const int size = fluid_->size().first * fluid_->size().second;
 
-	for (int q = 0; q < kQ; ++q) {
-		Matrix2D<double> v(fluid_->size().first, fluid_->size().second);
-		v = fluid_->vx_ * kEx[q] + fluid_->vy_ * kEy[q];
+	const double * rho = fluid_->rho_.Data();
+	const double * vx = fluid_->vx_.Data();
+	const double * vy = fluid_->vy_.Data();
 
-		fluid_->feq_[q] = kW[q] * fluid_->rho_.ScalarMultiplication(
-			(1.0 + 3.0 * v + 4.5 * v.ScalarMultiplication(v) - 1.5 *
-			(fluid_->vx_.ScalarMultiplication(fluid_->vx_) + fluid_->vy_.ScalarMultiplication(fluid_->vy_)))
-		);
-	}
+	double * feq[kQ];
+	for (int q = 0; q < kQ; ++q)
+		feq[q] = fluid_->feq_[q].Data();
+
+#pragma omp parallel for schedule(runtime)
+	for (int id = 0; id < size; ++id)
+		for (int q = 0; q < kQ; ++q)
+			feq[q][id] = Equilibrium(q, rho[id], vx[id], vy[id]);
 }
 
 void SRTsolver::Streaming()
 {
+	const int rows = fluid_->size().first;
+	const int colls = fluid_->size().second;
+
+	Matrix2D<double> temp(rows, colls);
+
 	for (int q = 0; q < kQ; ++q) 
 	{
-		Matrix2D<double> temp = fluid_->f_[q];
+		// Old values are moved to temp without copying
+		temp.Swap(fluid_->f_[q]);
 		fluid_->f_[q].FillWith(0.0);
 
-		for (unsigned y = 0; y < fluid_->size().first; ++y)
-			for (unsigned x = 0; x < fluid_->size().second; ++x)
+		const double * from = temp.Data();
+		double * to = fluid_->f_[q].Data();
+		const int dy = -static_cast<int>(kEy[q]);
+		const int dx = static_cast<int>(kEx[q]);
+
+		// Each destination node is written by only one source node
+	#pragma omp parallel for schedule(runtime)
+		for (int y = 0; y < rows; ++y)
+			for (int x = 0; x < colls; ++x)
 				if (medium_->is_fluid(y, x))
-					fluid_->f_[q](y - kEy[q], x + kEx[q]) = temp(y, x);
+					to[(y + dy) * colls + x + dx] = from[y * colls + x];
 	}
 
 	//     ,       BCs
@@ -53,58 +69,496 @@ void SRTsolver::Streaming()
 
 void SRTsolver::Collision()
 {
+	const int size = fluid_->size().first * fluid_->size().second;
+
+	double * f[kQ];
+	const double * feq[kQ];
 	for (int q = 0; q < kQ; ++q)
-		fluid_->f_[q] += (fluid_->feq_[q] - fluid_->f_[q]) / tau_;
+	{
+		f[q] = fluid_->f_[q].Data();
+		feq[q] = fluid_->feq_[q].Data();
+	}
+
+#pragma omp parallel for schedule(runtime)
+	for (int id = 0; id < size; ++id)
+		for (int q = 0; q < kQ; ++q)
+			f[q][id] += (feq[q][id] - f[q][id]) / tau_;
 }
 
 void SRTsolver::Solve(int iter_numb)
 {
-	feqCalculate();
-	for (int q = 0; q < kQ; ++q)
-		fluid_->f_[q] = fluid_->feq_[q];
+	// After restart distribution function is already restored, only equilibrium field of separate sweeps is recalculated
+	if (start_iter_ > 0)
+	{
+		if (kernel_mode_ == KernelMode::SEPARATE_SWEEPS)
+			feqCalculate();
+	}
+	else if (kernel_mode_ == KernelMode::IN_PLACE || kernel_mode_ == KernelMode::SPARSE)
+		FillWithEquilibrium();
+	else
+	{
+		feqCalculate();
+		for (int q = 0; q < kQ; ++q)
+			fluid_->f_[q] = fluid_->feq_[q];
+	}
+
+	// Sparse kernel never touches solid nodes, so they should not keep initial populations
+	if (kernel_mode_ == KernelMode::SPARSE && start_iter_ == 0)
+	{
+		for (int y = 0; y < fluid_->size().first; ++y)
+			for (int x = 0; x < fluid_->size().second; ++x)
+				if (!medium_->is_fluid(y, x))
+					for (int q = 0; q < kQ; ++q)
+						fluid_->f_[q](y, x) = 0.0;
+	}
 
 	BCs BC(fluid_->f_);
+	// Links between bodies and fluid are listed once, medium is not changed during solution
+	BodyBCs body_BC(*medium_);
+
+	// Index of all written VTK files, ParaView opens them as one dataset
+	VtkSeries fluid_series("Data\\srt_lbm_data\\2d\\fluid_vtk\\fluid.pvd");
+
+	// Fields are written by writer thread: one staging buffer is written, while another one could be filled by solver.
+	// Output is destroyed first, so it finishes all jobs before buffers and series are destroyed
+	StagingBuffers<FluidSnapshot> snapshots(is_output_enabled_ ? 2 : 0, fluid_->size().first, fluid_->size().second);
+	AsyncOutput output;
+
+	// Sparse kernel updates only fluid nodes
+	const long long nodes_number = (kernel_mode_ == KernelMode::SPARSE) ? lattice_.GetFluidNodesNumber() :
+		static_cast<long long>(fluid_->size().first) * fluid_->size().second;
+	performance_.SetLattice("srt", nodes_number, BytesPerNodeUpdate());
 
-	for (int iter = 0; iter < iter_numb; ++iter) 
+	for (int iter = start_iter_; iter < iter_numb; ++iter) 
 	{
-		Collision();
-		BC.PrepareValuesForAllBC(BCType::BOUNCE_BACK, BCType::BOUNCE_BACK, BCType::VON_NEUMAN, BCType::VON_NEUMAN);
+		performance_.BeginIteration();
 
-		Streaming();
+		performance_.Measure(Phase::COLLISION, [&]()
+		{
+			if (kernel_mode_ == KernelMode::FUSED)
+				CollideAndStream();
+			else if (kernel_mode_ == KernelMode::IN_PLACE)
+				CollideInPlace();
+			else if (kernel_mode_ == KernelMode::SPARSE)
+				SparseCollideAndStream();
+			else
+				Collision();
+		});
 
-		BC.PrepareAdditionalBCs(*medium_);
+		performance_.Measure(Phase::BC_PREPARE, [&]()
+		{
+			BC.PrepareValuesForAllBC(BCType::BOUNCE_BACK, BCType::BOUNCE_BACK, BCType::VON_NEUMAN, BCType::VON_NEUMAN);
+		});
 
-		BC.BounceBackBC(Boundary::TOP);
-		BC.BounceBackBC(Boundary::BOTTOM);
-		BC.VonNeumannBC(Boundary::LEFT, *fluid_, 0.01, 0.0);
-		BC.VonNeumannBC(Boundary::RIGHT, *fluid_, 0.01, 0.0);
+		performance_.Measure(Phase::STREAMING, [&]()
+		{
+			if (kernel_mode_ == KernelMode::FUSED || kernel_mode_ == KernelMode::SPARSE)
+			{
+				// Streamed populations are already in the second buffer
+				fluid_->f_.swap(f_stream_);
+				fluid_->f_.fillBoundaries(0.0);
+			}
+			else if (kernel_mode_ == KernelMode::IN_PLACE)
+				StreamInPlace();
+			else
+				Streaming();
+		});
 
-		BC.AdditionalBounceBackBCs();
+		performance_.Measure(Phase::BC_RECORD, [&]()
+		{
+			body_BC.PrepareValues(fluid_->f_);
 
-		BC.RecordValuesForAllBC(BCType::BOUNCE_BACK, BCType::BOUNCE_BACK, BCType::VON_NEUMAN, BCType::VON_NEUMAN);
+			BC.BounceBackBC(Boundary::TOP);
+			BC.BounceBackBC(Boundary::BOTTOM);
+			BC.VonNeumannBC(Boundary::LEFT, 0.01, 0.0);
+			BC.VonNeumannBC(Boundary::RIGHT, 0.01, 0.0);
 
-		BC.RecordAdditionalBCs();
+			BC.RecordValuesForAllBC(BCType::BOUNCE_BACK, BCType::BOUNCE_BACK, BCType::VON_NEUMAN, BCType::VON_NEUMAN);
 
-		Recalculate();
+			body_BC.RecordValues(fluid_->f_);
+		});
 
-		feqCalculate();
+		const bool is_output_step = is_output_enabled_ && iter % 5 == 0;
+		const bool is_checkpoint_step = checkpoint_interval_ > 0 && (iter + 1) % checkpoint_interval_ == 0;
 
-		std::cout << iter << " Total rho = " << fluid_->rho_.GetSum() << std::endl;
+		if (kernel_mode_ == KernelMode::SEPARATE_SWEEPS)
+		{
+			performance_.Measure(Phase::RECALCULATE, [&]() { Recalculate(); });
+			performance_.Measure(Phase::FEQ, [&]() { feqCalculate(); });
+		}
+		// Fused, in-place and sparse kernels calculate macroscopic values from populations before collision, so their fields
+		// are one step behind f_. They are recalculated from f_ only when they are written
+		else if (is_output_step || is_checkpoint_step)
+			performance_.Measure(Phase::RECALCULATE, [&]() { Recalculate(); });
 
-		if (iter % 5 == 0)
+		if (is_checkpoint_step)
+			performance_.Measure(Phase::CHECKPOINT, [&]() { WriteCheckpoint(iter + 1); });
+
+		if (is_output_step)
 		{
-			fluid_->vx_.WriteFieldToTxt("Data\\srt_lbm_data\\2d\\fluid_txt", "vx", iter);
-			fluid_->write_fluid_vtk("Data\\srt_lbm_data\\2d\\fluid_vtk", iter);
+			performance_.Measure(Phase::OUTPUT, [&]()
+			{
+				std::cout << iter << " " << fluid_->GetDiagnostics() << '\n';
+
+				std::shared_ptr<FluidSnapshot> snapshot = snapshots.Acquire();
+				snapshot->CopyFrom(*fluid_);
+
+				output.Push([snapshot, iter, &fluid_series]()
+				{
+					snapshot->vx_.WriteFieldToTxt("Data\\srt_lbm_data\\2d\\fluid_txt", "vx", iter);
+					fluid_series.Add(iter, snapshot->write_fluid_vtk("Data\\srt_lbm_data\\2d\\fluid_vtk", iter));
+				});
+			});
 		}
 
+		performance_.EndIteration(iter + 1);
 	}
+
+	// Macroscopic fields correspond to the last step after solution in all kernel modes
+	if (kernel_mode_ != KernelMode::SEPARATE_SWEEPS)
+		Recalculate();
+
+	performance_.Finish(iter_numb);
 }
 
 void SRTsolver::Recalculate()
 {
-	fluid_->rho_ = fluid_->f_.calculateDensity();
-	fluid_->vx_ = fluid_->f_.calculateVelocity(kEx, fluid_->rho_);
-	fluid_->vy_ = fluid_->f_.calculateVelocity(kEy, fluid_->rho_);
+	const int size = fluid_->size().first * fluid_->size().second;
+
+	const double * f[kQ];
+	for (int q = 0; q < kQ; ++q)
+		f[q] = fluid_->f_[q].Data();
+
+	double * rho = fluid_->rho_.Data();
+	double * vx = fluid_->vx_.Data();
+	double * vy = fluid_->vy_.Data();
+
+#pragma omp parallel for schedule(runtime)
+	for (int id = 0; id < size; ++id)
+	{
+		double f_node[kQ];
+		for (int q = 0; q < kQ; ++q)
+			f_node[q] = f[q][id];
+
+		NodeMacroscopic(f_node, rho[id], vx[id], vy[id]);
+	}
+}
+
+void SRTsolver::SetOutput(bool const is_enabled)
+{
+	is_output_enabled_ = is_enabled;
+}
+
+void SRTsolver::SetPerformanceLog(std::string const & file_name, int const interval, PerformanceFormat const format)
+{
+	performance_.Enable(file_name, interval, format);
+}
+
+double SRTsolver::BytesPerNodeUpdate() const
+{
+	const double value = sizeof(double);
+
+	switch (kernel_mode_)
+	{
+	// Populations are read and written once, macroscopic values are written
+	case KernelMode::FUSED:
+		return (2 * kQ + 3) * value;
+	// The same as fused kernel plus neighbour index of each population
+	case KernelMode::SPARSE:
+		return (2 * kQ + 3) * value + kQ * sizeof(int);
+	// Collision reads and writes populations and writes macroscopic values, swap streaming reads and writes populations
+	case KernelMode::IN_PLACE:
+		return (4 * kQ + 3) * value;
+	// Collision (f, feq -> f), streaming (f -> f), recalculation (f -> rho, vx, vy) and feq calculation (rho, vx, vy -> feq)
+	default:
+		return (7 * kQ + 6) * value;
+	}
+}
+
+void SRTsolver::SetCheckpoint(std::string const & file_name, int const interval)
+{
+	checkpoint_file_ = file_name;
+	checkpoint_interval_ = (interval > 0) ? interval : 0;
+}
+
+bool SRTsolver::Restart(std::string const & file_name)
+{
+	CheckpointReader reader(file_name);
+	int iter = 0;
+
+	if (!reader.IsOk() || !reader.Read("solver.iteration", iter) || !medium_->LoadState(reader) || !fluid_->LoadState(reader))
+	{
+		std::cout << "Error! Could not restart from checkpoint " << file_name << ".\n";
+		return false;
+	}
+
+	start_iter_ = iter;
+
+	// Sparse lattice is built for the restored medium
+	if (kernel_mode_ == KernelMode::SPARSE)
+		lattice_.Build(*medium_);
+
+	return true;
+}
+
+void SRTsolver::WriteCheckpoint(int const iter) const
+{
+	CheckpointWriter writer(checkpoint_file_);
+
+	writer.Write("solver.iteration", iter);
+	medium_->SaveState(writer);
+	fluid_->SaveState(writer);
+
+	if (!writer.Close())
+		std::cout << "Error! Checkpoint at iteration " << iter << " was not written.\n";
+}
+
+void SRTsolver::SetKernelMode(KernelMode const mode)
+{
+	kernel_mode_ = mode;
+
+	// Second buffer is necessary only for fused and sparse kernels
+	if (kernel_mode_ == KernelMode::FUSED || kernel_mode_ == KernelMode::SPARSE)
+		f_stream_.resize(fluid_->size().first, fluid_->size().second);
+	else
+		f_stream_.resize(0, 0);
+
+	// Fluid nodes list and neighbour table are necessary only for sparse kernel
+	if (kernel_mode_ == KernelMode::SPARSE)
+		lattice_.Build(*medium_);
+	else
+		lattice_ = SparseLattice();
+
+	// In-place and sparse kernels do not use equilibrium field, so its memory is released
+	if (kernel_mode_ == KernelMode::IN_PLACE || kernel_mode_ == KernelMode::SPARSE)
+		fluid_->feq_.resize(0, 0);
+	else if (fluid_->feq_.size() != fluid_->size())
+		fluid_->feq_.resize(fluid_->size().first, fluid_->size().second);
+}
+
+void SRTsolver::CollideAndStream()
+{
+	const int rows = fluid_->size().first;
+	const int colls = fluid_->size().second;
+
+	// Raw pointers to avoid bounds checking in the node loop
+	double * f[kQ];
+	double * f_new[kQ];
+
+	for (int q = 0; q < kQ; ++q)
+	{
+		f[q] = fluid_->f_[q].Data();
+		f_new[q] = f_stream_[q].Data();
+	}
+
+	double * rho = fluid_->rho_.Data();
+	double * vx = fluid_->vx_.Data();
+	double * vy = fluid_->vy_.Data();
+
+	// Each slot of the second buffer is written by only one node, so rows could be processed in parallel
+#pragma omp parallel for schedule(runtime)
+	for (int y = 0; y < rows; ++y)
+	{
+		for (int x = 0; x < colls; ++x)
+		{
+			const int id = y * colls + x;
+
+			// Components, which do not come to the node from fluid neighbour, are equal to zero after streaming
+			for (int q = 0; q < kQ; ++q)
+			{
+				const int y_from = y + static_cast<int>(kEy[q]);
+				const int x_from = x - static_cast<int>(kEx[q]);
+
+				if (y_from < 0 || y_from >= rows || x_from < 0 || x_from >= colls || !medium_->is_fluid(y_from, x_from))
+					f_new[q][id] = 0.0;
+			}
+
+			// Load node populations once, calculate macroscopic values and relax populations
+			double f_node[kQ];
+			for (int q = 0; q < kQ; ++q)
+				f_node[q] = f[q][id];
+
+			CollideNode(f_node, rho[id], vx[id], vy[id]);
+
+			const bool is_fluid = medium_->is_fluid(y, x);
+			const bool near_boundary = (y == 1 || y == rows - 2 || x == 1 || x == colls - 2);
+
+			for (int q = 0; q < kQ; ++q)
+			{
+				// Only fluid nodes stream their populations to neighbours
+				if (is_fluid)
+					f_new[q][(y - static_cast<int>(kEy[q])) * colls + x + static_cast<int>(kEx[q])] = f_node[q];
+
+				// Post-collision values near boundaries are necessary for BC preparation before streaming
+				if (near_boundary)
+					f[q][id] = f_node[q];
+			}
+		}
+	}
+}
+
+void SRTsolver::CollideInPlace()
+{
+	const int rows = fluid_->size().first;
+	const int colls = fluid_->size().second;
+
+	double * f[kQ];
+	for (int q = 0; q < kQ; ++q)
+		f[q] = fluid_->f_[q].Data();
+
+	double * rho = fluid_->rho_.Data();
+	double * vx = fluid_->vx_.Data();
+	double * vy = fluid_->vy_.Data();
+
+	// Rows are processed in parallel, nodes of each row are processed by vectorized kernel
+#pragma omp parallel for schedule(runtime)
+	for (int y = 0; y < rows; ++y)
+		CollideSRT(f, rho, vx, vy, y * colls, (y + 1) * colls, tau_);
+}
+
+void SRTsolver::StreamInPlace()
+{
+	const int rows = fluid_->size().first;
+	const int colls = fluid_->size().second;
+
+	double * f[kQ];
+	for (int q = 0; q < kQ; ++q)
+		f[q] = fluid_->f_[q].Data();
+
+	// Streaming is performed for these directions, opposite directions are processed at the same time
+	const int kHalf[4]{ 1, 2, 5, 6 };
+
+	// Each node keeps population moving in 'q' direction in the opposite slot and vice versa
+#pragma omp parallel for schedule(runtime)
+	for (int id = 0; id < rows * colls; ++id)
+		for (int q : kHalf)
+			std::swap(f[q][id], f[kOpposite[q]][id]);
+
+	// Populations are exchanged across each link between the node and its neighbour in 'q' direction.
+	// Every slot is read and written only by one link, so the order of nodes is not important
+#pragma omp parallel for schedule(runtime)
+	for (int y = 0; y < rows; ++y)
+	{
+		for (int x = 0; x < colls; ++x)
+		{
+			const int id = y * colls + x;
+			const bool is_fluid = medium_->is_fluid(y, x);
+
+			// Only fluid nodes stream their populations (rest population does not move)
+			if (!is_fluid)
+				f[0][id] = 0.0;
+
+			for (int q : kHalf)
+			{
+				const int opp = kOpposite[q];
+
+				// Nothing comes to the node in 'q' direction from outside the modeling area
+				const int y_from = y + static_cast<int>(kEy[q]);
+				const int x_from = x - static_cast<int>(kEx[q]);
+
+				if (y_from < 0 || y_from >= rows || x_from < 0 || x_from >= colls)
+					f[q][id] = 0.0;
+
+				// Neighbour in 'q' direction, the same as in Streaming()
+				const int y_to = y - static_cast<int>(kEy[q]);
+				const int x_to = x + static_cast<int>(kEx[q]);
+
+				if (y_to < 0 || y_to >= rows || x_to < 0 || x_to >= colls)
+				{
+					f[opp][id] = 0.0;
+					continue;
+				}
+
+				const int id_to = y_to * colls + x_to;
+
+				const double out_node = f[opp][id];
+				const double out_neighbour = f[q][id_to];
+
+				f[q][id_to] = (is_fluid) ? out_node : 0.0;
+				f[opp][id] = (medium_->is_fluid(y_to, x_to)) ? out_neighbour : 0.0;
+			}
+		}
+	}
+
+	fluid_->f_.fillBoundaries(0.0);
+}
+
+void SRTsolver::FillWithEquilibrium()
+{
+	const int size = fluid_->size().first * fluid_->size().second;
+
+	const double * rho = fluid_->rho_.Data();
+	const double * vx = fluid_->vx_.Data();
+	const double * vy = fluid_->vy_.Data();
+
+	for (int q = 0; q < kQ; ++q)
+	{
+		double * f = fluid_->f_[q].Data();
+
+		for (int id = 0; id < size; ++id)
+			f[id] = Equilibrium(q, rho[id], vx[id], vy[id]);
+	}
+}
+
+void SRTsolver::SparseCollideAndStream()
+{
+	double * f[kQ];
+	double * f_new[kQ];
+
+	for (int q = 0; q < kQ; ++q)
+	{
+		f[q] = fluid_->f_[q].Data();
+		f_new[q] = f_stream_[q].Data();
+	}
+
+	double * rho = fluid_->rho_.Data();
+	double * vx = fluid_->vx_.Data();
+	double * vy = fluid_->vy_.Data();
+
+	const int fluid_nodes_numb = lattice_.GetFluidNodesNumber();
+	const int * nodes = lattice_.GetFluidNodes().data();
+	const int * neighbours = lattice_.GetNeighbours().data();
+
+	// Components of fluid nodes, which do not come from fluid neighbour, are equal to zero after streaming.
+	// Solid nodes are never collided and are cleared by BCs, so their components in both buffers are already zero
+	for (int q = 0; q < kQ; ++q)
+		for (int id : lattice_.GetEmptySlots(q))
+			f_new[q][id] = 0.0;
+
+	// Each slot of the second buffer is written by only one fluid node, so nodes could be processed in parallel
+#pragma omp parallel for schedule(runtime)
+	for (int i = 0; i < fluid_nodes_numb; ++i)
+	{
+		const int id = nodes[i];
+
+		double f_node[kQ];
+		for (int q = 0; q < kQ; ++q)
+			f_node[q] = f[q][id];
+
+		CollideNode(f_node, rho[id], vx[id], vy[id]);
+
+		for (int q = 0; q < kQ; ++q)
+			f_new[q][neighbours[i * kQ + q]] = f_node[q];
+	}
+
+	// Post-collision values near boundaries are necessary for BC preparation before streaming,
+	// each of them is taken from the only slot, where it was streamed to
+	for (int i : lattice_.GetBorderNodes())
+		for (int q = 0; q < kQ; ++q)
+			f[q][nodes[i]] = f_new[q][neighbours[i * kQ + q]];
+}
+
+void SRTsolver::CollideNode(double f_node[kQ], double & rho, double & vx, double & vy) const
+{
+	double cur_rho, cur_vx, cur_vy;
+	NodeMacroscopic(f_node, cur_rho, cur_vx, cur_vy);
+
+	rho = cur_rho;
+	vx = cur_vx;
+	vy = cur_vy;
+
+	for (int q = 0; q < kQ; ++q)
+		f_node[q] += (Equilibrium(q, cur_rho, cur_vx, cur_vy) - f_node[q]) / tau_;
 }
 
 void SRTsolver::CreateDataFolder(std::string folder_name) const
@@ -135,12 +589,15 @@ void SRTsolver::CreateDataFolder(std::string folder_name) const
 #pragma region 3d
 
 
-SRT3DSolver::SRT3DSolver(double tau, Medium3D & medium, Fluid3D & fluid) : tau_(tau), medium_(& medium), fluid_(& fluid)
+SRT3DSolver::SRT3DSolver(double tau, Medium3D & medium, Fluid3D & fluid) : tau_(tau), medium_(& medium), fluid_(& fluid), lattice_(medium),
+	checkpoint_interval_(0), start_iter_(0)
 {
 	assert(medium_->GetDepthNumber() == fluid_->GetDepthNumber());
 	assert(medium_->GetRowsNumber() == fluid_->GetRowsNumber());
 	assert(medium_->GetColumnsNumber() == fluid_->GetColumnsNumber());
 
+	f_stream_ = std::make_unique<DistributionFunction3D<double>>(fluid_->GetDepthNumber(), fluid_->GetRowsNumber(), fluid_->GetColumnsNumber());
+
 	CreateDataFolder("Data");
 	CreateDataFolder("Data\\srt_lbm_data");
 	CreateDataFolder("Data\\srt_lbm_data\\3d");
@@ -150,103 +607,163 @@ SRT3DSolver::SRT3DSolver(double tau, Medium3D & medium, Fluid3D & fluid) : tau_(
 
 void SRT3DSolver::feqCalculate()
 {
-	int depth = medium_->GetDepthNumber();
-	int rows = medium_->GetRowsNumber();
-	int colls = medium_->GetColumnsNumber();
-	
-	// Obtain weights for feq calculation in accordance with Dmitry Biculov article
-	std::vector<double> w;
-	FillWeightsFor3D(w);
-
-	for (int q = 0; q < kQ3d; ++q) 
-	{
-		// Article : Dmitry Biculov (e_{i}, v) form eq. (3) 
-		Matrix3D<double> v(depth, rows, colls);
-		v = *fluid_->vx_ * (double) ex[q] + *fluid_->vy_ * (double) ey[q] + *fluid_->vz_ * (double) ez[q];
-		// Article : Dmitry Biculov (e_{i}, v)^{2} form eq. (3) 
-		Matrix3D<double> v_sq(depth, rows, colls);
-		v_sq = v.ScalarMultiplication(v);
-		// Article : Dmitry Biculov (v, v)^{2} form eq. (3) 
-		// !!! Copy becauce constant values : deal with it !!!
-		Matrix3D<double> v_x = *fluid_->vx_;
-		Matrix3D<double> v_y = *fluid_->vy_;
-		Matrix3D<double> v_z = *fluid_->vz_;
-
-		Matrix3D<double> v_2(depth, rows, colls);
-		v_2 = v_x.ScalarMultiplication(v_x) + v_y.ScalarMultiplication(v_y) + v_z.ScalarMultiplication(v_z);
-
-
-		fluid_->feq_->operator[](q) = w[q] * fluid_->rho_->ScalarMultiplication(1.0 + 3.0 * v + 4.5 * v_sq - 1.5 * v_2);
-	}
-
+	const int size = medium_->GetDepthNumber() * medium_->GetRowsNumber() * medium_->GetColumnsNumber();
+
+	// Time step does not use equilibrium field, so it is allocated only when it is calculated for the first time
+	if (!fluid_->feq_)
+		fluid_->feq_ = std::make_unique<DistributionFunction3D<double>>(medium_->GetDepthNumber(), medium_->GetRowsNumber(), medium_->GetColumnsNumber());
+
+	// Raw pointers to avoid bounds checking in the node loop
+	double * feq[Lattice::kQ];
+	for (int q = 0; q < Lattice::kQ; ++q)
+		feq[q] = (*fluid_->feq_)[q].Data();
+
+	const double * rho = fluid_->rho_->Data();
+	const double * vx = fluid_->vx_->Data();
+	const double * vy = fluid_->vy_->Data();
+	const double * vz = fluid_->vz_->Data();
+
+	// Equilibrium is evaluated node by node (Dmitry Biculov article, eq. (3)), so no whole-domain temporaries are created
+#pragma omp parallel for schedule(runtime)
+	for (int id = 0; id < size; ++id)
+		for (int q = 0; q < Lattice::kQ; ++q)
+			feq[q][id] = Equilibrium<Lattice>(q, rho[id], vx[id], vy[id], vz[id]);
 }
 
 void SRT3DSolver::Streaming()
 {
 	const int depth = medium_->GetDepthNumber();
-	const int rows = medium_->GetRowsNumber();
-	const int colls = medium_->GetColumnsNumber();
+	const int size = depth * medium_->GetRowsNumber() * medium_->GetColumnsNumber();
 
-	SubStreamingMiddle(depth, rows, colls);
-	SubStreamingTop(depth, rows, colls);
-	SubStreamingBottom(depth, rows, colls);
+	const int fluid_nodes_numb = lattice_.GetFluidNodesNumber();
+	const int * nodes = lattice_.GetFluidNodes().data();
+	const int * neighbours = lattice_.GetNeighbours().data();
+
+	for (int q = 0; q < Lattice::kQ; ++q)
+	{
+		Matrix3D<double> & f_q = (*fluid_->f_)[q];
+		const int dz = static_cast<int>(Lattice::kEz[q]);
+
+		// Old values are copied, because populations are streamed in the same matrix
+		const std::vector<double> temp(f_q.Data(), f_q.Data() + size);
+
+		// Layers, which get populations from the modeling area in 'q' direction, are cleared (outer layer keeps its values)
+		for (int z = 0; z < depth; ++z)
+			if (z - dz >= 0 && z - dz < depth)
+				f_q.FillLayer(z, 0.0);
+
+		double * to = f_q.Data();
+
+		// Only fluid nodes stream their populations, each destination node is written by only one fluid node
+	#pragma omp parallel for schedule(runtime)
+		for (int i = 0; i < fluid_nodes_numb; ++i)
+			to[neighbours[i * Lattice::kQ + q]] = temp[nodes[i]];
+	}
 }
 
 void SRT3DSolver::Collision()
 {
-	for (int q = 0; q < kQ3d; ++q)
+	// Equilibrium field exists only after feqCalculate()
+	assert(fluid_->feq_);
+
+	for (int q = 0; q < Lattice::kQ; ++q)
 		(*fluid_->f_)[q] += ((*fluid_->feq_)[q] - (*fluid_->f_)[q]) / tau_;
 }
 
 void SRT3DSolver::Solve(int iter_numb)
 {
-	fluid_->PoiseuilleIC(0.01);
+	// After restart distribution function (post-collision populations) is already restored
+	if (start_iter_ == 0)
+	{
+		fluid_->PoiseuilleIC(0.01);
+		FillWithEquilibrium();
+	}
 
-	feqCalculate();
-	for (int q = 0; q < kQ; ++q)
-		(*fluid_->f_)[q] = (*fluid_->feq_)[q];
+	// Index of all written VTK files, ParaView opens them as one dataset
+	VtkSeries fluid_series("Data\\srt_lbm_data\\3d\\fluid_vtk\\fluid.pvd");
 
-	BCs3D bc(fluid_->GetRowsNumber(), fluid_->GetColumnsNumber(), *fluid_->f_);
+	// Populations are read and written once, macroscopic values are written, plus source index of each population
+	performance_.SetLattice("srt3d", lattice_.GetFluidNodesNumber(), (2 * Lattice::kQ + 4) * sizeof(double) + Lattice::kQ * sizeof(int));
 
-	for (int iter = 0; iter < iter_numb; ++iter)
+	for (int iter = start_iter_; iter < iter_numb; ++iter)
 	{
-		std::cout << iter << " : ";
-		Collision();
-		bc.PrepareValuesForAllBC(BCType::BOUNCE_BACK, BCType::BOUNCE_BACK, BCType::BOUNCE_BACK, BCType::BOUNCE_BACK, BCType::BOUNCE_BACK, BCType::BOUNCE_BACK);
-		
-		Streaming();
+		performance_.BeginIteration();
 
-		bc.BounceBackBC(Boundary::TOP);
-		bc.BounceBackBC(Boundary::BOTTOM);
-		bc.BounceBackBC(Boundary::LEFT);
-		bc.BounceBackBC(Boundary::RIGHT);
-		bc.BounceBackBC(Boundary::CLOSE_IN);
-		bc.BounceBackBC(Boundary::FAAR);
+		performance_.Measure(Phase::COLLISION, [&]()
+		{
+			CollideAndStream(0.01);
 
-		bc.RecordValuesForAllBC(BCType::BOUNCE_BACK, BCType::BOUNCE_BACK, BCType::BOUNCE_BACK, BCType::BOUNCE_BACK, BCType::BOUNCE_BACK, BCType::BOUNCE_BACK);
+			// Populations of the next time step are in the second buffer
+			fluid_->f_.swap(f_stream_);
+		});
 
-		Recalculate();
-		fluid_->vz_->SetTBLayer(1, std::vector<double>(fluid_->GetColumnsNumber() * fluid_->GetRowsNumber(), 0.01));
-
-		feqCalculate();
+		if (checkpoint_interval_ > 0 && (iter + 1) % checkpoint_interval_ == 0)
+			performance_.Measure(Phase::CHECKPOINT, [&]() { WriteCheckpoint(iter + 1); });
 
 		if (iter % 10 == 0)
-			GetProfile(15, iter);
+		{
+			performance_.Measure(Phase::OUTPUT, [&]()
+			{
+				std::cout << iter << " " << fluid_->GetDiagnostics() << '\n';
+
+				GetProfile(15, iter);
+				fluid_series.Add(iter, fluid_->WriteFluidVtk("Data\\srt_lbm_data\\3d\\fluid_vtk", iter));
+			});
+		}
+
+		performance_.EndIteration(iter + 1);
 	}
-	
+
+	performance_.Finish(iter_numb);
 }
 
-void SRT3DSolver::GetProfile(const int chan_numb, const int iter_numb)
+void SRT3DSolver::SetPerformanceLog(std::string const & file_name, int const interval, PerformanceFormat const format)
 {
-	std::vector<double> res = fluid_->vy_->GetNFLayer(chan_numb);
-	int colls = fluid_->GetColumnsNumber();
-	int rows = fluid_->GetRowsNumber();
-	int depth = fluid_->GetDepthNumber();
+	performance_.Enable(file_name, interval, format);
+}
 
-	
+void SRT3DSolver::SetCheckpoint(std::string const & file_name, int const interval)
+{
+	checkpoint_file_ = file_name;
+	checkpoint_interval_ = (interval > 0) ? interval : 0;
+}
+
+bool SRT3DSolver::Restart(std::string const & file_name)
+{
+	CheckpointReader reader(file_name);
+	int iter = 0;
+
+	if (!reader.IsOk() || !reader.Read("solver.iteration", iter) || !medium_->LoadState(reader) || !fluid_->LoadState(reader))
+	{
+		std::cout << "Error! Could not restart from checkpoint " << file_name << ".\n";
+		return false;
+	}
+
+	start_iter_ = iter;
+	lattice_.Build(*medium_);
+
+	return true;
+}
+
+void SRT3DSolver::WriteCheckpoint(int const iter) const
+{
+	CheckpointWriter writer(checkpoint_file_);
+
+	writer.Write("solver.iteration", iter);
+	medium_->SaveState(writer);
+	fluid_->SaveState(writer);
+
+	if (!writer.Close())
+		std::cout << "Error! Checkpoint at iteration " << iter << " was not written.\n";
+}
+
+void SRT3DSolver::GetProfile(const int chan_numb, const int iter_numb)
+{
+	// Layer is written in place, without copy
+	const Matrix3D<double> & vy = *fluid_->vy_;
 
 	std::string name = "Data/ex" + std::to_string(iter_numb) + ".txt";
-	if (WriteHeatMapInFile(name, res, colls - 2))
+	if (WriteHeatMapInFile(name, vy.GetNFLayerView(chan_numb)))
 	{
 		std::cout << "Data writing complete successfully!\n";
 	}
@@ -254,7 +771,7 @@ void SRT3DSolver::GetProfile(const int chan_numb, const int iter_numb)
 	
 }
 
-bool SRT3DSolver::WriteHeatMapInFile(const std::string & file_name, const std::vector<double>& data, const int lenght)
+bool SRT3DSolver::WriteHeatMapInFile(const std::string & file_name, SliceView<double const> const & data)
 {
 	std::ofstream file;
 	file.open(file_name);
@@ -262,20 +779,15 @@ bool SRT3DSolver::WriteHeatMapInFile(const std::string & file_name, const std::v
 	{
 		file.precision(3);
 
-		for (int i = 0; i < data.size(); ++i)
+		for (int i = 0; i < data.GetRowsNumber(); ++i)
 		{
-			// If this is laset element in the row
-			if (i != 0 && ((i + 1) % lenght == 0))
-			{
-				// If it is not last element in list we need to and endl
-				if (i != data.size() - 1)
-					file << data.at(i) << std::endl;
-				// If it is las element in list we need no endl
-				else
-					file << data.at(i);
-			}
-			else
-				file << data.at(i) << " ";
+			// Elements of the row are separated by spaces, rows by endl (no endl after the last row)
+			for (int j = 0; j < data.GetCollsNumber() - 1; ++j)
+				file << data(i, j) << " ";
+
+			file << data(i, data.GetCollsNumber() - 1);
+			if (i != data.GetRowsNumber() - 1)
+				file << std::endl;
 		}
 
 		file.close();
@@ -290,81 +802,101 @@ bool SRT3DSolver::WriteHeatMapInFile(const std::string & file_name, const std::v
 	
 }
 
-void SRT3DSolver::SubStreamingMiddle(const int depth, const int rows, const int colls)
+void SRT3DSolver::CreateDataFolder(std::string folder_name) const
 {
-	for (int z = 0; z < depth; ++z)
-	{
-		for (int q = 0; q < 9; ++q)
-		{
-			Matrix2D<double> temp = fluid_->GetDistributionFuncLayer(z, q);
-			fluid_->SetDistributionFuncLayerValue(z, q, 0.0);
+	// Get path to current directory
+	char buffer[MAX_PATH];
+	GetModuleFileName(NULL, buffer, MAX_PATH);
 
-			for (unsigned y = 0; y < rows; ++y)
-				for (unsigned x = 0; x < colls; ++x)
-					if (medium_->IsFluid(z, y, x))
-						fluid_->f_->operator[](q)(z + ez[q], y + ey[q], x + ex[q]) = temp(y, x);
-		}
-	}
+	std::string::size_type pos = std::string(buffer).find_last_of("\\/");
+	std::string path = std::string(buffer).substr(0, pos);
+	path = path.substr(0, path.size() - 6) + "\\" + folder_name;
+
+	char *cstr = new char[path.length() + 1];
+	strcpy(cstr, path.c_str());
+
+	// Create folder if not exist yet
+	if (GetFileAttributes(cstr) == INVALID_FILE_ATTRIBUTES)
+		CreateDirectory(cstr, NULL);
 }
 
-void SRT3DSolver::SubStreamingTop(const int depth, const int rows, const int colls)
+void SRT3DSolver::CollideAndStream(double const inlet_vz)
 {
-	for (int z = 0; z < depth - 1; ++z)
-	{
-		for (int q = 9; q < 14; ++q)
-		{
-			Matrix2D<double> temp = fluid_->GetDistributionFuncLayer(z, q);
-			fluid_->SetDistributionFuncLayerValue(z, q, 0.0);
+	// Raw pointers to avoid bounds checking in the node loop
+	double * f[Lattice::kQ];
+	double * f_new[Lattice::kQ];
 
-			for (unsigned y = 0; y < rows; ++y)
-				for (unsigned x = 0; x < colls; ++x)
-					if (medium_->IsFluid(z, y, x))
-						fluid_->f_->operator[](q)(z + ez[q], y + ey[q], x + ex[q]) = temp(y, x);
-		}
+	for (int q = 0; q < Lattice::kQ; ++q)
+	{
+		f[q] = (*fluid_->f_)[q].Data();
+		f_new[q] = (*f_stream_)[q].Data();
 	}
-}
 
-void SRT3DSolver::SubStreamingBottom(const int depth, const int rows, const int colls)
-{
-	for (int z = depth - 1; z > 0; --z)
+	double * rho = fluid_->rho_->Data();
+	double * vx = fluid_->vx_->Data();
+	double * vy = fluid_->vy_->Data();
+	double * vz = fluid_->vz_->Data();
+
+	const int depth = medium_->GetDepthNumber();
+	const int * nodes = lattice_.GetFluidNodes().data();
+	const int * sources = lattice_.GetSources().data();
+	const int * layer_offsets = lattice_.GetLayerOffsets().data();
+
+	// Each node gathers its own components and writes only its own slots, so layers could be processed in parallel
+#pragma omp parallel for schedule(runtime)
+	for (int z = 0; z < depth; ++z)
 	{
-		for (int q = 14; q < 19; ++q)
+		for (int i = layer_offsets[z]; i < layer_offsets[z + 1]; ++i)
 		{
-			Matrix2D<double> temp = fluid_->GetDistributionFuncLayer(z, q);
-			fluid_->SetDistributionFuncLayerValue(z, q, 0.0);
+			const int id = nodes[i];
+			const int * node_sources = sources + i * Lattice::kQ;
 
-			for (unsigned y = 0; y < rows; ++y)
-				for (unsigned x = 0; x < colls; ++x)
-					if (medium_->IsFluid(z, y, x))
-						fluid_->f_->operator[](q)(z + ez[q], y + ey[q], x + ex[q]) = temp(y, x);
+			// Streaming: component comes from the upstream fluid node or is bounced back from the wall
+			double f_node[Lattice::kQ];
+			for (int q = 0; q < Lattice::kQ; ++q)
+				f_node[q] = (node_sources[q] >= 0) ? f[q][node_sources[q]] : f[Lattice::kOpposite[q]][id];
+
+			double cur_rho, cur_vx, cur_vy, cur_vz;
+			NodeMacroscopic<Lattice>(f_node, cur_rho, cur_vx, cur_vy, cur_vz);
+
+			// Inlet velocity is set in the first fluid layer
+			if (z == 1)
+				cur_vz = inlet_vz;
+
+			rho[id] = cur_rho;
+			vx[id] = cur_vx;
+			vy[id] = cur_vy;
+			vz[id] = cur_vz;
+
+			for (int q = 0; q < Lattice::kQ; ++q)
+				f_new[q][id] = f_node[q] + (Equilibrium<Lattice>(q, cur_rho, cur_vx, cur_vy, cur_vz) - f_node[q]) / tau_;
 		}
 	}
 }
 
-void SRT3DSolver::CreateDataFolder(std::string folder_name) const
+void SRT3DSolver::FillWithEquilibrium()
 {
-	// Get path to current directory
-	char buffer[MAX_PATH];
-	GetModuleFileName(NULL, buffer, MAX_PATH);
+	const int size = medium_->GetDepthNumber() * medium_->GetRowsNumber() * medium_->GetColumnsNumber();
 
-	std::string::size_type pos = std::string(buffer).find_last_of("\\/");
-	std::string path = std::string(buffer).substr(0, pos);
-	path = path.substr(0, path.size() - 6) + "\\" + folder_name;
+	double * f[Lattice::kQ];
+	for (int q = 0; q < Lattice::kQ; ++q)
+		f[q] = (*fluid_->f_)[q].Data();
 
-	char *cstr = new char[path.length() + 1];
-	strcpy(cstr, path.c_str());
+	const double * rho = fluid_->rho_->Data();
+	const double * vx = fluid_->vx_->Data();
+	const double * vy = fluid_->vy_->Data();
+	const double * vz = fluid_->vz_->Data();
 
-	// Create folder if not exist yet
-	if (GetFileAttributes(cstr) == INVALID_FILE_ATTRIBUTES)
-		CreateDirectory(cstr, NULL);
+#pragma omp parallel for schedule(runtime)
+	for (int id = 0; id < size; ++id)
+		for (int q = 0; q < Lattice::kQ; ++q)
+			f[q][id] = Equilibrium<Lattice>(q, rho[id], vx[id], vy[id], vz[id]);
 }
 
 void SRT3DSolver::Recalculate()
 {
 	fluid_->RecalculateRho();
 	fluid_->RecalculateV();
-
-	std::cout << "Total rho: " << fluid_->TotalRho() << std::endl;
 }
 
 #pragma endregion
@@ -7,12 +7,27 @@
 #include <sstream> // string streams
 
 #include"solver.h"
+#include"parallel.h"
+#include"performance.h"
 #include"..\modeling_area\fluid.h"
 #include"..\modeling_area\medium.h"
+#include"..\modeling_area\sparse_lattice.h"
 #include"bc\bc.h"
+#include"kernels\collision_kernels.h"
+#include"..\output\async_output.h"
+#include"..\output\checkpoint.h"
 
 #pragma region 2d
 
+//! Type of time step implementation in solver
+enum class KernelMode
+{
+	SEPARATE_SWEEPS,	// collision, streaming, recalculation and feq calculation as separate full-grid sweeps
+	FUSED,				// single-pass collide-and-stream kernel with second distribution function buffer
+	IN_PLACE,			// in-place collision and swap streaming in the single distribution function buffer, without feq field
+	SPARSE,				// fused collide-and-stream kernel only over fluid nodes with indirect addressing (sparse lattice)
+};
+
 
 // SRT approach implementation.
 //
@@ -21,7 +36,7 @@
 class SRTsolver : iSolver
 {
 public:
-	SRTsolver() : tau_(0.0) {}
+	SRTsolver() : tau_(0.0), kernel_mode_(KernelMode::SEPARATE_SWEEPS), is_output_enabled_(true), checkpoint_interval_(0), start_iter_(0) {}
 	SRTsolver(double const tau, Medium & medium, Fluid & fluid);
 	virtual ~SRTsolver() {}
 
@@ -32,8 +47,45 @@ public:
 	virtual void Solve(int iteration_number) override;
 	virtual void Recalculate() override;
 
+	//! Chooses time step implementation: separate sweeps (by default), fused collide-and-stream kernel, in-place kernel or sparse kernel
+	void SetKernelMode(KernelMode const mode);
+
+	//! Enables or disables console and file output during solution (enabled by default)
+	void SetOutput(bool const is_enabled);
+
+	//! Enables writing of checkpoint 'file_name' every 'interval' iterations (disabled if 'interval' <= 0)
+	void SetCheckpoint(std::string const & file_name, int const interval);
+	//! Restores medium and fluid from checkpoint 'file_name', next Solve() continues from the saved iteration
+	//! up to the same total number of iterations. Returns false if checkpoint could not be read
+	bool Restart(std::string const & file_name);
+
+	//! Enables reports of performance (MLUPS, memory bandwidth and time of time step phases) every 'interval' iterations to 'file_name'
+	void SetPerformanceLog(std::string const & file_name, int const interval, PerformanceFormat const format = PerformanceFormat::JSON);
+
 protected:
 
+	//! Returns minimum number of bytes, which time step implementation reads and writes per node update
+	double BytesPerNodeUpdate() const;
+
+	//! Writes medium, fluid and number of performed iterations 'iter' to checkpoint
+	void WriteCheckpoint(int const iter) const;
+
+	//! Performs recalculation, feq calculation, collision and streaming in one pass over the grid
+	void CollideAndStream();
+
+	//! Performs recalculation, feq calculation and collision in one pass over the grid, result is written back to f_
+	void CollideInPlace();
+	//! Performs streaming without temporary buffers by swapping populations of opposite directions
+	void StreamInPlace();
+	//! Fills f_ with equilibrium values, calculated from current macroscopic values (without feq field)
+	void FillWithEquilibrium();
+
+	//! Performs the same as CollideAndStream(), but only for fluid nodes listed in sparse lattice
+	void SparseCollideAndStream();
+
+	//! Calculates macroscopic values of the node from its populations 'f_node' and relaxes populations to equilibrium
+	void CollideNode(double f_node[kQ], double & rho, double & vx, double & vy) const;
+
 	//! Creates folder for output data if not existed yet
 	void CreateDataFolder(std::string folder_name) const;
 
@@ -43,6 +95,26 @@ protected:
 
 	Medium* medium_;
 	Fluid* fluid_;
+
+	//! Time step implementation
+	KernelMode kernel_mode_;
+	//! Second distribution function buffer, populations are streamed in it by fused and sparse kernels
+	DistributionFunction<double> f_stream_;
+	//! Fluid nodes list and neighbour table for sparse kernel
+	SparseLattice lattice_;
+
+	//! Is console and file output performed during solution
+	bool is_output_enabled_;
+
+	//! Name of checkpoint file
+	std::string checkpoint_file_;
+	//! Number of iterations between checkpoints (checkpoints are not written if it is 0)
+	int checkpoint_interval_;
+	//! Iteration, from which solution starts (not 0 after restart)
+	int start_iter_;
+
+	//! Time of time step phases and performance reports
+	PerformanceMonitor performance_;
 };
 
 
@@ -57,35 +129,51 @@ protected:
 //
 // Relaxation parameter tau must be bigger then 0.5 to achive good results.
 // It is better to choose it near 1.0;
+//
+// Time step is performed by single pull-style kernel over fluid nodes of sparse lattice (streaming with bounce back,
+// recalculation, feq calculation and collision), so between time steps f_ keeps post-collision populations.
 class SRT3DSolver : iSolver
 {
 public:
+	//! Velocity model, which constants are used by kernels of solver
+	typedef D3Q19 Lattice;
 
 	SRT3DSolver(double tau, Medium3D & medium, Fluid3D & fluid);
 	virtual ~SRT3DSolver() {}
 
 	void feqCalculate() override;
+	//! Separate streaming and collision sweeps are kept only for iSolver interface, Solve() uses CollideAndStream()
 	void Streaming() override;
 	void Collision() override;
 	void Recalculate() override;
 	void Solve(int iteration_number) override;
 
+	//! Performs streaming (components from non-fluid nodes are bounced back), recalculation, feq calculation and collision
+	//! in one pass over fluid nodes, result is written to the second buffer. Velocity along z-axis of the first fluid layer is 'inlet_vz'
+	void CollideAndStream(double const inlet_vz);
+
+	//! Enables writing of checkpoint 'file_name' every 'interval' iterations (disabled if 'interval' <= 0)
+	void SetCheckpoint(std::string const & file_name, int const interval);
+	//! Restores medium and fluid from checkpoint 'file_name', next Solve() continues from the saved iteration
+	//! up to the same total number of iterations. Returns false if checkpoint could not be read
+	bool Restart(std::string const & file_name);
+
+	//! Enables reports of performance (MLUPS, memory bandwidth and time of time step phases) every 'interval' iterations to 'file_name'
+	void SetPerformanceLog(std::string const & file_name, int const interval, PerformanceFormat const format = PerformanceFormat::JSON);
 
 	void GetProfile(const int chan_numb, const int iter_numb);
-	//! Implements correct hetmap writing in file ('length' is a number of elements in one line)
-	bool WriteHeatMapInFile(const std::string & file_name, const std::vector<double> & data, const int lenght);
+	//! Implements correct hetmap writing in file (one line per row of 'data')
+	bool WriteHeatMapInFile(const std::string & file_name, SliceView<double const> const & data);
 
 
 private:
-	//! Implementation of streaming for 0-8 velocity directions
-	void SubStreamingMiddle(const int depth, const int rows, const int colls);
-	//! Implementation of streaming for 9-13 velocity directions
-	void SubStreamingTop(const int depth, const int rows, const int colls);
-	//! Implementation of streaming for 14-18 velocity directions
-	void SubStreamingBottom(const int depth, const int rows, const int colls);
+	//! Fills f_ with equilibrium values, calculated from current macroscopic values (without feq field)
+	void FillWithEquilibrium();
 
 	//! Creates folder for output data if not existed yet
 	void CreateDataFolder(std::string folder_name) const;
+	//! Writes medium, fluid and number of performed iterations 'iter' to checkpoint
+	void WriteCheckpoint(int const iter) const;
 
 private:
 	//! Relaxation parameter
@@ -96,6 +184,21 @@ private:
 	Medium3D* medium_;
 	//! Fluid domain of simulation
 	Fluid3D* fluid_;
+
+	//! Fluid nodes list, neighbour and source tables
+	SparseLattice3D lattice_;
+	//! Second distribution function buffer, fused kernel writes populations of the next time step in it
+	std::unique_ptr<DistributionFunction3D<double>> f_stream_;
+
+	//! Name of checkpoint file
+	std::string checkpoint_file_;
+	//! Number of iterations between checkpoints (checkpoints are not written if it is 0)
+	int checkpoint_interval_;
+	//! Iteration, from which solution starts (not 0 after restart)
+	int start_iter_;
+
+	//! Time of time step phases and performance reports
+	PerformanceMonitor performance_;
 };
 
 